@@ -1,13 +1,159 @@
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
 #include <queue>
+#include <thread>
 #include "Algorithms.hpp"
 #include "Graph.hpp"
+#include "Parallel.hpp"
 #include <unordered_map>
 #include <stack>
-
-#define INT_MAX 99999
+#include <limits>
+#include <utility>
+#include <stdexcept>
+#include <type_traits>
 
 namespace ariel
 {
+    namespace
+    {
+        // Side of the square tiles used by the blocked Floyd-Warshall, 64x64 distances fit comfortably in L2.
+        const size_t FW_TILE = 64;
+
+        /**
+         * @brief The type the blocked Floyd-Warshall computes in for weights of type T.
+         * @details Integer weights narrower than 64 bits are widened to long long, where no path of fewer than
+         * 2^30 edges can come near the "no path" sentinel, so every distance is exact.
+         */
+        template <typename T>
+        struct TileDistance
+        {
+            typedef typename conditional<(numeric_limits<T>::is_integer && sizeof(T) < sizeof(long long)), long long, T>::type type;
+        };
+
+        // Distance used for "no path" inside the kernel. Half of the range so that a finite
+        // distance plus the sentinel never wraps around. Finite distances are kept inside (-inf, inf), see
+        // allPairsShortestPaths.
+        template <typename D>
+        D fwInfinity()
+        {
+            return numeric_limits<D>::max() / 2;
+        }
+
+        /**
+         * @brief The type path lengths are accumulated in by the sparse shortest path algorithms.
+         */
+        template <typename T>
+        struct PathLength
+        {
+            typedef typename ArithmeticTraits<T>::Wide type;
+        };
+
+        /**
+         * @brief Converts a path length back to the weight type.
+         * @param fits Cleared if the length is not representable, or collides with the "no path" marker.
+         */
+        template <typename T, typename D>
+        T toWeight(D length, bool &fits)
+        {
+            if (length < static_cast<D>(numeric_limits<T>::lowest()) || length >= static_cast<D>(numeric_limits<T>::max()))
+            {
+                fits = false;
+                return numeric_limits<T>::max();
+            }
+            return static_cast<T>(length);
+        }
+
+        /**
+         * @brief Relaxes the tile c through the pivots of the tiles a (rows) and b (columns).
+         * @param c The tile being updated.
+         * @param a The tile holding dist[i][k] for the rows of c.
+         * @param b The tile holding dist[k][j] for the columns of c.
+         * @param stride The row length of the whole padded matrix.
+         * @details The tiles may alias each other (phase one and two of the blocked algorithm), which is
+         * why the pivot loop is the outermost one. The inner loop is branch-free so it vectorizes.
+         */
+        template <typename D>
+        void relaxTile(D *c, const D *a, const D *b, size_t stride)
+        {
+            const D inf = fwInfinity<D>();
+            for (size_t k = 0; k < FW_TILE; ++k)
+            {
+                const D *bk = b + k * stride;
+                for (size_t i = 0; i < FW_TILE; ++i)
+                {
+                    D aik = a[i * stride + k];
+                    if (aik >= inf)
+                    {
+                        continue;
+                    }
+                    D *ci = c + i * stride;
+                    for (size_t j = 0; j < FW_TILE; ++j)
+                    {
+                        D through = bk[j] >= inf ? inf : static_cast<D>(aik + bk[j]);
+                        through = through < -inf ? -inf : through; // only reachable through a negative cycle
+                        ci[j] = through < ci[j] ? through : ci[j];
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief Single source Dijkstra over non-negative reduced weights, used by Johnson's algorithm.
+         * @param g The graph.
+         * @param reduced The reweighted, non-negative weight of every edge of g.
+         * @param potential The Bellman-Ford potentials used to undo the reweighting.
+         * @param source The source vertex.
+         * @param row Receives the true distances from source, numeric_limits<T>::max() for unreachable vertices.
+         * @return False if a distance does not fit the weight type.
+         */
+        template <typename T, typename D>
+        bool reducedDijkstra(const BasicCSRGraph<T> &g, const vector<D> &reduced, const vector<D> &potential,
+                             size_t source, vector<T> &row)
+        {
+            const D unreached = numeric_limits<D>::max();
+            const vector<size_t> &offsets = g.getOffsets();
+            const vector<size_t> &targets = g.getTargets();
+            size_t numVertices = g.getNumVertices();
+
+            vector<D> dist(numVertices, unreached);
+            priority_queue<pair<D, size_t>, vector<pair<D, size_t>>, greater<pair<D, size_t>>> heap;
+            dist[source] = D(0);
+            heap.push(make_pair(D(0), source));
+            while (!heap.empty())
+            {
+                pair<D, size_t> top = heap.top();
+                heap.pop();
+                size_t u = top.second;
+                if (top.first != dist[u])
+                {
+                    continue; // Stale heap entry
+                }
+                for (size_t e = offsets[u]; e < offsets[u + 1]; ++e)
+                {
+                    D candidate = top.first + reduced[e];
+                    if (candidate < dist[targets[e]])
+                    {
+                        dist[targets[e]] = candidate;
+                        heap.push(make_pair(candidate, targets[e]));
+                    }
+                }
+            }
+
+            bool fits = true;
+            row.resize(numVertices);
+            for (size_t v = 0; v < numVertices; ++v)
+            {
+                row[v] = dist[v] == unreached ? numeric_limits<T>::max() : toWeight<T>(dist[v] - potential[source] + potential[v], fits);
+            }
+            return fits;
+        }
+    }
 
     Algorithms::Algorithms() {} // Empty constructor
 
@@ -19,10 +165,10 @@ namespace ariel
      * @return A boolean indicating whether the graph is connected.
      * @details This function performs a breadth-first search (BFS) traversal starting from the first vertex to determine if all vertices in the graph are reachable.
      */
-    bool Algorithms::isConnected(Graph g)
+    template <typename T>
+    bool Algorithms::isConnected(BasicGraph<T> g)
     {
-        const vector<vector<int>> &adjMatrix = g.getAdjacencyMatrix();
-        size_t numVertices = adjMatrix.size();
+        size_t numVertices = g.getNumVertices();
 
         // Initialize visited array to track visited vertices
         vector<bool> visited(static_cast<size_t>(numVertices), false);
@@ -37,9 +183,10 @@ namespace ariel
         {
             size_t curr = q.front();
             q.pop();
+            const T *row = g.getRow(curr);
             for (size_t neighbor = 0; neighbor < numVertices; ++neighbor)
             {
-                if (adjMatrix[curr][neighbor] && !visited[neighbor])
+                if (row[neighbor] != T(0) && !visited[neighbor])
                 {
                     q.push(neighbor);
                     visited[neighbor] = true;
@@ -66,10 +213,10 @@ namespace ariel
      * @return A string representing the shortest path from the start vertex to the end vertex and "-1" if there is no path.
      * @details This function implements Dijkstra's algorithm to find the shortest path between the given start and end vertices in a weighted graph.
      */
-    string Algorithms::shortestPath(Graph g, int start, int end)
+    template <typename T>
+    string Algorithms::shortestPath(BasicGraph<T> g, int start, int end)
     {
         size_t numVertices = g.getNumVertices();
-        const vector<vector<int>> &adjMatrix = g.getAdjacencyMatrix();
 
         queue<size_t> q;
         q.push(static_cast<size_t>(start));
@@ -99,9 +246,10 @@ namespace ariel
             }
 
             // Enqueue unvisited neighbors of the current vertex
+            const T *row = g.getRow(curr);
             for (size_t neighbor = 0; neighbor < numVertices; ++neighbor)
             {
-                if (adjMatrix[curr][neighbor] && !visited[neighbor])
+                if (row[neighbor] != T(0) && !visited[neighbor])
                 {
                     q.push(neighbor);
                     visited[neighbor] = true;
@@ -114,6 +262,80 @@ namespace ariel
         return "-1";
     }
 
+    /**
+     * @brief Checks if a compressed graph is connected.
+     * @param g The compressed graph.
+     * @return A boolean indicating whether every vertex is reachable from vertex 0.
+     * @details The same breadth-first search as for Graph, but it only visits the existing edges, decoding them
+     * from the compressed adjacency lists as it goes.
+     */
+    template <typename T>
+    bool Algorithms::isConnected(const BasicCompressedGraph<T> &g)
+    {
+        size_t numVertices = g.getNumVertices();
+        if (numVertices == 0)
+        {
+            return true;
+        }
+        vector<bool> visited(numVertices, false);
+        vector<size_t> frontier(1, 0);
+        visited[0] = true;
+        size_t reached = 1;
+        for (size_t head = 0; head < frontier.size(); ++head)
+        {
+            for (const typename BasicCompressedGraph<T>::Edge &e : g.neighbors(frontier[head]))
+            {
+                if (!visited[e.target])
+                {
+                    visited[e.target] = true;
+                    frontier.push_back(e.target);
+                    ++reached;
+                }
+            }
+        }
+        return reached == numVertices;
+    }
+
+    /**
+     * @brief Finds a path with the fewest edges between two vertices of a compressed graph.
+     * @param g The compressed graph.
+     * @param start The starting vertex of the path.
+     * @param end The ending vertex of the path.
+     * @return A string representing the path from the start vertex to the end vertex and "-1" if there is no path.
+     * @details A breadth-first search over the compressed adjacency lists, with the output of shortestPath on a Graph.
+     */
+    template <typename T>
+    string Algorithms::shortestPath(const BasicCompressedGraph<T> &g, int start, int end)
+    {
+        size_t numVertices = g.getNumVertices();
+        size_t source = static_cast<size_t>(start), target = static_cast<size_t>(end);
+        const size_t none = numeric_limits<size_t>::max();
+        vector<size_t> predecessor(numVertices, none);
+        vector<size_t> frontier(1, source);
+        predecessor[source] = source;
+        for (size_t head = 0; head < frontier.size() && predecessor[target] == none; ++head)
+        {
+            for (const typename BasicCompressedGraph<T>::Edge &e : g.neighbors(frontier[head]))
+            {
+                if (predecessor[e.target] == none)
+                {
+                    predecessor[e.target] = frontier[head];
+                    frontier.push_back(e.target);
+                }
+            }
+        }
+        if (predecessor[target] == none)
+        {
+            return "-1";
+        }
+        string path = to_string(target);
+        for (size_t v = target; v != source; v = predecessor[v])
+        {
+            path = to_string(predecessor[v]) + "->" + path;
+        }
+        return path;
+    }
+
     /**
      * @brief Determines if the graph contains a cycle.
      * @param Graph object representing the graph.
@@ -122,7 +344,8 @@ namespace ariel
      * it tracks visited vertices and their parent vertices to detect back edges. If a back edge is encountered, indicating the presence
      * of a cycle, the function returns true. Otherwise, if no back edges are detected, it returns false, indicating the absence of a cycle.
      */
-    bool Algorithms::isContainsCycle(Graph g)
+    template <typename T>
+    bool Algorithms::isContainsCycle(BasicGraph<T> g)
     {
         size_t numVertices = g.getNumVertices();
         vector<bool> visited(numVertices, false); // Vector to track visited vertices
@@ -146,9 +369,10 @@ namespace ariel
                         visited[v] = true;
 
                         // Iterate over neighbors of vertex v
+                        const T *row = g.getRow(v);
                         for (size_t neighbor = 0; neighbor != numVertices; ++neighbor)
                         {
-                            if (g.getAdjacencyMatrix()[v][neighbor])
+                            if (row[neighbor] != T(0))
                             {
                                 if (!visited[neighbor])
                                 {
@@ -180,69 +404,87 @@ namespace ariel
     }
 
     /**
-     * @brief Determines if the graph is bipartite and partitions its vertices into two sets.
-     * @param g Graph object representing the graph.
-     * @return A string indicating whether the graph is bipartite and the partitioning of vertices into two sets.
-     * @details This function performs a breadth-first search (BFS) traversal from each vertex of the graph. During the BFS traversal,
-     * it assigns colors (0 and 1) to the vertices such that adjacent vertices have different colors. If it's possible to assign colors
-     * without any conflicts, the graph is bipartite.
+     * @brief Splits the vertices of a graph, taken as undirected, into two sides with no edge inside a side.
+     * @param g The graph in CSR form.
+     * @param partA Receives the side of the lowest vertex of every connected component, in breadth-first order.
+     * @param partB Receives the other side, in breadth-first order.
+     * @return True if the graph is bipartite, otherwise both parts are left empty.
+     * @details A breadth-first search from every uncolored vertex gives its neighbors the opposite color. Both
+     * the edges leaving a vertex and the ones entering it count, so directed graphs are split like their
+     * undirected versions.
      */
-    string Algorithms::isBipartite(Graph g)
+    template <typename T>
+    bool Algorithms::bipartition(const BasicCSRGraph<T> &g, vector<size_t> &partA, vector<size_t> &partB)
     {
         size_t numVertices = g.getNumVertices();
-
-        const vector<vector<int>> &adjMatrix = g.getAdjacencyMatrix();
-        vector<size_t> colors(numVertices, static_cast<size_t>(-1)); // Vector to store vertex colors (-1 for uncolored, 0 and 1 for two colors)
-        queue<size_t> q;
-        vector<size_t> partA, partB;
-        bool isBipartite = true;
-
-        // Perform BFS traversal from each vertex
-        for (size_t i = 0; i < numVertices; ++i) // Change loop variable to size_t
+        BasicCSRGraph<T> reversed = g.transpose();
+        const BasicCSRGraph<T> *directions[] = {&g, &reversed};
+        const unsigned char uncolored = 2;
+        vector<unsigned char> colors(numVertices, uncolored);
+        vector<size_t> queue;
+        queue.reserve(numVertices);
+        partA.clear();
+        partB.clear();
+        for (size_t i = 0; i < numVertices; ++i)
         {
-            if (colors[i] == static_cast<size_t>(-1))
+            if (colors[i] != uncolored)
             {
-                q.push(i);
-                colors[i] = 0;      // Color vertex i with color 0
-                partA.push_back(i); // Add vertex i to partition A
-
-                while (!q.empty())
+                continue;
+            }
+            colors[i] = 0;
+            partA.push_back(i);
+            queue.assign(1, i);
+            for (size_t q = 0; q < queue.size(); ++q)
+            {
+                size_t curr = queue[q];
+                unsigned char nextColor = static_cast<unsigned char>(1 - colors[curr]);
+                for (const BasicCSRGraph<T> *direction : directions)
                 {
-                    size_t curr = q.front();
-                    q.pop();
-
-                    // Assign opposite color to neighbors
-                    size_t nextColor = 1 - colors[curr];                          // Toggle the color (0 to 1 or 1 to 0)
-                    for (size_t neighbor = 0; neighbor < numVertices; ++neighbor) // Change loop variable to size_t
+                    const vector<size_t> &offsets = direction->getOffsets();
+                    const vector<size_t> &targets = direction->getTargets();
+                    for (size_t e = offsets[curr]; e < offsets[curr + 1]; ++e)
                     {
-                        if (adjMatrix[curr][neighbor])
+                        size_t neighbor = targets[e];
+                        if (colors[neighbor] == uncolored)
                         {
-                            // If neighbor is uncolored, assign the opposite color and enqueue it
-                            if (colors[neighbor] == static_cast<size_t>(-1))
-                            {
-                                colors[neighbor] = nextColor;
-                                q.push(neighbor);
-                                // Add neighbor to the corresponding partition
-                                if (nextColor == 0)
-                                {
-                                    partA.push_back(neighbor);
-                                }
-                                else
-                                {
-                                    partB.push_back(neighbor);
-                                }
-                            }
-                            else if (colors[neighbor] != nextColor)
-                            {
-                                // If neighbor is already colored and has the same color as curr, the graph is not bipartite
-                                isBipartite = false;
-                                break;
-                            }
+                            colors[neighbor] = nextColor;
+                            queue.push_back(neighbor);
+                            (nextColor == 0 ? partA : partB).push_back(neighbor);
+                        }
+                        else if (colors[neighbor] != nextColor)
+                        {
+                            partA.clear();
+                            partB.clear();
+                            return false;
                         }
                     }
                 }
             }
         }
+        return true;
+    }
+
+    /**
+     * @brief Splits the vertices of a dense graph into two sides, see the CSR version.
+     */
+    template <typename T>
+    bool Algorithms::bipartition(const BasicGraph<T> &g, vector<size_t> &partA, vector<size_t> &partB)
+    {
+        return bipartition(BasicCSRGraph<T>(g), partA, partB);
+    }
+
+    /**
+     * @brief Determines if the graph is bipartite and partitions its vertices into two sets.
+     * @param g Graph object representing the graph.
+     * @return A string indicating whether the graph is bipartite and the partitioning of vertices into two sets.
+     * @details The sides come from bipartition, which colors the vertices with a breadth-first search so that
+     * adjacent vertices have different colors.
+     */
+    template <typename T>
+    string Algorithms::isBipartite(BasicGraph<T> g)
+    {
+        vector<size_t> partA, partB;
+        bool isBipartite = bipartition(g, partA, partB);
 
         // Construct the partition string
         string partition;
@@ -278,25 +520,30 @@ namespace ariel
      * @returns A string indicating whether the graph contains a negative cycle.
      * @details This function implements the Bellman-Ford algorithm to detect negative cycles in the graph.
      */
-    string Algorithms::negativeCycle(Graph g)
+    template <typename T>
+    string Algorithms::negativeCycle(BasicGraph<T> g)
     {
+        typedef typename PathLength<T>::type D;
         size_t numVertices = g.getNumVertices(); // Change type to size_t
-        const vector<vector<int>> &adjMatrix = g.getAdjacencyMatrix();
 
-        // Initialize distance array
-        vector<int> dist(numVertices, INT_MAX);
-        dist[0] = 0; // Set distance from source vertex to itself as 0
+        // Initialize distance array, distances are kept in a wider type so that they cannot overflow
+        vector<D> dist(numVertices, D(0));
+        vector<bool> reached(numVertices, false);
+        dist[0] = D(0); // Set distance from source vertex to itself as 0
+        reached[0] = true;
 
         // Relax edges repeatedly to find shortest paths
         for (size_t i = 0; i < numVertices - 1; ++i) // Change loop variable to size_t
         {
             for (size_t u = 0; u < numVertices; ++u) // Change loop variable to size_t
             {
+                const T *row = g.getRow(u);
                 for (size_t v = 0; v < numVertices; ++v) // Change loop variable to size_t
                 {
-                    if (adjMatrix[u][v] && dist[u] != INT_MAX && dist[u] + adjMatrix[u][v] < dist[v])
+                    if (row[v] != T(0) && reached[u] && (!reached[v] || dist[u] + row[v] < dist[v]))
                     {
-                        dist[v] = dist[u] + adjMatrix[u][v];
+                        dist[v] = dist[u] + row[v];
+                        reached[v] = true;
                     }
                 }
             }
@@ -305,9 +552,10 @@ namespace ariel
         // Check for negative cycles
         for (size_t u = 0; u < numVertices; ++u) // Change loop variable to size_t
         {
+            const T *row = g.getRow(u);
             for (size_t v = 0; v < numVertices; ++v) // Change loop variable to size_t
             {
-                if (adjMatrix[u][v] && dist[u] != INT_MAX && dist[u] + adjMatrix[u][v] < dist[v])
+                if (row[v] != T(0) && reached[u] && dist[u] + row[v] < dist[v])
                 {
                     return "The graph contains a negative cycle.";
                 }
@@ -316,4 +564,2720 @@ namespace ariel
 
         return "The graph does not contain a negative cycle.";
     }
-}
\ No newline at end of file
+
+    /**
+     * @brief Computes the shortest distance between every pair of vertices.
+     * @param g Graph object representing the graph, a non-zero entry is an edge with that weight.
+     * @param threads The number of threads to use, 0 for the hardware concurrency.
+     * @return A graph whose entry [i][j] is the length of the shortest path from i to j,
+     * or numeric_limits<T>::max() if j is not reachable from i.
+     * @throws invalid_argument If the graph contains a negative cycle.
+     * @throws overflow_error If a shortest distance does not fit the weight type, or if for 64-bit and floating
+     * point weights the longest possible simple path could reach the "no path" sentinel of the kernel.
+     * @details This function runs a cache-blocked Floyd-Warshall. Narrower integer weights are computed in long
+     * long, where no distance comes near the sentinel, while 64-bit and floating point weights are checked up
+     * front: (V - 1) times the largest absolute weight must stay below half the range of the type, otherwise
+     * distances could be mistaken for "no path" and the function throws instead. The matrix is padded to a multiple of the tile
+     * size and for every pivot tile the three dependent phases are processed in order: the pivot tile itself,
+     * then the tiles sharing its row or column, then all the remaining tiles. The tiles of the last two phases
+     * are independent of each other and are spread over the worker threads.
+     */
+    template <typename T>
+    BasicGraph<T> Algorithms::allPairsShortestPaths(const BasicGraph<T> &g, size_t threads)
+    {
+        typedef typename TileDistance<T>::type D;
+        const D inf = fwInfinity<D>();
+        size_t numVertices = g.getNumVertices();
+        size_t tiles = (numVertices + FW_TILE - 1) / FW_TILE;
+        size_t stride = tiles * FW_TILE;
+
+        long double heaviest = 0;
+        for (size_t i = 0; i < numVertices; ++i)
+        {
+            const T *row = g.getRow(i);
+            for (size_t j = 0; j < numVertices; ++j)
+            {
+                long double w = static_cast<long double>(row[j]);
+                heaviest = max(heaviest, w < 0 ? -w : w);
+            }
+        }
+        if (numVertices > 1 && heaviest * static_cast<long double>(numVertices - 1) >= static_cast<long double>(inf))
+        {
+            throw overflow_error("the weights are too large for the distance kernel, a path could reach its sentinel");
+        }
+
+        vector<D> dist(stride * stride, inf);
+        for (size_t i = 0; i < stride; ++i)
+        {
+            dist[i * stride + i] = D(0);
+        }
+        for (size_t i = 0; i < numVertices; ++i)
+        {
+            const T *row = g.getRow(i);
+            for (size_t j = 0; j < numVertices; ++j)
+            {
+                D w = static_cast<D>(row[j]);
+                if (w != D(0) && w < dist[i * stride + j])
+                {
+                    dist[i * stride + j] = w;
+                }
+            }
+        }
+
+        D *d = dist.data();
+        for (size_t kb = 0; kb < tiles; ++kb)
+        {
+            D *pivot = d + (kb * stride + kb) * FW_TILE;
+
+            // Phase 1: the pivot tile depends only on itself
+            relaxTile(pivot, pivot, pivot, stride);
+
+            // Phase 2: the tiles in the pivot row and the pivot column
+            parallelFor(0, 2 * tiles, [&](size_t t)
+                        {
+                            size_t other = t % tiles;
+                            if (other == kb)
+                            {
+                                return;
+                            }
+                            if (t < tiles)
+                            {
+                                D *tile = d + (kb * stride + other) * FW_TILE;
+                                relaxTile(tile, pivot, tile, stride);
+                            }
+                            else
+                            {
+                                D *tile = d + (other * stride + kb) * FW_TILE;
+                                relaxTile(tile, tile, pivot, stride);
+                            }
+                        },
+                        threads);
+
+            // Phase 3: every other tile, one row of tiles per task
+            parallelFor(0, tiles, [&](size_t ib)
+                        {
+                            if (ib == kb)
+                            {
+                                return;
+                            }
+                            const D *rowTile = d + (ib * stride + kb) * FW_TILE;
+                            for (size_t jb = 0; jb < tiles; ++jb)
+                            {
+                                if (jb == kb)
+                                {
+                                    continue;
+                                }
+                                relaxTile(d + (ib * stride + jb) * FW_TILE, rowTile, d + (kb * stride + jb) * FW_TILE, stride);
+                            }
+                        },
+                        threads);
+        }
+
+        bool fits = true;
+        vector<vector<T>> result(numVertices, vector<T>(numVertices));
+        for (size_t i = 0; i < numVertices; ++i)
+        {
+            if (dist[i * stride + i] < D(0))
+            {
+                throw invalid_argument("The graph contains a negative cycle.");
+            }
+            for (size_t j = 0; j < numVertices; ++j)
+            {
+                D value = dist[i * stride + j];
+                result[i][j] = value >= inf ? numeric_limits<T>::max() : toWeight<T>(value, fits);
+            }
+        }
+        if (!fits)
+        {
+            throw overflow_error("a shortest distance does not fit the weight type");
+        }
+        BasicGraph<T> distances;
+        distances.loadGraph(std::move(result));
+        return distances;
+    }
+
+    /**
+     * @brief Computes the shortest distance between every pair of vertices of a sparse graph using Johnson's algorithm.
+     * @param g Graph object representing the graph, a non-zero entry is an edge with that weight.
+     * @param threads The number of threads to use, 0 for the hardware concurrency.
+     * @return A graph whose entry [i][j] is the length of the shortest path from i to j,
+     * or numeric_limits<T>::max() if j is not reachable from i.
+     * @throws invalid_argument If the graph contains a negative cycle.
+     * @throws overflow_error If a shortest distance does not fit the weight type.
+     */
+    template <typename T>
+    BasicGraph<T> Algorithms::johnsonShortestPaths(const BasicGraph<T> &g, size_t threads)
+    {
+        vector<vector<T>> result(g.getNumVertices());
+        johnsonShortestPaths(BasicCSRGraph<T>(g), [&result](size_t source, const vector<T> &row)
+                             { result[source] = row; },
+                             64, threads);
+        BasicGraph<T> distances;
+        distances.loadGraph(std::move(result));
+        return distances;
+    }
+
+    /**
+     * @brief Streams the all pairs shortest distances of a sparse graph row by row using Johnson's algorithm.
+     * @param g The graph in CSR form.
+     * @param rowSink Called with every source vertex and its row of distances, in increasing order of the source.
+     * Unreachable vertices have distance numeric_limits<T>::max(). The row is only valid during the call.
+     * @param rowsInFlight The maximum number of rows held in memory at once.
+     * @param threads The number of threads to use, 0 for the hardware concurrency.
+     * @throws invalid_argument If the graph contains a negative cycle.
+     * @throws overflow_error If a shortest distance does not fit the weight type, the rows before it have been delivered.
+     * @details One Bellman-Ford pass from a virtual source connected to every vertex gives potentials h that make every
+     * reweighted edge w(u, v) + h(u) - h(v) non-negative. A fixed set of worker threads then claims sources from an
+     * atomic counter and runs their Dijkstra searches into a ring of rowsInFlight row buffers, while the calling thread
+     * hands the finished rows to the sink in order. A worker only waits when its ring slot still holds an undelivered
+     * row, so a slow search never holds up the others and memory stays bounded by rowsInFlight rows no matter how
+     * many vertices the graph has.
+     */
+    template <typename T>
+    void Algorithms::johnsonShortestPaths(const BasicCSRGraph<T> &g,
+                                          const function<void(size_t, const vector<typename BasicCSRGraph<T>::Weight> &)> &rowSink,
+                                          size_t rowsInFlight, size_t threads)
+    {
+        typedef typename PathLength<T>::type D;
+        size_t numVertices = g.getNumVertices();
+        const vector<size_t> &offsets = g.getOffsets();
+        const vector<size_t> &targets = g.getTargets();
+        const vector<T> &weights = g.getWeights();
+
+        // Bellman-Ford from the virtual source, every vertex starts at distance 0
+        vector<D> potential(numVertices, D(0));
+        bool changed = true;
+        for (size_t round = 0; changed; ++round)
+        {
+            if (round == numVertices + 1)
+            {
+                throw invalid_argument("The graph contains a negative cycle.");
+            }
+            changed = false;
+            for (size_t u = 0; u < numVertices; ++u)
+            {
+                for (size_t e = offsets[u]; e < offsets[u + 1]; ++e)
+                {
+                    if (potential[u] + weights[e] < potential[targets[e]])
+                    {
+                        potential[targets[e]] = potential[u] + weights[e];
+                        changed = true;
+                    }
+                }
+            }
+        }
+
+        vector<D> reduced(targets.size());
+        for (size_t u = 0; u < numVertices; ++u)
+        {
+            for (size_t e = offsets[u]; e < offsets[u + 1]; ++e)
+            {
+                reduced[e] = weights[e] + potential[u] - potential[targets[e]];
+            }
+        }
+
+        if (numVertices == 0)
+        {
+            return;
+        }
+        size_t slots = max(size_t(1), min(rowsInFlight, numVertices));
+        vector<vector<T>> rows(slots);
+        vector<char> rowFits(slots), rowReady(slots, 0);
+        atomic<size_t> nextSource(0);
+        size_t delivered = 0;
+        bool stop = false;
+        exception_ptr failure;
+        mutex lock;
+        condition_variable progress;
+
+        // Workers claim sources in increasing order and wait until the ring slot of their source is free again
+        auto worker = [&]()
+        {
+            try
+            {
+                for (;;)
+                {
+                    size_t source = nextSource++;
+                    if (source >= numVertices)
+                    {
+                        return;
+                    }
+                    size_t slot = source % slots;
+                    {
+                        unique_lock<mutex> guard(lock);
+                        progress.wait(guard, [&]()
+                                      { return stop || source < delivered + slots; });
+                        if (stop)
+                        {
+                            return;
+                        }
+                    }
+                    bool fits = reducedDijkstra(g, reduced, potential, source, rows[slot]);
+                    {
+                        lock_guard<mutex> guard(lock);
+                        rowFits[slot] = fits;
+                        rowReady[slot] = 1;
+                    }
+                    progress.notify_all();
+                }
+            }
+            catch (...)
+            {
+                {
+                    lock_guard<mutex> guard(lock);
+                    if (!failure)
+                    {
+                        failure = current_exception();
+                    }
+                    stop = true;
+                }
+                progress.notify_all();
+            }
+        };
+
+        vector<thread> pool;
+        auto shutdown = [&]()
+        {
+            {
+                lock_guard<mutex> guard(lock);
+                stop = true;
+            }
+            progress.notify_all();
+            for (thread &t : pool)
+            {
+                t.join();
+            }
+        };
+        try
+        {
+            size_t workers = min(workerCount(threads), numVertices);
+            for (size_t w = 0; w < workers; ++w)
+            {
+                pool.push_back(thread(worker));
+            }
+            // The calling thread hands the rows to the sink in order while the workers run ahead
+            for (size_t source = 0; source < numVertices; ++source)
+            {
+                size_t slot = source % slots;
+                unique_lock<mutex> guard(lock);
+                progress.wait(guard, [&]()
+                              { return rowReady[slot] || stop; });
+                if (!rowReady[slot])
+                {
+                    rethrow_exception(failure);
+                }
+                guard.unlock();
+                if (!rowFits[slot])
+                {
+                    throw overflow_error("a shortest distance does not fit the weight type");
+                }
+                rowSink(source, rows[slot]);
+                guard.lock();
+                rowReady[slot] = 0;
+                delivered++;
+                guard.unlock();
+                progress.notify_all();
+            }
+        }
+        catch (...)
+        {
+            shutdown();
+            throw;
+        }
+        shutdown();
+    }
+
+    namespace
+    {
+        const size_t NO_VERTEX = numeric_limits<size_t>::max();
+
+        // Subproblems of the parallel decomposition smaller than this are finished with Tarjan's algorithm
+        const size_t FWBW_SERIAL_SIZE = 4096;
+
+        /**
+         * @brief The scratch arrays of Tarjan's algorithm, sized for the whole graph and reused across calls.
+         */
+        struct TarjanState
+        {
+            vector<size_t> index;
+            vector<size_t> low;
+            vector<char> onStack;
+            vector<size_t> stack;
+            vector<pair<size_t, size_t>> frames; // (vertex, next edge) of the simulated recursion
+
+            explicit TarjanState(size_t n) : index(n, NO_VERTEX), low(n, 0), onStack(n, 0) {}
+        };
+
+        /**
+         * @brief Tarjan's algorithm with an explicit stack, so deep graphs cannot overflow the call stack.
+         * @param g The graph.
+         * @param roots The vertices to start from, every vertex reachable inside the subgraph is visited.
+         * @param inside Tells which vertices belong to the subgraph being decomposed.
+         * @param state Scratch arrays, the entries of the visited vertices are reset before returning.
+         * @param emit Called with the vertices of every component, sinks first (reverse topological order).
+         */
+        template <typename T, typename Inside, typename Emit>
+        void tarjan(const BasicCSRGraph<T> &g, const vector<size_t> &roots, Inside inside, TarjanState &state, Emit emit)
+        {
+            const vector<size_t> &offsets = g.getOffsets();
+            const vector<size_t> &targets = g.getTargets();
+            vector<size_t> visited;
+            vector<size_t> component;
+            size_t counter = 0;
+            for (size_t root : roots)
+            {
+                if (state.index[root] != NO_VERTEX || !inside(root))
+                {
+                    continue;
+                }
+                state.index[root] = state.low[root] = counter++;
+                state.stack.push_back(root);
+                state.onStack[root] = 1;
+                visited.push_back(root);
+                state.frames.push_back(make_pair(root, offsets[root]));
+                while (!state.frames.empty())
+                {
+                    size_t v = state.frames.back().first;
+                    size_t &e = state.frames.back().second;
+                    if (e < offsets[v + 1])
+                    {
+                        size_t u = targets[e++];
+                        if (!inside(u))
+                        {
+                            continue;
+                        }
+                        if (state.index[u] == NO_VERTEX)
+                        {
+                            state.index[u] = state.low[u] = counter++;
+                            state.stack.push_back(u);
+                            state.onStack[u] = 1;
+                            visited.push_back(u);
+                            state.frames.push_back(make_pair(u, offsets[u]));
+                        }
+                        else if (state.onStack[u])
+                        {
+                            state.low[v] = min(state.low[v], state.index[u]);
+                        }
+                        continue;
+                    }
+                    state.frames.pop_back();
+                    if (!state.frames.empty())
+                    {
+                        size_t parent = state.frames.back().first;
+                        state.low[parent] = min(state.low[parent], state.low[v]);
+                    }
+                    if (state.low[v] == state.index[v])
+                    {
+                        component.clear();
+                        size_t u;
+                        do
+                        {
+                            u = state.stack.back();
+                            state.stack.pop_back();
+                            state.onStack[u] = 0;
+                            component.push_back(u);
+                        } while (u != v);
+                        emit(component);
+                    }
+                }
+            }
+            for (size_t v : visited)
+            {
+                state.index[v] = NO_VERTEX;
+            }
+        }
+
+        /**
+         * @brief Renumbers components so that every edge between two of them goes from the lower id to the higher.
+         * @param g The graph.
+         * @param components The component of every vertex, ids below count in any order, renumbered in place.
+         * @param count The number of components.
+         */
+        template <typename T>
+        void renumberTopologically(const BasicCSRGraph<T> &g, vector<size_t> &components, size_t count)
+        {
+            vector<vector<size_t>> successors(count);
+            vector<size_t> inDegree(count, 0);
+            for (size_t v = 0; v < g.getNumVertices(); ++v)
+            {
+                for (size_t e = g.getOffsets()[v]; e < g.getOffsets()[v + 1]; ++e)
+                {
+                    size_t from = components[v], to = components[g.getTargets()[e]];
+                    if (from != to)
+                    {
+                        successors[from].push_back(to);
+                        inDegree[to]++;
+                    }
+                }
+            }
+            vector<size_t> rank(count);
+            vector<size_t> ready;
+            for (size_t c = 0; c < count; ++c)
+            {
+                if (inDegree[c] == 0)
+                {
+                    ready.push_back(c);
+                }
+            }
+            for (size_t next = 0; next < ready.size(); ++next)
+            {
+                size_t c = ready[next];
+                rank[c] = next;
+                for (size_t d : successors[c])
+                {
+                    if (--inDegree[d] == 0)
+                    {
+                        ready.push_back(d);
+                    }
+                }
+            }
+            for (size_t &c : components)
+            {
+                c = rank[c];
+            }
+        }
+
+        /**
+         * @brief The forward-backward decomposition, run on several threads.
+         * @details Vertices without in- or out-edges inside what is left are trimmed off as single components
+         * first, which removes most of the small components of real graphs. Every remaining subproblem is a set of
+         * vertices that no component crosses: the vertices both reachable from a pivot and reaching it form the
+         * pivot's component, and the forward-only, backward-only and unreached rest become three independent
+         * subproblems that the threads take from a shared queue. Small subproblems are finished with Tarjan's
+         * algorithm.
+         */
+        template <typename T>
+        size_t forwardBackward(const BasicCSRGraph<T> &g, vector<size_t> &components, size_t threads)
+        {
+            size_t n = g.getNumVertices();
+            BasicCSRGraph<T> reverse = g.transpose();
+            const vector<size_t> &offsets = g.getOffsets();
+            const vector<size_t> &targets = g.getTargets();
+            const vector<size_t> &reverseOffsets = reverse.getOffsets();
+            const vector<size_t> &reverseTargets = reverse.getTargets();
+            size_t count = 0;
+
+            // Trimming
+            vector<size_t> inLeft(n), outLeft(n), trimmed;
+            for (size_t v = 0; v < n; ++v)
+            {
+                outLeft[v] = offsets[v + 1] - offsets[v];
+                inLeft[v] = reverseOffsets[v + 1] - reverseOffsets[v];
+                if (outLeft[v] == 0 || inLeft[v] == 0)
+                {
+                    components[v] = count++;
+                    trimmed.push_back(v);
+                }
+            }
+            for (size_t next = 0; next < trimmed.size(); ++next)
+            {
+                size_t v = trimmed[next];
+                for (size_t e = offsets[v]; e < offsets[v + 1]; ++e)
+                {
+                    size_t u = targets[e];
+                    if (components[u] == NO_VERTEX && --inLeft[u] == 0 && outLeft[u] != 0)
+                    {
+                        components[u] = count++;
+                        trimmed.push_back(u);
+                    }
+                }
+                for (size_t e = reverseOffsets[v]; e < reverseOffsets[v + 1]; ++e)
+                {
+                    size_t u = reverseTargets[e];
+                    if (components[u] == NO_VERTEX && --outLeft[u] == 0 && inLeft[u] != 0)
+                    {
+                        components[u] = count++;
+                        trimmed.push_back(u);
+                    }
+                }
+            }
+
+            // Every untrimmed vertex carries the id of its subproblem, only the owner of a subproblem rewrites them
+            unique_ptr<atomic<size_t>[]> subproblem(new atomic<size_t>[n]);
+            vector<size_t> rest;
+            for (size_t v = 0; v < n; ++v)
+            {
+                subproblem[v].store(components[v] == NO_VERTEX ? 0 : NO_VERTEX, memory_order_relaxed);
+                if (components[v] == NO_VERTEX)
+                {
+                    rest.push_back(v);
+                }
+            }
+            atomic<size_t> nextComponent(count), nextSubproblem(1);
+
+            mutex lock;
+            condition_variable ready;
+            deque<pair<size_t, vector<size_t>>> queue;
+            size_t busy = 0;
+            if (!rest.empty())
+            {
+                queue.push_back(make_pair(size_t(0), std::move(rest)));
+            }
+            auto inSubproblem = [&subproblem](size_t v, size_t id)
+            {
+                return subproblem[v].load(memory_order_relaxed) == id;
+            };
+
+            parallelFor(0, workerCount(threads), [&](size_t)
+                        {
+                            TarjanState state(n);
+                            vector<size_t> frontier;
+                            unique_lock<mutex> guard(lock);
+                            for (;;)
+                            {
+                                ready.wait(guard, [&]()
+                                           { return !queue.empty() || busy == 0; });
+                                if (queue.empty())
+                                {
+                                    return;
+                                }
+                                size_t id = queue.front().first;
+                                vector<size_t> vertices = std::move(queue.front().second);
+                                queue.pop_front();
+                                busy++;
+                                guard.unlock();
+
+                                vector<pair<size_t, vector<size_t>>> parts;
+                                if (vertices.size() < FWBW_SERIAL_SIZE)
+                                {
+                                    tarjan(g, vertices, [&](size_t v)
+                                           { return inSubproblem(v, id); },
+                                           state, [&](const vector<size_t> &component)
+                                           {
+                                               size_t c = nextComponent++;
+                                               for (size_t v : component)
+                                               {
+                                                   components[v] = c;
+                                               }
+                                           });
+                                }
+                                else
+                                {
+                                    // The pivot with the most edges is the likeliest to sit in a big component
+                                    size_t pivot = vertices[0];
+                                    for (size_t v : vertices)
+                                    {
+                                        if ((offsets[v + 1] - offsets[v]) * (reverseOffsets[v + 1] - reverseOffsets[v]) >
+                                            (offsets[pivot + 1] - offsets[pivot]) * (reverseOffsets[pivot + 1] - reverseOffsets[pivot]))
+                                        {
+                                            pivot = v;
+                                        }
+                                    }
+                                    size_t forward = nextSubproblem++, backward = nextSubproblem++;
+                                    size_t component = nextComponent++;
+                                    frontier.assign(1, pivot);
+                                    subproblem[pivot].store(forward, memory_order_relaxed);
+                                    for (size_t next = 0; next < frontier.size(); ++next)
+                                    {
+                                        size_t v = frontier[next];
+                                        for (size_t e = offsets[v]; e < offsets[v + 1]; ++e)
+                                        {
+                                            if (inSubproblem(targets[e], id))
+                                            {
+                                                subproblem[targets[e]].store(forward, memory_order_relaxed);
+                                                frontier.push_back(targets[e]);
+                                            }
+                                        }
+                                    }
+                                    frontier.assign(1, pivot);
+                                    subproblem[pivot].store(NO_VERTEX, memory_order_relaxed);
+                                    components[pivot] = component;
+                                    for (size_t next = 0; next < frontier.size(); ++next)
+                                    {
+                                        size_t v = frontier[next];
+                                        for (size_t e = reverseOffsets[v]; e < reverseOffsets[v + 1]; ++e)
+                                        {
+                                            size_t u = reverseTargets[e];
+                                            if (inSubproblem(u, forward))
+                                            {
+                                                subproblem[u].store(NO_VERTEX, memory_order_relaxed);
+                                                components[u] = component;
+                                                frontier.push_back(u);
+                                            }
+                                            else if (inSubproblem(u, id))
+                                            {
+                                                subproblem[u].store(backward, memory_order_relaxed);
+                                                frontier.push_back(u);
+                                            }
+                                        }
+                                    }
+                                    parts.resize(3);
+                                    parts[0].first = forward;
+                                    parts[1].first = backward;
+                                    parts[2].first = id;
+                                    for (size_t v : vertices)
+                                    {
+                                        size_t owner = subproblem[v].load(memory_order_relaxed);
+                                        if (owner != NO_VERTEX)
+                                        {
+                                            parts[owner == forward ? 0 : owner == backward ? 1 : 2].second.push_back(v);
+                                        }
+                                    }
+                                }
+
+                                guard.lock();
+                                busy--;
+                                for (pair<size_t, vector<size_t>> &part : parts)
+                                {
+                                    if (!part.second.empty())
+                                    {
+                                        queue.push_back(std::move(part));
+                                    }
+                                }
+                                ready.notify_all();
+                            }
+                        },
+                        workerCount(threads));
+            return nextComponent.load();
+        }
+    }
+
+    /**
+     * @brief Finds the strongly connected components of a directed graph.
+     * @param g The graph, an edge is a non-zero entry.
+     * @param threads The number of threads to use, 0 for the hardware concurrency.
+     * @return The component of every vertex. The ids run from 0 to the number of components minus one in a
+     * topological order of the condensation: every edge between two components goes from the lower id to the
+     * higher one.
+     * @details One thread, or a small graph, runs Tarjan's algorithm with an explicit stack. Otherwise the
+     * forward-backward decomposition with trimming splits the graph across the threads (see forwardBackward).
+     */
+    template <typename T>
+    vector<size_t> Algorithms::stronglyConnectedComponents(const BasicCSRGraph<T> &g, size_t threads)
+    {
+        size_t n = g.getNumVertices();
+        vector<size_t> components(n, NO_VERTEX);
+        if (workerCount(threads) <= 1 || n < FWBW_SERIAL_SIZE)
+        {
+            // Tarjan finds the sinks first, so counting down gives a topological numbering
+            vector<size_t> roots(n);
+            for (size_t v = 0; v < n; ++v)
+            {
+                roots[v] = v;
+            }
+            TarjanState state(n);
+            size_t found = 0;
+            tarjan(g, roots, [](size_t)
+                   { return true; },
+                   state, [&](const vector<size_t> &component)
+                   {
+                       for (size_t v : component)
+                       {
+                           components[v] = found;
+                       }
+                       found++;
+                   });
+            for (size_t &c : components)
+            {
+                c = found - 1 - c;
+            }
+            return components;
+        }
+        size_t count = forwardBackward(g, components, threads);
+        renumberTopologically(g, components, count);
+        return components;
+    }
+
+    /**
+     * @brief Finds the strongly connected components of a directed graph.
+     * @param g The graph.
+     * @param threads The number of threads to use, 0 for the hardware concurrency.
+     * @return The component of every vertex, numbered in a topological order of the condensation.
+     */
+    template <typename T>
+    vector<size_t> Algorithms::stronglyConnectedComponents(const BasicGraph<T> &g, size_t threads)
+    {
+        return stronglyConnectedComponents(BasicCSRGraph<T>(g), threads);
+    }
+
+    /**
+     * @brief Checks if every vertex of a directed graph can reach every other one.
+     * @param g The graph.
+     * @return True if the graph has a single strongly connected component, or no vertices.
+     */
+    template <typename T>
+    bool Algorithms::isStronglyConnected(const BasicGraph<T> &g)
+    {
+        vector<size_t> components = stronglyConnectedComponents(g, 1);
+        return all_of(components.begin(), components.end(), [](size_t c)
+                      { return c == 0; });
+    }
+
+    /**
+     * @brief Contracts every strongly connected component of a graph to a single vertex.
+     * @param g The graph.
+     * @param components The components of g as returned by stronglyConnectedComponents.
+     * @return The condensation, a DAG with a vertex per component whose entry [a][b] counts the edges of g from
+     * component a to component b. With topologically numbered components its matrix is strictly upper triangular.
+     * @throws invalid_argument If components does not have an entry for every vertex of g.
+     */
+    template <typename T>
+    Graph Algorithms::condensation(const BasicGraph<T> &g, const vector<size_t> &components)
+    {
+        size_t n = g.getNumVertices();
+        if (components.size() != n)
+        {
+            throw invalid_argument("the components do not match the graph");
+        }
+        size_t count = 0;
+        for (size_t c : components)
+        {
+            count = max(count, c + 1);
+        }
+        Graph dag(static_cast<int>(count));
+        for (size_t u = 0; u < n; ++u)
+        {
+            const T *row = g.getRow(u);
+            for (size_t v = 0; v < n; ++v)
+            {
+                if (row[v] != T(0) && components[u] != components[v])
+                {
+                    dag.setEdge(components[u], components[v], dag.getEdge(components[u], components[v]) + 1);
+                }
+            }
+        }
+        return dag;
+    }
+
+    /**
+     * @brief Orders the vertices of a DAG so that every edge goes from an earlier vertex to a later one.
+     * @param g The graph.
+     * @return The vertices in topological order, found with Kahn's algorithm in O(V + E).
+     * @throws invalid_argument If the graph contains a cycle.
+     */
+    template <typename T>
+    vector<size_t> Algorithms::topologicalSort(const BasicCSRGraph<T> &g)
+    {
+        size_t n = g.getNumVertices();
+        const vector<size_t> &offsets = g.getOffsets();
+        const vector<size_t> &targets = g.getTargets();
+        vector<size_t> inDegree(n, 0);
+        for (size_t t : targets)
+        {
+            inDegree[t]++;
+        }
+        vector<size_t> order;
+        order.reserve(n);
+        for (size_t v = 0; v < n; ++v)
+        {
+            if (inDegree[v] == 0)
+            {
+                order.push_back(v);
+            }
+        }
+        for (size_t next = 0; next < order.size(); ++next)
+        {
+            size_t u = order[next];
+            for (size_t e = offsets[u]; e < offsets[u + 1]; ++e)
+            {
+                if (--inDegree[targets[e]] == 0)
+                {
+                    order.push_back(targets[e]);
+                }
+            }
+        }
+        if (order.size() != n)
+        {
+            throw invalid_argument("The graph contains a cycle.");
+        }
+        return order;
+    }
+
+    /**
+     * @brief Orders the vertices of a DAG so that every edge goes from an earlier vertex to a later one.
+     * @param g The graph, a non-zero entry is an edge.
+     * @return The vertices in topological order.
+     * @throws invalid_argument If the graph contains a cycle.
+     */
+    template <typename T>
+    vector<size_t> Algorithms::topologicalSort(const BasicGraph<T> &g)
+    {
+        return topologicalSort(BasicCSRGraph<T>(g));
+    }
+
+    /**
+     * @brief Splits the vertices of a DAG into levels that can be processed one after the other.
+     * @param g The graph.
+     * @param threads The number of threads to use, 0 for the hardware concurrency.
+     * @return levels[0] holds the vertices without incoming edges and levels[k] the vertices whose predecessors
+     * all lie in earlier levels, the length of the longest path into them in edges. Each level is sorted.
+     * @throws invalid_argument If the graph contains a cycle.
+     * @details Kahn's algorithm one level at a time: the threads take chunks of the current level and count down
+     * the in-degrees of its successors atomically, collecting the vertices that reach zero for the next level.
+     * The vertices of one level are independent of each other, so a scheduler can run each level in parallel.
+     */
+    template <typename T>
+    vector<vector<size_t>> Algorithms::topologicalLevels(const BasicCSRGraph<T> &g, size_t threads)
+    {
+        size_t n = g.getNumVertices();
+        const vector<size_t> &offsets = g.getOffsets();
+        const vector<size_t> &targets = g.getTargets();
+        unique_ptr<atomic<size_t>[]> inDegree(new atomic<size_t>[n]);
+        for (size_t v = 0; v < n; ++v)
+        {
+            inDegree[v].store(0, memory_order_relaxed);
+        }
+        for (size_t t : targets)
+        {
+            inDegree[t].fetch_add(1, memory_order_relaxed);
+        }
+        vector<vector<size_t>> levels(1);
+        for (size_t v = 0; v < n; ++v)
+        {
+            if (inDegree[v].load(memory_order_relaxed) == 0)
+            {
+                levels[0].push_back(v);
+            }
+        }
+
+        size_t placed = levels[0].size();
+        size_t chunks = 4 * workerCount(threads);
+        vector<vector<size_t>> found(chunks);
+        while (!levels.back().empty())
+        {
+            const vector<size_t> &level = levels.back();
+            size_t chunkSize = (level.size() + chunks - 1) / chunks;
+            parallelFor(0, chunks, [&](size_t c)
+                        {
+                            found[c].clear();
+                            size_t end = min(level.size(), (c + 1) * chunkSize);
+                            for (size_t i = c * chunkSize; i < end; ++i)
+                            {
+                                size_t u = level[i];
+                                for (size_t e = offsets[u]; e < offsets[u + 1]; ++e)
+                                {
+                                    if (inDegree[targets[e]].fetch_sub(1, memory_order_acq_rel) == 1)
+                                    {
+                                        found[c].push_back(targets[e]);
+                                    }
+                                }
+                            }
+                        },
+                        level.size() < 1024 ? 1 : threads);
+            vector<size_t> next;
+            for (const vector<size_t> &part : found)
+            {
+                next.insert(next.end(), part.begin(), part.end());
+            }
+            sort(next.begin(), next.end());
+            placed += next.size();
+            levels.push_back(std::move(next));
+        }
+        levels.pop_back();
+        if (placed != n)
+        {
+            throw invalid_argument("The graph contains a cycle.");
+        }
+        return levels;
+    }
+
+    namespace
+    {
+        /**
+         * @brief Single source shortest or longest paths of a DAG, relaxing the edges in topological order.
+         * @param order A topological order of g.
+         * @param source The source vertex, or NO_VERTEX to start at every vertex with length 0.
+         * @param dist Receives the path lengths, unreached for vertices that cannot be reached.
+         * @param previous Receives the vertex before each one on its best path, NO_VERTEX at the start.
+         */
+        template <typename T, typename D>
+        void relaxInOrder(const BasicCSRGraph<T> &g, const vector<size_t> &order, size_t source, bool longest,
+                          D unreached, vector<D> &dist, vector<size_t> &previous)
+        {
+            const vector<size_t> &offsets = g.getOffsets();
+            const vector<size_t> &targets = g.getTargets();
+            const vector<T> &weights = g.getWeights();
+            dist.assign(g.getNumVertices(), source == NO_VERTEX ? D(0) : unreached);
+            previous.assign(g.getNumVertices(), NO_VERTEX);
+            if (source != NO_VERTEX)
+            {
+                dist[source] = D(0);
+            }
+            for (size_t u : order)
+            {
+                if (dist[u] == unreached)
+                {
+                    continue;
+                }
+                for (size_t e = offsets[u]; e < offsets[u + 1]; ++e)
+                {
+                    D candidate = dist[u] + static_cast<D>(weights[e]);
+                    size_t t = targets[e];
+                    if (longest ? candidate > dist[t] : candidate < dist[t])
+                    {
+                        dist[t] = candidate;
+                        previous[t] = u;
+                    }
+                }
+            }
+        }
+
+        template <typename T>
+        vector<T> dagPaths(const BasicCSRGraph<T> &g, size_t source, bool longest)
+        {
+            typedef typename PathLength<T>::type D;
+            if (source >= g.getNumVertices())
+            {
+                throw invalid_argument("the vertex is not in the graph");
+            }
+            const D unreached = longest ? numeric_limits<D>::lowest() : numeric_limits<D>::max();
+            vector<D> dist;
+            vector<size_t> previous;
+            relaxInOrder(g, Algorithms::topologicalSort(g), source, longest, unreached, dist, previous);
+            vector<T> lengths(dist.size());
+            bool fits = true;
+            for (size_t v = 0; v < dist.size(); ++v)
+            {
+                if (dist[v] == unreached)
+                {
+                    lengths[v] = longest ? numeric_limits<T>::lowest() : numeric_limits<T>::max();
+                }
+                else
+                {
+                    lengths[v] = toWeight<T>(dist[v], fits);
+                }
+            }
+            if (!fits)
+            {
+                throw overflow_error("a path length does not fit the weight type");
+            }
+            return lengths;
+        }
+    }
+
+    /**
+     * @brief Computes the shortest paths from a source in a DAG in O(V + E), negative weights included.
+     * @param g The graph.
+     * @param source The source vertex.
+     * @return The length of the shortest path to every vertex, numeric_limits<T>::max() if it is not reachable.
+     * @throws invalid_argument If the graph contains a cycle or the source is not in the graph.
+     * @throws overflow_error If a path length does not fit the weight type.
+     */
+    template <typename T>
+    vector<T> Algorithms::dagShortestPaths(const BasicCSRGraph<T> &g, size_t source)
+    {
+        return dagPaths(g, source, false);
+    }
+
+    /**
+     * @brief Computes the longest paths from a source in a DAG in O(V + E).
+     * @param g The graph.
+     * @param source The source vertex.
+     * @return The length of the longest path to every vertex, numeric_limits<T>::lowest() if it is not reachable.
+     * @throws invalid_argument If the graph contains a cycle or the source is not in the graph.
+     * @throws overflow_error If a path length does not fit the weight type.
+     */
+    template <typename T>
+    vector<T> Algorithms::dagLongestPaths(const BasicCSRGraph<T> &g, size_t source)
+    {
+        return dagPaths(g, source, true);
+    }
+
+    template <typename T>
+    vector<T> Algorithms::dagShortestPaths(const BasicGraph<T> &g, size_t source)
+    {
+        return dagPaths(BasicCSRGraph<T>(g), source, false);
+    }
+
+    template <typename T>
+    vector<T> Algorithms::dagLongestPaths(const BasicGraph<T> &g, size_t source)
+    {
+        return dagPaths(BasicCSRGraph<T>(g), source, true);
+    }
+
+    /**
+     * @brief Finds the critical path of a DAG, the heaviest path that starts anywhere.
+     * @param g The graph, e.g. jobs as vertices and durations on the edges leaving them.
+     * @return The vertices of a path of maximum total weight, in order. A graph without edges gives one vertex
+     * and an empty graph none.
+     * @throws invalid_argument If the graph contains a cycle.
+     */
+    template <typename T>
+    vector<size_t> Algorithms::criticalPath(const BasicCSRGraph<T> &g)
+    {
+        typedef typename PathLength<T>::type D;
+        vector<D> dist;
+        vector<size_t> previous;
+        relaxInOrder(g, topologicalSort(g), NO_VERTEX, true, numeric_limits<D>::lowest(), dist, previous);
+        vector<size_t> path;
+        if (dist.empty())
+        {
+            return path;
+        }
+        for (size_t v = max_element(dist.begin(), dist.end()) - dist.begin(); v != NO_VERTEX; v = previous[v])
+        {
+            path.push_back(v);
+        }
+        reverse(path.begin(), path.end());
+        return path;
+    }
+
+    namespace
+    {
+        /**
+         * @brief Disjoint sets with union by size and path halving.
+         */
+        class DisjointSets
+        {
+        public:
+            explicit DisjointSets(size_t n) : parent(n), size(n, 1)
+            {
+                for (size_t v = 0; v < n; ++v)
+                {
+                    parent[v] = v;
+                }
+            }
+
+            size_t find(size_t v)
+            {
+                while (parent[v] != v)
+                {
+                    v = parent[v] = parent[parent[v]];
+                }
+                return v;
+            }
+
+            // Joins the sets of a and b, false if they already were one set
+            bool unite(size_t a, size_t b)
+            {
+                a = find(a);
+                b = find(b);
+                if (a == b)
+                {
+                    return false;
+                }
+                if (size[a] < size[b])
+                {
+                    swap(a, b);
+                }
+                parent[b] = a;
+                size[a] += size[b];
+                return true;
+            }
+
+        private:
+            vector<size_t> parent;
+            vector<size_t> size;
+        };
+
+        template <typename T>
+        struct UndirectedEdge
+        {
+            size_t u; // u < v
+            size_t v;
+            T weight;
+        };
+
+        /**
+         * @brief The undirected weight between two vertices: the lighter of the two directions that are edges.
+         */
+        template <typename T>
+        inline T undirectedWeight(const BasicGraph<T> &g, size_t u, size_t v)
+        {
+            T forward = g.getEdge(u, v), backward = g.getEdge(v, u);
+            if (forward == T(0))
+            {
+                return backward;
+            }
+            return backward == T(0) || forward < backward ? forward : backward;
+        }
+
+        /**
+         * @brief Lists the undirected edges of a graph, every pair of vertices joined in either direction once.
+         */
+        template <typename T>
+        vector<UndirectedEdge<T>> undirectedEdges(const BasicGraph<T> &g)
+        {
+            vector<UndirectedEdge<T>> edges;
+            size_t n = g.getNumVertices();
+            for (size_t u = 0; u < n; ++u)
+            {
+                for (size_t v = u + 1; v < n; ++v)
+                {
+                    T weight = undirectedWeight(g, u, v);
+                    if (weight != T(0))
+                    {
+                        UndirectedEdge<T> edge = {u, v, weight};
+                        edges.push_back(edge);
+                    }
+                }
+            }
+            return edges;
+        }
+
+        /**
+         * @brief Maps a weight to an unsigned key of the same width that sorts in the same order.
+         */
+        template <typename T>
+        inline uint64_t radixKey(T weight, true_type /* floating point */)
+        {
+            uint64_t bits = 0;
+            memcpy(&bits, &weight, sizeof(T));
+            const uint64_t sign = uint64_t(1) << (8 * sizeof(T) - 1);
+            const uint64_t mask = sign | (sign - 1);
+            return (bits & sign) ? ~bits & mask : bits | sign;
+        }
+
+        template <typename T>
+        inline uint64_t radixKey(T weight, false_type /* integral */)
+        {
+            typedef typename make_unsigned<T>::type U;
+            U bits = static_cast<U>(weight);
+            if (numeric_limits<T>::is_signed)
+            {
+                bits ^= static_cast<U>(U(1) << (8 * sizeof(T) - 1));
+            }
+            return bits;
+        }
+
+        /**
+         * @brief Sorts edges by weight with an LSD radix sort, one stable counting pass per byte of the weight.
+         * @details Passes over bytes that are the same for every edge are skipped, so small weights in a wide type
+         * cost few passes.
+         */
+        template <typename T>
+        void radixSortByWeight(vector<UndirectedEdge<T>> &edges)
+        {
+            vector<uint64_t> keys(edges.size());
+            for (size_t i = 0; i < edges.size(); ++i)
+            {
+                keys[i] = radixKey(edges[i].weight, is_floating_point<T>());
+            }
+            vector<UndirectedEdge<T>> edgeBuffer(edges.size());
+            vector<uint64_t> keyBuffer(keys.size());
+            for (size_t shift = 0; shift < 8 * sizeof(T); shift += 8)
+            {
+                size_t count[257] = {0};
+                for (uint64_t key : keys)
+                {
+                    count[((key >> shift) & 0xff) + 1]++;
+                }
+                if (count[((keys.empty() ? 0 : keys[0]) >> shift & 0xff) + 1] == keys.size())
+                {
+                    continue; // every key has the same byte here
+                }
+                for (size_t b = 0; b < 256; ++b)
+                {
+                    count[b + 1] += count[b];
+                }
+                for (size_t i = 0; i < keys.size(); ++i)
+                {
+                    size_t to = count[(keys[i] >> shift) & 0xff]++;
+                    keyBuffer[to] = keys[i];
+                    edgeBuffer[to] = edges[i];
+                }
+                keys.swap(keyBuffer);
+                edges.swap(edgeBuffer);
+            }
+        }
+
+        /**
+         * @brief Builds the result of a spanning forest computation from the chosen edges.
+         */
+        template <typename T>
+        SpanningForest<T> makeForest(size_t n, const vector<UndirectedEdge<T>> &chosen)
+        {
+            typedef typename PathLength<T>::type D;
+            SpanningForest<T> result;
+            result.forest = BasicGraph<T>(static_cast<int>(n));
+            D total = D(0);
+            for (const UndirectedEdge<T> &edge : chosen)
+            {
+                result.forest.setEdge(edge.u, edge.v, edge.weight);
+                result.forest.setEdge(edge.v, edge.u, edge.weight);
+                total += static_cast<D>(edge.weight);
+            }
+            bool fits = true;
+            result.weight = toWeight<T>(total, fits);
+            if (!fits)
+            {
+                throw overflow_error("the weight of the forest does not fit the weight type");
+            }
+            return result;
+        }
+    }
+
+    /**
+     * @brief Computes a minimum spanning forest with Prim's algorithm, suited to dense graphs.
+     * @param g The graph, taken as undirected: u and v are joined if either entry is non-zero, by the lighter one.
+     * @return The forest as a symmetric graph and its total weight, one tree per connected component.
+     * @throws overflow_error If the total weight does not fit the weight type.
+     * @details Every step scans the array of the cheapest known connection of each vertex outside the tree, so the
+     * algorithm takes O(V^2) like reading the matrix does, without a heap.
+     */
+    template <typename T>
+    SpanningForest<T> Algorithms::primSpanningForest(const BasicGraph<T> &g)
+    {
+        size_t n = g.getNumVertices();
+        vector<char> inTree(n, 0);
+        vector<T> cheapest(n, T(0)); // 0 while no connection to the tree is known
+        vector<size_t> parent(n, NO_VERTEX);
+        vector<UndirectedEdge<T>> chosen;
+        size_t nextRoot = 0;
+        for (size_t added = 0; added < n; ++added)
+        {
+            size_t best = NO_VERTEX;
+            for (size_t v = 0; v < n; ++v)
+            {
+                if (!inTree[v] && parent[v] != NO_VERTEX && (best == NO_VERTEX || cheapest[v] < cheapest[best]))
+                {
+                    best = v;
+                }
+            }
+            if (best == NO_VERTEX)
+            {
+                // Nothing else is connected to the current tree, start the next one
+                while (inTree[nextRoot])
+                {
+                    nextRoot++;
+                }
+                best = nextRoot;
+            }
+            else
+            {
+                UndirectedEdge<T> edge = {min(best, parent[best]), max(best, parent[best]), cheapest[best]};
+                chosen.push_back(edge);
+            }
+            inTree[best] = 1;
+            for (size_t v = 0; v < n; ++v)
+            {
+                if (inTree[v])
+                {
+                    continue;
+                }
+                T weight = undirectedWeight(g, best, v);
+                if (weight != T(0) && (parent[v] == NO_VERTEX || weight < cheapest[v]))
+                {
+                    cheapest[v] = weight;
+                    parent[v] = best;
+                }
+            }
+        }
+        return makeForest(n, chosen);
+    }
+
+    /**
+     * @brief Computes a minimum spanning forest with Kruskal's algorithm, suited to sparse graphs.
+     * @param g The graph, taken as undirected like in primSpanningForest.
+     * @return The forest as a symmetric graph and its total weight.
+     * @throws overflow_error If the total weight does not fit the weight type.
+     * @details The edges are radix sorted by weight in O(E) and added from the lightest one whenever they join two
+     * different trees of a union-find structure.
+     */
+    template <typename T>
+    SpanningForest<T> Algorithms::kruskalSpanningForest(const BasicGraph<T> &g)
+    {
+        size_t n = g.getNumVertices();
+        vector<UndirectedEdge<T>> edges = undirectedEdges(g);
+        radixSortByWeight(edges);
+        DisjointSets trees(n);
+        vector<UndirectedEdge<T>> chosen;
+        for (const UndirectedEdge<T> &edge : edges)
+        {
+            if (trees.unite(edge.u, edge.v))
+            {
+                chosen.push_back(edge);
+                if (chosen.size() + 1 == n)
+                {
+                    break;
+                }
+            }
+        }
+        return makeForest(n, chosen);
+    }
+
+    /**
+     * @brief Computes a minimum spanning forest with Borůvka's algorithm on several threads.
+     * @param g The graph, taken as undirected like in primSpanningForest.
+     * @param threads The number of threads to use, 0 for the hardware concurrency.
+     * @return The forest as a symmetric graph and its total weight.
+     * @throws overflow_error If the total weight does not fit the weight type.
+     * @details In every round the threads scan slices of the edge list and each tree keeps its lightest
+     * outgoing edge with an atomic compare-and-swap, ties broken by position so the choice is deterministic
+     * and never closes a cycle. All those edges are added at once, which at least halves the number of trees, and
+     * the edges inside a tree are dropped, so O(log V) rounds do the job.
+     */
+    template <typename T>
+    SpanningForest<T> Algorithms::boruvkaSpanningForest(const BasicGraph<T> &g, size_t threads)
+    {
+        size_t n = g.getNumVertices();
+        vector<UndirectedEdge<T>> edges = undirectedEdges(g);
+        vector<size_t> tree(n);
+        for (size_t v = 0; v < n; ++v)
+        {
+            tree[v] = v;
+        }
+        DisjointSets trees(n);
+        vector<UndirectedEdge<T>> chosen;
+        unique_ptr<atomic<size_t>[]> lightest(new atomic<size_t>[n]);
+        while (!edges.empty())
+        {
+            for (size_t v = 0; v < n; ++v)
+            {
+                lightest[v].store(NO_VERTEX, memory_order_relaxed);
+            }
+            auto lighter = [&edges](size_t a, size_t b)
+            {
+                return edges[a].weight < edges[b].weight || (!(edges[b].weight < edges[a].weight) && a < b);
+            };
+            auto offer = [&](size_t t, size_t e)
+            {
+                size_t current = lightest[t].load(memory_order_relaxed);
+                while ((current == NO_VERTEX || lighter(e, current)) &&
+                       !lightest[t].compare_exchange_weak(current, e, memory_order_relaxed))
+                {
+                }
+            };
+            size_t slices = 4 * workerCount(threads);
+            size_t slice = (edges.size() + slices - 1) / slices;
+            parallelFor(0, slices, [&](size_t s)
+                        {
+                            size_t end = min(edges.size(), (s + 1) * slice);
+                            for (size_t e = s * slice; e < end; ++e)
+                            {
+                                offer(tree[edges[e].u], e);
+                                offer(tree[edges[e].v], e);
+                            }
+                        },
+                        edges.size() < 4096 ? 1 : threads);
+
+            for (size_t t = 0; t < n; ++t)
+            {
+                size_t e = lightest[t].load(memory_order_relaxed);
+                if (e != NO_VERTEX && trees.unite(edges[e].u, edges[e].v))
+                {
+                    chosen.push_back(edges[e]);
+                }
+            }
+            for (size_t v = 0; v < n; ++v)
+            {
+                tree[v] = trees.find(v);
+            }
+            edges.erase(remove_if(edges.begin(), edges.end(), [&tree](const UndirectedEdge<T> &edge)
+                                  { return tree[edge.u] == tree[edge.v]; }),
+                        edges.end());
+        }
+        return makeForest(n, chosen);
+    }
+
+    namespace
+    {
+        /**
+         * @brief The type excesses and flow values are summed in, wide for integers so that they cannot overflow.
+         */
+        template <typename T>
+        struct FlowSum
+        {
+            typedef typename conditional<is_floating_point<T>::value, T, typename PathLength<T>::type>::type type;
+        };
+
+        /**
+         * @brief The residual network of a flow problem in CSR form.
+         * @details Every edge u -> v of the network becomes an arc of u with the capacity of the edge and a paired
+         * arc of v with capacity 0, and pushing along an arc moves capacity to its pair. The arcs of a vertex are
+         * contiguous, so scanning them reads memory sequentially.
+         */
+        template <typename T>
+        struct Residual
+        {
+            vector<size_t> first;   // the arcs of v are first[v] .. first[v + 1] - 1
+            vector<size_t> head;    // the vertex an arc points to
+            vector<size_t> pair;    // the opposite arc
+            vector<T> capacity;     // the residual capacity
+            vector<size_t> arcOf;   // the forward arc of every edge, NO_VERTEX for self-loops
+
+            Residual(const BasicCSRGraph<T> &g, size_t source, size_t sink)
+            {
+                size_t n = g.getNumVertices();
+                if (source >= n || sink >= n || source == sink)
+                {
+                    throw invalid_argument("the source and the sink must be two different vertices of the graph");
+                }
+                const vector<size_t> &offsets = g.getOffsets();
+                const vector<size_t> &targets = g.getTargets();
+                const vector<T> &weights = g.getWeights();
+                vector<size_t> degree(n + 1, 0);
+                for (size_t u = 0; u < n; ++u)
+                {
+                    for (size_t e = offsets[u]; e < offsets[u + 1]; ++e)
+                    {
+                        if (weights[e] < T(0))
+                        {
+                            throw invalid_argument("capacities must not be negative");
+                        }
+                        if (targets[e] != u)
+                        {
+                            degree[u]++;
+                            degree[targets[e]]++;
+                        }
+                    }
+                }
+                first.assign(n + 1, 0);
+                for (size_t v = 0; v < n; ++v)
+                {
+                    first[v + 1] = first[v] + degree[v];
+                }
+                vector<size_t> fill(first.begin(), first.end() - 1);
+                head.resize(first[n]);
+                pair.resize(first[n]);
+                capacity.resize(first[n]);
+                arcOf.assign(targets.size(), NO_VERTEX);
+                for (size_t u = 0; u < n; ++u)
+                {
+                    for (size_t e = offsets[u]; e < offsets[u + 1]; ++e)
+                    {
+                        size_t v = targets[e];
+                        if (v == u)
+                        {
+                            continue;
+                        }
+                        size_t forward = fill[u]++, backward = fill[v]++;
+                        head[forward] = v;
+                        head[backward] = u;
+                        pair[forward] = backward;
+                        pair[backward] = forward;
+                        capacity[forward] = weights[e];
+                        capacity[backward] = T(0);
+                        arcOf[e] = forward;
+                    }
+                }
+            }
+
+            size_t numVertices() const
+            {
+                return first.size() - 1;
+            }
+
+            /**
+             * @brief Collects the result once the residual network holds a maximum flow.
+             * @details The source side of the minimum cut is everything the source still reaches through arcs
+             * with residual capacity.
+             */
+            MaximumFlow<T> result(const BasicCSRGraph<T> &g, size_t source, typename FlowSum<T>::type value) const
+            {
+                if (value > static_cast<typename FlowSum<T>::type>(numeric_limits<T>::max()))
+                {
+                    throw overflow_error("the value of the flow does not fit the weight type");
+                }
+                MaximumFlow<T> flow;
+                flow.value = static_cast<T>(value);
+                const vector<T> &weights = g.getWeights();
+                flow.edgeFlow.assign(weights.size(), T(0));
+                for (size_t e = 0; e < weights.size(); ++e)
+                {
+                    if (arcOf[e] != NO_VERTEX)
+                    {
+                        flow.edgeFlow[e] = static_cast<T>(weights[e] - capacity[arcOf[e]]);
+                    }
+                }
+                flow.sourceSide.assign(numVertices(), false);
+                vector<size_t> queue(1, source);
+                flow.sourceSide[source] = true;
+                for (size_t i = 0; i < queue.size(); ++i)
+                {
+                    size_t u = queue[i];
+                    for (size_t a = first[u]; a < first[u + 1]; ++a)
+                    {
+                        if (capacity[a] > T(0) && !flow.sourceSide[head[a]])
+                        {
+                            flow.sourceSide[head[a]] = true;
+                            queue.push_back(head[a]);
+                        }
+                    }
+                }
+                return flow;
+            }
+        };
+
+        /**
+         * @brief Highest-label push-relabel with the global relabeling and gap heuristics.
+         * @details Labels below n estimate the distance to the sink and labels from n on the distance back to the
+         * source, so a single run turns the preflow into a flow. Active vertices wait in one bucket per label and the
+         * highest one is discharged first. All vertices are also kept in doubly linked lists per label: when the
+         * last vertex leaves a label below n, nothing above it can reach the sink any more and the whole range is
+         * lifted to n at once. Every O(n + m) units of work the labels are reset to exact residual distances with
+         * two backward breadth-first searches.
+         */
+        template <typename T>
+        class PushRelabel
+        {
+        public:
+            typedef typename FlowSum<T>::type S;
+
+            PushRelabel(Residual<T> &network, size_t source, size_t sink)
+                : r(network), n(network.numVertices()), source(source), sink(sink), label(n, 0), excess(n, S(0)),
+                  current(network.first.begin(), network.first.end() - 1), active(2 * n + 1), next(n), previous(n),
+                  members(2 * n + 1, NO_VERTEX), highest(0)
+            {
+            }
+
+            S run()
+            {
+                for (size_t a = r.first[source]; a < r.first[source + 1]; ++a)
+                {
+                    T delta = r.capacity[a];
+                    if (delta > T(0))
+                    {
+                        r.capacity[a] -= delta;
+                        r.capacity[r.pair[a]] += delta;
+                        excess[r.head[a]] += delta;
+                        excess[source] -= delta;
+                    }
+                }
+                globalRelabel();
+                size_t work = 0;
+                const size_t relabelEvery = 6 * n + r.head.size();
+                while (true)
+                {
+                    while (highest > 0 && active[highest].empty())
+                    {
+                        highest--;
+                    }
+                    if (active[highest].empty())
+                    {
+                        break;
+                    }
+                    size_t u = active[highest].back();
+                    active[highest].pop_back();
+                    if (label[u] != highest || excess[u] <= S(0))
+                    {
+                        continue; // lifted by a gap or a global relabel since it was queued
+                    }
+                    work += discharge(u);
+                    if (work > relabelEvery)
+                    {
+                        globalRelabel();
+                        work = 0;
+                    }
+                }
+                return excess[sink];
+            }
+
+        private:
+            Residual<T> &r;
+            size_t n;
+            size_t source;
+            size_t sink;
+            vector<size_t> label;
+            vector<S> excess;
+            vector<size_t> current;         // the arc discharge continues from
+            vector<vector<size_t>> active;  // the vertices with excess, by label, may hold stale entries
+            vector<size_t> next;            // the lists of all vertices by label
+            vector<size_t> previous;
+            vector<size_t> members;         // the first vertex of every label
+            size_t highest;                 // no active bucket above it is non-empty
+
+            void link(size_t v)
+            {
+                size_t k = label[v];
+                previous[v] = NO_VERTEX;
+                next[v] = members[k];
+                if (members[k] != NO_VERTEX)
+                {
+                    previous[members[k]] = v;
+                }
+                members[k] = v;
+            }
+
+            void unlink(size_t v)
+            {
+                if (previous[v] != NO_VERTEX)
+                {
+                    next[previous[v]] = next[v];
+                }
+                else
+                {
+                    members[label[v]] = next[v];
+                }
+                if (next[v] != NO_VERTEX)
+                {
+                    previous[next[v]] = previous[v];
+                }
+            }
+
+            void activate(size_t v)
+            {
+                active[label[v]].push_back(v);
+                highest = max(highest, label[v]);
+            }
+
+            /**
+             * @brief Pushes the excess of a vertex along admissible arcs, relabeling it whenever they run out.
+             * @return The amount of work done, in arcs scanned.
+             */
+            size_t discharge(size_t u)
+            {
+                size_t work = 0;
+                size_t end = r.first[u + 1];
+                while (excess[u] > S(0))
+                {
+                    size_t a = current[u];
+                    if (a == end)
+                    {
+                        work += relabel(u);
+                        if (label[u] >= 2 * n)
+                        {
+                            break;
+                        }
+                        continue;
+                    }
+                    size_t v = r.head[a];
+                    if (r.capacity[a] > T(0) && label[u] == label[v] + 1)
+                    {
+                        T delta = excess[u] < static_cast<S>(r.capacity[a]) ? static_cast<T>(excess[u]) : r.capacity[a];
+                        r.capacity[a] -= delta;
+                        r.capacity[r.pair[a]] += delta;
+                        excess[u] -= delta;
+                        if (excess[v] <= S(0) && v != source && v != sink)
+                        {
+                            excess[v] += delta;
+                            activate(v);
+                        }
+                        else
+                        {
+                            excess[v] += delta;
+                        }
+                        if (excess[u] <= S(0))
+                        {
+                            break; // the arc may still have capacity, discharge resumes from it
+                        }
+                    }
+                    current[u]++;
+                }
+                return work;
+            }
+
+            /**
+             * @brief Lifts a vertex just above its lowest residual neighbor, applying the gap heuristic.
+             * @return The amount of work done.
+             */
+            size_t relabel(size_t u)
+            {
+                size_t lowest = 2 * n, lowestArc = r.first[u];
+                for (size_t a = r.first[u]; a < r.first[u + 1]; ++a)
+                {
+                    if (r.capacity[a] > T(0) && label[r.head[a]] + 1 < lowest)
+                    {
+                        lowest = label[r.head[a]] + 1;
+                        lowestArc = a;
+                    }
+                }
+                size_t old = label[u];
+                unlink(u);
+                label[u] = lowest;
+                current[u] = lowestArc;
+                if (old < n && members[old] == NO_VERTEX)
+                {
+                    // The gap: u and everything between old and n can no longer reach the sink
+                    if (label[u] < n)
+                    {
+                        label[u] = n;
+                        current[u] = r.first[u];
+                    }
+                    for (size_t k = old + 1; k < n && members[k] != NO_VERTEX; ++k)
+                    {
+                        while (members[k] != NO_VERTEX)
+                        {
+                            size_t v = members[k];
+                            unlink(v);
+                            label[v] = n;
+                            current[v] = r.first[v];
+                            link(v);
+                            if (excess[v] > S(0))
+                            {
+                                activate(v);
+                            }
+                        }
+                    }
+                }
+                link(u);
+                if (label[u] < 2 * n)
+                {
+                    activate(u);
+                }
+                return r.first[u + 1] - r.first[u] + 12;
+            }
+
+            /**
+             * @brief Sets every label to the exact residual distance to the sink, or to n plus the one to the source.
+             */
+            void globalRelabel()
+            {
+                const size_t unlabeled = 2 * n;
+                fill(label.begin(), label.end(), unlabeled);
+                fill(members.begin(), members.end(), NO_VERTEX);
+                for (vector<size_t> &bucket : active)
+                {
+                    bucket.clear();
+                }
+                highest = 0;
+                vector<size_t> queue;
+                queue.reserve(n);
+                label[sink] = 0;
+                queue.push_back(sink);
+                label[source] = n;
+                for (int side = 0; side < 2; ++side)
+                {
+                    if (side == 1)
+                    {
+                        queue.push_back(source);
+                    }
+                    for (size_t i = side == 0 ? 0 : queue.size() - 1; i < queue.size(); ++i)
+                    {
+                        size_t w = queue[i];
+                        for (size_t a = r.first[w]; a < r.first[w + 1]; ++a)
+                        {
+                            size_t v = r.head[a];
+                            if (label[v] == unlabeled && r.capacity[r.pair[a]] > T(0))
+                            {
+                                label[v] = label[w] + 1;
+                                queue.push_back(v);
+                            }
+                        }
+                    }
+                }
+                for (size_t v = 0; v < n; ++v)
+                {
+                    current[v] = r.first[v];
+                    link(v);
+                    if (v != source && v != sink && excess[v] > S(0) && label[v] < unlabeled)
+                    {
+                        activate(v);
+                    }
+                }
+            }
+        };
+
+        /**
+         * @brief Dinic's algorithm: blocking flows along the breadth-first levels of the residual network.
+         * @details The depth-first search for augmenting paths is iterative with a current arc per vertex, so each
+         * phase costs O(nm) at most and a dead end is never scanned twice within a phase.
+         */
+        template <typename T>
+        typename FlowSum<T>::type dinic(Residual<T> &r, size_t source, size_t sink)
+        {
+            typedef typename FlowSum<T>::type S;
+            const size_t n = r.numVertices();
+            vector<size_t> level(n), current(n), path, queue;
+            S total = S(0);
+            while (true)
+            {
+                fill(level.begin(), level.end(), NO_VERTEX);
+                level[source] = 0;
+                queue.assign(1, source);
+                for (size_t i = 0; i < queue.size() && level[sink] == NO_VERTEX; ++i)
+                {
+                    size_t u = queue[i];
+                    for (size_t a = r.first[u]; a < r.first[u + 1]; ++a)
+                    {
+                        if (r.capacity[a] > T(0) && level[r.head[a]] == NO_VERTEX)
+                        {
+                            level[r.head[a]] = level[u] + 1;
+                            queue.push_back(r.head[a]);
+                        }
+                    }
+                }
+                if (level[sink] == NO_VERTEX)
+                {
+                    return total;
+                }
+                copy(r.first.begin(), r.first.end() - 1, current.begin());
+                path.clear();
+                size_t u = source;
+                while (true)
+                {
+                    if (u == sink)
+                    {
+                        T bottleneck = r.capacity[path[0]];
+                        for (size_t a : path)
+                        {
+                            bottleneck = min(bottleneck, r.capacity[a]);
+                        }
+                        size_t cut = path.size();
+                        for (size_t i = 0; i < path.size(); ++i)
+                        {
+                            r.capacity[path[i]] -= bottleneck;
+                            r.capacity[r.pair[path[i]]] += bottleneck;
+                            if (cut == path.size() && !(r.capacity[path[i]] > T(0)))
+                            {
+                                cut = i;
+                            }
+                        }
+                        total += bottleneck;
+                        path.resize(cut); // continue from the tail of the first saturated arc
+                        u = path.empty() ? source : r.head[path.back()];
+                        continue;
+                    }
+                    size_t end = r.first[u + 1];
+                    while (current[u] < end &&
+                           !(r.capacity[current[u]] > T(0) && level[r.head[current[u]]] == level[u] + 1))
+                    {
+                        current[u]++;
+                    }
+                    if (current[u] < end)
+                    {
+                        path.push_back(current[u]);
+                        u = r.head[current[u]];
+                        continue;
+                    }
+                    // A dead end, retreat and never come back to u in this phase
+                    level[u] = NO_VERTEX;
+                    if (path.empty())
+                    {
+                        break;
+                    }
+                    path.pop_back();
+                    u = path.empty() ? source : r.head[path.back()];
+                    current[u]++;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Computes a maximum flow with the highest-label push-relabel algorithm.
+     * @param g The network, the weight of every edge is its capacity.
+     * @param source The vertex the flow leaves.
+     * @param sink The vertex the flow enters.
+     * @return The value of the flow, the flow on every edge of g in the order of its CSR edges, and the source
+     * side of a minimum cut.
+     * @throws invalid_argument If the source or the sink is not a vertex, they are equal, or a capacity is negative.
+     * @throws overflow_error If the value of the flow does not fit the weight type.
+     * @details Runs in O(n^2 sqrt(m)) and is usually the fastest choice on large or dense networks.
+     */
+    template <typename T>
+    MaximumFlow<T> Algorithms::maxFlowPushRelabel(const BasicCSRGraph<T> &g, size_t source, size_t sink)
+    {
+        Residual<T> network(g, source, sink);
+        typename FlowSum<T>::type value = PushRelabel<T>(network, source, sink).run();
+        return network.result(g, source, value);
+    }
+
+    /**
+     * @brief Computes a maximum flow with the push-relabel algorithm on the CSR form of a dense graph.
+     * @details The edge flows follow the order of BasicCSRGraph<T>(g), i.e. the non-zero entries row by row.
+     */
+    template <typename T>
+    MaximumFlow<T> Algorithms::maxFlowPushRelabel(const BasicGraph<T> &g, size_t source, size_t sink)
+    {
+        return maxFlowPushRelabel(BasicCSRGraph<T>(g), source, sink);
+    }
+
+    /**
+     * @brief Computes a maximum flow with Dinic's algorithm.
+     * @param g The network, the weight of every edge is its capacity.
+     * @param source The vertex the flow leaves.
+     * @param sink The vertex the flow enters.
+     * @return The same as maxFlowPushRelabel, though the edge flows may differ when there are several maximum flows.
+     * @throws invalid_argument If the source or the sink is not a vertex, they are equal, or a capacity is negative.
+     * @throws overflow_error If the value of the flow does not fit the weight type.
+     * @details Runs in O(n^2 m), and in O(m sqrt(n)) on unit capacity networks such as matchings.
+     */
+    template <typename T>
+    MaximumFlow<T> Algorithms::maxFlowDinic(const BasicCSRGraph<T> &g, size_t source, size_t sink)
+    {
+        Residual<T> network(g, source, sink);
+        typename FlowSum<T>::type value = dinic(network, source, sink);
+        return network.result(g, source, value);
+    }
+
+    /**
+     * @brief Computes a maximum flow with Dinic's algorithm on the CSR form of a dense graph.
+     */
+    template <typename T>
+    MaximumFlow<T> Algorithms::maxFlowDinic(const BasicGraph<T> &g, size_t source, size_t sink)
+    {
+        return maxFlowDinic(BasicCSRGraph<T>(g), source, sink);
+    }
+
+    namespace
+    {
+        /**
+         * @brief The edges of a bipartite graph from one side to the other, both sides numbered from 0.
+         */
+        struct BipartiteAdjacency
+        {
+            vector<size_t> partA;    // the vertex of the graph behind every index of a side
+            vector<size_t> partB;
+            vector<size_t> first;    // the neighbors of a are adjacent[first[a]] .. adjacent[first[a + 1] - 1]
+            vector<size_t> adjacent;
+
+            size_t sizeA() const
+            {
+                return partA.size();
+            }
+        };
+
+        /**
+         * @brief Builds the adjacency of the side A of a graph taken as undirected, each neighbor listed once.
+         * @throws invalid_argument If the graph is not bipartite.
+         */
+        template <typename T>
+        BipartiteAdjacency bipartiteAdjacency(const BasicCSRGraph<T> &g)
+        {
+            BipartiteAdjacency sides;
+            if (!Algorithms::bipartition(g, sides.partA, sides.partB))
+            {
+                throw invalid_argument("the graph is not bipartite");
+            }
+            vector<size_t> local(g.getNumVertices());
+            for (size_t b = 0; b < sides.partB.size(); ++b)
+            {
+                local[sides.partB[b]] = b;
+            }
+            BasicCSRGraph<T> reversed = g.transpose();
+            const BasicCSRGraph<T> *directions[] = {&g, &reversed};
+            vector<size_t> seen(sides.partB.size(), NO_VERTEX);
+            sides.first.assign(1, 0);
+            for (size_t a = 0; a < sides.sizeA(); ++a)
+            {
+                size_t u = sides.partA[a];
+                for (const BasicCSRGraph<T> *direction : directions)
+                {
+                    const vector<size_t> &offsets = direction->getOffsets();
+                    const vector<size_t> &targets = direction->getTargets();
+                    for (size_t e = offsets[u]; e < offsets[u + 1]; ++e)
+                    {
+                        size_t b = local[targets[e]];
+                        if (seen[b] != a)
+                        {
+                            seen[b] = a;
+                            sides.adjacent.push_back(b);
+                        }
+                    }
+                }
+                sides.first.push_back(sides.adjacent.size());
+            }
+            return sides;
+        }
+
+        /**
+         * @brief Grows a matching to a maximum one with the Hopcroft-Karp algorithm.
+         * @param sides The bipartite graph.
+         * @param mateA The partner of every vertex of A, NO_VERTEX if free, updated in place.
+         * @param mateB The partner of every vertex of B, updated in place.
+         * @details Every phase layers the graph with a breadth-first search from the free vertices of A and then
+         * augments along a maximal set of vertex-disjoint shortest augmenting paths, found by iterative depth-first
+         * searches that never revisit a dead end. O(sqrt(V)) phases suffice, O(E sqrt(V)) in total.
+         */
+        void hopcroftKarp(const BipartiteAdjacency &sides, vector<size_t> &mateA, vector<size_t> &mateB)
+        {
+            size_t sizeA = sides.sizeA();
+            vector<size_t> layer(sizeA), current(sizeA), queue, stack;
+            queue.reserve(sizeA);
+            while (true)
+            {
+                queue.clear();
+                for (size_t a = 0; a < sizeA; ++a)
+                {
+                    layer[a] = mateA[a] == NO_VERTEX ? 0 : NO_VERTEX;
+                    if (layer[a] == 0)
+                    {
+                        queue.push_back(a);
+                    }
+                }
+                size_t freeLayer = NO_VERTEX; // the layer the shortest augmenting paths end in
+                for (size_t i = 0; i < queue.size() && layer[queue[i]] <= freeLayer; ++i)
+                {
+                    size_t a = queue[i];
+                    for (size_t e = sides.first[a]; e < sides.first[a + 1]; ++e)
+                    {
+                        size_t partner = mateB[sides.adjacent[e]];
+                        if (partner == NO_VERTEX)
+                        {
+                            freeLayer = layer[a];
+                        }
+                        else if (layer[partner] == NO_VERTEX)
+                        {
+                            layer[partner] = layer[a] + 1;
+                            queue.push_back(partner);
+                        }
+                    }
+                }
+                if (freeLayer == NO_VERTEX)
+                {
+                    return;
+                }
+
+                copy(sides.first.begin(), sides.first.end() - 1, current.begin());
+                for (size_t root = 0; root < sizeA; ++root)
+                {
+                    if (mateA[root] != NO_VERTEX || layer[root] != 0)
+                    {
+                        continue;
+                    }
+                    stack.assign(1, root);
+                    while (!stack.empty())
+                    {
+                        size_t a = stack.back();
+                        if (current[a] == sides.first[a + 1])
+                        {
+                            layer[a] = NO_VERTEX; // a dead end for the rest of the phase
+                            stack.pop_back();
+                            if (!stack.empty())
+                            {
+                                current[stack.back()]++;
+                            }
+                            continue;
+                        }
+                        size_t b = sides.adjacent[current[a]];
+                        size_t partner = mateB[b];
+                        if (partner == NO_VERTEX)
+                        {
+                            // Flip the path: every vertex of A on the stack takes the B vertex it points at
+                            for (size_t onPath : stack)
+                            {
+                                size_t taken = sides.adjacent[current[onPath]];
+                                mateA[onPath] = taken;
+                                mateB[taken] = onPath;
+                                layer[onPath] = NO_VERTEX;
+                            }
+                            break;
+                        }
+                        if (layer[partner] == layer[a] + 1)
+                        {
+                            stack.push_back(partner);
+                        }
+                        else
+                        {
+                            current[a]++;
+                        }
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief Matches every vertex of A to its first free neighbor, the usual start for Hopcroft-Karp.
+         */
+        void greedyMatching(const BipartiteAdjacency &sides, vector<size_t> &mateA, vector<size_t> &mateB)
+        {
+            for (size_t a = 0; a < sides.sizeA(); ++a)
+            {
+                for (size_t e = sides.first[a]; e < sides.first[a + 1]; ++e)
+                {
+                    if (mateB[sides.adjacent[e]] == NO_VERTEX)
+                    {
+                        mateA[a] = sides.adjacent[e];
+                        mateB[sides.adjacent[e]] = a;
+                        break;
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief A matching found by the double-push push-relabel algorithm, run on several threads.
+         * @details Every free vertex of A takes the neighbor with the lowest label, displacing its partner, which
+         * becomes free, and raises the label of that neighbor to the second lowest one plus two. A vertex whose
+         * neighbors all reach the label bound cannot be matched any more and drops out. Each round handles all free
+         * vertices at once; the partners are swapped atomically, so concurrent claims on one vertex only displace
+         * each other. Labels read during a race may be stale, which can drop a vertex too early, so the result is a
+         * near-maximum matching that hopcroftKarp completes.
+         */
+        void pushRelabelMatching(const BipartiteAdjacency &sides, vector<size_t> &mateA, vector<size_t> &mateB,
+                                 size_t threads)
+        {
+            size_t sizeA = sides.sizeA(), sizeB = sides.partB.size();
+            const size_t bound = sizeA + sizeB;
+            unique_ptr<atomic<size_t>[]> mate(new atomic<size_t>[sizeB]);
+            unique_ptr<atomic<size_t>[]> label(new atomic<size_t>[sizeB]);
+            for (size_t b = 0; b < sizeB; ++b)
+            {
+                mate[b].store(NO_VERTEX, memory_order_relaxed);
+                label[b].store(0, memory_order_relaxed);
+            }
+            vector<size_t> active;
+            for (size_t a = 0; a < sizeA; ++a)
+            {
+                if (sides.first[a] < sides.first[a + 1])
+                {
+                    active.push_back(a);
+                }
+            }
+            size_t workers = workerCount(threads);
+            vector<vector<size_t>> displaced(workers);
+            while (!active.empty())
+            {
+                size_t chunk = (active.size() + workers - 1) / workers;
+                parallelFor(0, workers, [&](size_t w)
+                            {
+                                size_t end = min(active.size(), (w + 1) * chunk);
+                                for (size_t i = w * chunk; i < end; ++i)
+                                {
+                                    size_t a = active[i];
+                                    size_t lowest = NO_VERTEX, lowestLabel = bound, secondLabel = bound;
+                                    for (size_t e = sides.first[a]; e < sides.first[a + 1]; ++e)
+                                    {
+                                        size_t b = sides.adjacent[e];
+                                        size_t l = label[b].load(memory_order_relaxed);
+                                        if (l < lowestLabel)
+                                        {
+                                            secondLabel = lowestLabel;
+                                            lowestLabel = l;
+                                            lowest = b;
+                                        }
+                                        else if (l < secondLabel)
+                                        {
+                                            secondLabel = l;
+                                        }
+                                    }
+                                    if (lowest == NO_VERTEX)
+                                    {
+                                        continue;
+                                    }
+                                    size_t previous = mate[lowest].exchange(a, memory_order_relaxed);
+                                    size_t raised = min(bound, secondLabel + 2), seen = label[lowest].load(memory_order_relaxed);
+                                    while (seen < raised &&
+                                           !label[lowest].compare_exchange_weak(seen, raised, memory_order_relaxed))
+                                    {
+                                    }
+                                    if (previous != NO_VERTEX)
+                                    {
+                                        displaced[w].push_back(previous);
+                                    }
+                                }
+                            },
+                            active.size() < 4096 ? 1 : workers);
+                active.clear();
+                for (vector<size_t> &list : displaced)
+                {
+                    active.insert(active.end(), list.begin(), list.end());
+                    list.clear();
+                }
+            }
+            for (size_t b = 0; b < sizeB; ++b)
+            {
+                mateB[b] = mate[b].load(memory_order_relaxed);
+                if (mateB[b] != NO_VERTEX)
+                {
+                    mateA[mateB[b]] = b;
+                }
+            }
+        }
+
+        /**
+         * @brief Lists a matching as pairs of original vertices, ordered by the vertex of A.
+         */
+        vector<pair<size_t, size_t>> matchedPairs(const BipartiteAdjacency &sides, const vector<size_t> &mateA)
+        {
+            vector<pair<size_t, size_t>> pairs;
+            for (size_t a = 0; a < sides.sizeA(); ++a)
+            {
+                if (mateA[a] != NO_VERTEX)
+                {
+                    pairs.push_back(make_pair(sides.partA[a], sides.partB[mateA[a]]));
+                }
+            }
+            sort(pairs.begin(), pairs.end());
+            return pairs;
+        }
+    }
+
+    /**
+     * @brief Computes a maximum cardinality matching of a bipartite graph with the Hopcroft-Karp algorithm.
+     * @param g The graph, taken as undirected.
+     * @return The matched pairs, the first vertex of each in the side A of bipartition, ordered by it.
+     * @throws invalid_argument If the graph is not bipartite.
+     */
+    template <typename T>
+    vector<pair<size_t, size_t>> Algorithms::maximumMatching(const BasicCSRGraph<T> &g)
+    {
+        BipartiteAdjacency sides = bipartiteAdjacency(g);
+        vector<size_t> mateA(sides.sizeA(), NO_VERTEX), mateB(sides.partB.size(), NO_VERTEX);
+        greedyMatching(sides, mateA, mateB);
+        hopcroftKarp(sides, mateA, mateB);
+        return matchedPairs(sides, mateA);
+    }
+
+    /**
+     * @brief Computes a maximum cardinality matching of a dense bipartite graph, see the CSR version.
+     */
+    template <typename T>
+    vector<pair<size_t, size_t>> Algorithms::maximumMatching(const BasicGraph<T> &g)
+    {
+        return maximumMatching(BasicCSRGraph<T>(g));
+    }
+
+    /**
+     * @brief Computes a maximum cardinality matching of a large bipartite graph with a parallel push-relabel.
+     * @param g The graph, taken as undirected.
+     * @param threads The number of threads to use, 0 for the hardware concurrency.
+     * @return The same as maximumMatching, though the pairs may differ when there are several maximum matchings.
+     * @throws invalid_argument If the graph is not bipartite.
+     * @details The push-relabel rounds find nearly all of the matching in parallel, and a final Hopcroft-Karp
+     * pass, usually a single breadth-first search, adds whatever the races between threads left out.
+     */
+    template <typename T>
+    vector<pair<size_t, size_t>> Algorithms::maximumMatchingPushRelabel(const BasicCSRGraph<T> &g, size_t threads)
+    {
+        BipartiteAdjacency sides = bipartiteAdjacency(g);
+        vector<size_t> mateA(sides.sizeA(), NO_VERTEX), mateB(sides.partB.size(), NO_VERTEX);
+        pushRelabelMatching(sides, mateA, mateB, threads);
+        hopcroftKarp(sides, mateA, mateB);
+        return matchedPairs(sides, mateA);
+    }
+
+    namespace
+    {
+        // Below this many vertices per thread PageRank iterations run on the calling thread alone.
+        const size_t PAGERANK_CHUNK = 4096;
+
+        void checkDamping(double damping)
+        {
+            if (!(damping >= 0 && damping < 1))
+            {
+                throw invalid_argument("the damping factor must be in [0, 1)");
+            }
+        }
+    }
+
+    /**
+     * @brief Computes the PageRank of every vertex by power iteration.
+     * @param g The graph, every edge counts once whatever its weight.
+     * @param options The damping factor, the convergence tolerance, the iteration limit and the thread count.
+     * @return The rank of every vertex, the ranks sum to 1.
+     * @throws invalid_argument If the damping factor is not in [0, 1).
+     * @details Every iteration pulls the ranks over the transposed graph: a first pass divides each rank by the
+     * out-degree, and a second one sums those contributions over the in-edges of every vertex. Each vertex is
+     * written by a single thread, without atomics, and both passes are plain loops over arrays of R, so float
+     * ranks halve the memory traffic and double the SIMD width. The rank of vertices without out-edges is spread
+     * over all vertices. The threads work on contiguous vertex ranges and add up their share of the change,
+     * which stops the iterations once it drops below the tolerance.
+     */
+    template <typename R, typename T>
+    vector<R> Algorithms::pageRank(const BasicCSRGraph<T> &g, const PageRankOptions &options)
+    {
+        checkDamping(options.damping);
+        size_t numVertices = g.getNumVertices();
+        if (numVertices == 0)
+        {
+            return vector<R>();
+        }
+        BasicCSRGraph<T> reversed = g.transpose();
+        const vector<size_t> &inOffsets = reversed.getOffsets();
+        const vector<size_t> &sources = reversed.getTargets();
+
+        vector<R> inverseDegree(numVertices), rank(numVertices, R(1) / R(numVertices));
+        vector<R> contribution(numVertices), next(numVertices);
+        for (size_t v = 0; v < numVertices; ++v)
+        {
+            size_t degree = g.degree(v);
+            inverseDegree[v] = degree == 0 ? R(0) : R(1) / R(degree);
+        }
+        const R damping = static_cast<R>(options.damping);
+        size_t workers = max<size_t>(1, min(workerCount(options.threads), numVertices / PAGERANK_CHUNK));
+        size_t chunk = (numVertices + workers - 1) / workers;
+        vector<double> dangling(workers), change(workers);
+        for (size_t iteration = 0; iteration < options.maxIterations; ++iteration)
+        {
+            parallelFor(0, workers, [&](size_t w)
+                        {
+                            size_t end = min(numVertices, (w + 1) * chunk);
+                            double lost = 0;
+                            for (size_t v = w * chunk; v < end; ++v)
+                            {
+                                contribution[v] = rank[v] * inverseDegree[v];
+                                lost += inverseDegree[v] == R(0) ? static_cast<double>(rank[v]) : 0.0;
+                            }
+                            dangling[w] = lost;
+                        },
+                        workers);
+            double lost = 0;
+            for (double part : dangling)
+            {
+                lost += part;
+            }
+            const R base = static_cast<R>(((1 - options.damping) + options.damping * lost) / numVertices);
+            parallelFor(0, workers, [&](size_t w)
+                        {
+                            size_t end = min(numVertices, (w + 1) * chunk);
+                            double moved = 0;
+                            for (size_t v = w * chunk; v < end; ++v)
+                            {
+                                R sum = R(0);
+                                for (size_t e = inOffsets[v]; e < inOffsets[v + 1]; ++e)
+                                {
+                                    sum += contribution[sources[e]];
+                                }
+                                next[v] = base + damping * sum;
+                                moved += fabs(static_cast<double>(next[v] - rank[v]));
+                            }
+                            change[w] = moved;
+                        },
+                        workers);
+            rank.swap(next);
+            double moved = 0;
+            for (double part : change)
+            {
+                moved += part;
+            }
+            if (moved < options.tolerance)
+            {
+                break;
+            }
+        }
+        return rank;
+    }
+
+    /**
+     * @brief Computes the PageRank of every vertex of a dense graph, see the CSR version.
+     */
+    template <typename R, typename T>
+    vector<R> Algorithms::pageRank(const BasicGraph<T> &g, const PageRankOptions &options)
+    {
+        return pageRank<R>(BasicCSRGraph<T>(g), options);
+    }
+
+    /**
+     * @brief Approximates the PageRank personalized to one seed vertex by pushing residual probability.
+     * @param g The graph, every edge counts once whatever its weight.
+     * @param seed The vertex the random walk restarts from.
+     * @param options The damping factor and the residual tolerance per out-edge, the other fields are unused.
+     * @return The vertices with a non-zero estimate and their estimates, by decreasing estimate.
+     * @throws invalid_argument If the seed is not a vertex or the damping factor is not in [0, 1).
+     * @details Starting with all residual probability on the seed, a vertex whose residual exceeds the tolerance
+     * times its out-degree keeps 1 - damping of it as rank and passes the rest on evenly to its out-neighbors,
+     * or back to the seed if it has none. The total work is O(1 / (tolerance * (1 - damping))) no matter how big
+     * the graph is, and the estimates and residuals live in hash maps, so only vertices near the seed are touched.
+     */
+    template <typename R, typename T>
+    vector<pair<size_t, R>> Algorithms::personalizedPageRank(const BasicCSRGraph<T> &g, size_t seed,
+                                                            const PageRankOptions &options)
+    {
+        checkDamping(options.damping);
+        if (seed >= g.getNumVertices())
+        {
+            throw invalid_argument("the seed is not a vertex of the graph");
+        }
+        const vector<size_t> &offsets = g.getOffsets();
+        const vector<size_t> &targets = g.getTargets();
+        const R restart = static_cast<R>(1 - options.damping);
+        const R tolerance = static_cast<R>(options.tolerance);
+        auto threshold = [&](size_t v)
+        {
+            return tolerance * static_cast<R>(max<size_t>(1, g.degree(v)));
+        };
+
+        unordered_map<size_t, R> estimate, residual;
+        deque<size_t> queue;
+        unordered_map<size_t, bool> queued;
+        residual[seed] = R(1);
+        queue.push_back(seed);
+        queued[seed] = true;
+        while (!queue.empty())
+        {
+            size_t u = queue.front();
+            queue.pop_front();
+            queued[u] = false;
+            R r = residual[u];
+            if (r < threshold(u))
+            {
+                continue;
+            }
+            residual[u] = R(0);
+            estimate[u] += restart * r;
+            size_t degree = offsets[u + 1] - offsets[u];
+            R share = (R(1) - restart) * r / static_cast<R>(max<size_t>(1, degree));
+            for (size_t e = offsets[u]; e < offsets[u] + max<size_t>(1, degree); ++e)
+            {
+                size_t v = degree == 0 ? seed : targets[e];
+                R &pending = residual[v];
+                pending += share;
+                bool &waiting = queued[v];
+                if (!waiting && pending >= threshold(v))
+                {
+                    waiting = true;
+                    queue.push_back(v);
+                }
+            }
+        }
+
+        vector<pair<size_t, R>> ranks(estimate.begin(), estimate.end());
+        sort(ranks.begin(), ranks.end(), [](const pair<size_t, R> &a, const pair<size_t, R> &b)
+             { return a.second > b.second || (a.second == b.second && a.first < b.first); });
+        return ranks;
+    }
+
+    namespace
+    {
+        // Vertices are handed to the triangle counting threads in blocks of this many.
+        const size_t TRIANGLE_BLOCK = 256;
+
+        // From this out-degree on a vertex marks its neighbors in a bitmap instead of merging sorted lists.
+        const size_t TRIANGLE_BITSET_DEGREE = 64;
+
+        /**
+         * @brief The graph taken as undirected and without self-loops, each edge oriented from its endpoint of
+         * lower degree to the one of higher degree, ties broken by vertex.
+         * @details Every triangle is then found exactly once, from its lowest vertex, and no oriented list is
+         * longer than sqrt(2E), which bounds the work by O(E sqrt(E)) even on skewed degree distributions.
+         */
+        struct OrientedGraph
+        {
+            vector<size_t> degree;  // the undirected degree of every vertex
+            vector<size_t> first;   // the oriented neighbors of u are higher[first[u]] .. higher[first[u + 1] - 1]
+            vector<size_t> higher;  // in increasing vertex order
+        };
+
+        template <typename T>
+        OrientedGraph orientByDegree(const BasicCSRGraph<T> &g)
+        {
+            size_t n = g.getNumVertices();
+            BasicCSRGraph<T> reversed = g.transpose();
+            const BasicCSRGraph<T> *directions[] = {&g, &reversed};
+            vector<vector<size_t>> neighbors(n);
+            for (size_t u = 0; u < n; ++u)
+            {
+                for (const BasicCSRGraph<T> *direction : directions)
+                {
+                    const vector<size_t> &offsets = direction->getOffsets();
+                    const vector<size_t> &targets = direction->getTargets();
+                    for (size_t e = offsets[u]; e < offsets[u + 1]; ++e)
+                    {
+                        if (targets[e] != u)
+                        {
+                            neighbors[u].push_back(targets[e]);
+                        }
+                    }
+                }
+                sort(neighbors[u].begin(), neighbors[u].end());
+                neighbors[u].erase(unique(neighbors[u].begin(), neighbors[u].end()), neighbors[u].end());
+            }
+            OrientedGraph oriented;
+            oriented.degree.resize(n);
+            for (size_t u = 0; u < n; ++u)
+            {
+                oriented.degree[u] = neighbors[u].size();
+            }
+            oriented.first.assign(1, 0);
+            for (size_t u = 0; u < n; ++u)
+            {
+                for (size_t v : neighbors[u])
+                {
+                    if (oriented.degree[u] < oriented.degree[v] || (oriented.degree[u] == oriented.degree[v] && u < v))
+                    {
+                        oriented.higher.push_back(v);
+                    }
+                }
+                oriented.first.push_back(oriented.higher.size());
+                vector<size_t>().swap(neighbors[u]);
+            }
+            return oriented;
+        }
+
+        /**
+         * @brief Counts the triangles through every oriented edge on several threads.
+         * @param found Called as found(u, v, w, count) for every oriented edge u -> v, with the count of the common
+         * neighbors w it closes triangles with, or once per triangle with count 1 if perTriangle is set.
+         * @return The number of triangles, every thread sums its own and adds it to the total once when it is done.
+         * @details A vertex with a short list intersects it with the list of every neighbor by a branch-free
+         * merge, whose loop only advances indices by comparison results. A vertex with a long one marks it in a
+         * per-thread bitmap and probes the lists of its neighbors against it in O(1) per element. Threads take
+         * blocks of vertices from a shared counter, since the work per vertex is very uneven.
+         */
+        template <typename Found>
+        uint64_t intersectOriented(const OrientedGraph &g, bool perTriangle, size_t threads, Found found)
+        {
+            size_t n = g.degree.size();
+            size_t workers = n < 4 * TRIANGLE_BLOCK ? 1 : workerCount(threads);
+            atomic<size_t> nextBlock(0);
+            atomic<uint64_t> total(0);
+            parallelFor(0, workers, [&](size_t)
+                        {
+                            vector<uint64_t> marked((n + 63) / 64, 0);
+                            uint64_t local = 0;
+                            size_t block;
+                            while ((block = nextBlock.fetch_add(1, memory_order_relaxed)) * TRIANGLE_BLOCK < n)
+                            {
+                                size_t end = min(n, (block + 1) * TRIANGLE_BLOCK);
+                                for (size_t u = block * TRIANGLE_BLOCK; u < end; ++u)
+                                {
+                                    const size_t *a = g.higher.data() + g.first[u];
+                                    size_t lengthA = g.first[u + 1] - g.first[u];
+                                    bool useBitset = lengthA >= TRIANGLE_BITSET_DEGREE;
+                                    if (useBitset)
+                                    {
+                                        for (size_t i = 0; i < lengthA; ++i)
+                                        {
+                                            marked[a[i] >> 6] |= uint64_t(1) << (a[i] & 63);
+                                        }
+                                    }
+                                    for (size_t k = 0; k < lengthA; ++k)
+                                    {
+                                        size_t v = a[k];
+                                        const size_t *b = g.higher.data() + g.first[v];
+                                        size_t lengthB = g.first[v + 1] - g.first[v];
+                                        size_t common = 0;
+                                        if (useBitset)
+                                        {
+                                            for (size_t j = 0; j < lengthB; ++j)
+                                            {
+                                                bool hit = (marked[b[j] >> 6] >> (b[j] & 63)) & 1;
+                                                if (perTriangle && hit)
+                                                {
+                                                    found(u, v, b[j], 1);
+                                                }
+                                                common += hit;
+                                            }
+                                        }
+                                        else
+                                        {
+                                            size_t i = 0, j = 0;
+                                            while (i < lengthA && j < lengthB)
+                                            {
+                                                size_t x = a[i], y = b[j];
+                                                if (perTriangle && x == y)
+                                                {
+                                                    found(u, v, x, 1);
+                                                }
+                                                common += x == y;
+                                                i += x <= y;
+                                                j += y <= x;
+                                            }
+                                        }
+                                        if (!perTriangle && common != 0)
+                                        {
+                                            found(u, v, NO_VERTEX, common);
+                                        }
+                                        local += common;
+                                    }
+                                    if (useBitset)
+                                    {
+                                        for (size_t i = 0; i < lengthA; ++i)
+                                        {
+                                            marked[a[i] >> 6] = 0;
+                                        }
+                                    }
+                                }
+                            }
+                            total.fetch_add(local, memory_order_relaxed);
+                        },
+                        workers);
+            return total.load();
+        }
+    }
+
+    /**
+     * @brief Counts the triangles of a graph taken as undirected.
+     * @param g The graph, edges count once in either direction and self-loops are ignored.
+     * @param threads The number of threads to use, 0 for the hardware concurrency.
+     * @return The number of sets of three vertices that are pairwise adjacent.
+     * @details Orients every edge towards the endpoint of higher degree and intersects the neighbor lists of
+     * the endpoints of every oriented edge, in O(E sqrt(E)) time and O(E) memory, instead of the O(V^3) cube of
+     * the adjacency matrix.
+     */
+    template <typename T>
+    uint64_t Algorithms::countTriangles(const BasicCSRGraph<T> &g, size_t threads)
+    {
+        return intersectOriented(orientByDegree(g), false, threads, [](size_t, size_t, size_t, size_t) {});
+    }
+
+    /**
+     * @brief Counts the triangles of a dense graph, see the CSR version.
+     */
+    template <typename T>
+    uint64_t Algorithms::countTriangles(const BasicGraph<T> &g, size_t threads)
+    {
+        return countTriangles(BasicCSRGraph<T>(g), threads);
+    }
+
+    /**
+     * @brief Computes the local clustering coefficient of every vertex of a graph taken as undirected.
+     * @param g The graph, edges count once in either direction and self-loops are ignored.
+     * @param threads The number of threads to use, 0 for the hardware concurrency.
+     * @return For every vertex, the fraction of pairs of its neighbors that are adjacent, 0 with fewer than two.
+     * @details Every triangle found as in countTriangles is credited to its three vertices.
+     */
+    template <typename T>
+    vector<double> Algorithms::clusteringCoefficients(const BasicCSRGraph<T> &g, size_t threads)
+    {
+        OrientedGraph oriented = orientByDegree(g);
+        size_t n = oriented.degree.size();
+        unique_ptr<atomic<uint64_t>[]> triangles(new atomic<uint64_t>[n]);
+        for (size_t v = 0; v < n; ++v)
+        {
+            triangles[v].store(0, memory_order_relaxed);
+        }
+        intersectOriented(oriented, true, threads, [&triangles](size_t u, size_t v, size_t w, size_t)
+                          {
+                              triangles[u].fetch_add(1, memory_order_relaxed);
+                              triangles[v].fetch_add(1, memory_order_relaxed);
+                              triangles[w].fetch_add(1, memory_order_relaxed);
+                          });
+        vector<double> coefficients(n, 0.0);
+        for (size_t v = 0; v < n; ++v)
+        {
+            double degree = static_cast<double>(oriented.degree[v]);
+            if (degree >= 2)
+            {
+                coefficients[v] = 2.0 * static_cast<double>(triangles[v].load(memory_order_relaxed)) / (degree * (degree - 1));
+            }
+        }
+        return coefficients;
+    }
+
+    /**
+     * @brief Computes the local clustering coefficients of a dense graph, see the CSR version.
+     */
+    template <typename T>
+    vector<double> Algorithms::clusteringCoefficients(const BasicGraph<T> &g, size_t threads)
+    {
+        return clusteringCoefficients(BasicCSRGraph<T>(g), threads);
+    }
+
+#define ARIEL_INSTANTIATE_ALGORITHMS(T) \
+    template bool Algorithms::isConnected(BasicGraph<T>); \
+    template string Algorithms::shortestPath(BasicGraph<T>, int, int); \
+    template bool Algorithms::isConnected(const BasicCompressedGraph<T> &); \
+    template string Algorithms::shortestPath(const BasicCompressedGraph<T> &, int, int); \
+    template bool Algorithms::isContainsCycle(BasicGraph<T>); \
+    template string Algorithms::isBipartite(BasicGraph<T>); \
+    template string Algorithms::negativeCycle(BasicGraph<T>); \
+    template BasicGraph<T> Algorithms::allPairsShortestPaths(const BasicGraph<T> &, size_t); \
+    template BasicGraph<T> Algorithms::johnsonShortestPaths(const BasicGraph<T> &, size_t); \
+    template void Algorithms::johnsonShortestPaths(const BasicCSRGraph<T> &, const function<void(size_t, const vector<T> &)> &, \
+                                                   size_t, size_t); \
+    template vector<size_t> Algorithms::stronglyConnectedComponents(const BasicCSRGraph<T> &, size_t); \
+    template vector<size_t> Algorithms::stronglyConnectedComponents(const BasicGraph<T> &, size_t); \
+    template bool Algorithms::isStronglyConnected(const BasicGraph<T> &); \
+    template Graph Algorithms::condensation(const BasicGraph<T> &, const vector<size_t> &); \
+    template vector<size_t> Algorithms::topologicalSort(const BasicCSRGraph<T> &); \
+    template vector<size_t> Algorithms::topologicalSort(const BasicGraph<T> &); \
+    template vector<vector<size_t>> Algorithms::topologicalLevels(const BasicCSRGraph<T> &, size_t); \
+    template vector<T> Algorithms::dagShortestPaths(const BasicCSRGraph<T> &, size_t); \
+    template vector<T> Algorithms::dagLongestPaths(const BasicCSRGraph<T> &, size_t); \
+    template vector<T> Algorithms::dagShortestPaths(const BasicGraph<T> &, size_t); \
+    template vector<T> Algorithms::dagLongestPaths(const BasicGraph<T> &, size_t); \
+    template vector<size_t> Algorithms::criticalPath(const BasicCSRGraph<T> &); \
+    template SpanningForest<T> Algorithms::primSpanningForest(const BasicGraph<T> &); \
+    template SpanningForest<T> Algorithms::kruskalSpanningForest(const BasicGraph<T> &); \
+    template SpanningForest<T> Algorithms::boruvkaSpanningForest(const BasicGraph<T> &, size_t); \
+    template MaximumFlow<T> Algorithms::maxFlowPushRelabel(const BasicCSRGraph<T> &, size_t, size_t); \
+    template MaximumFlow<T> Algorithms::maxFlowPushRelabel(const BasicGraph<T> &, size_t, size_t); \
+    template MaximumFlow<T> Algorithms::maxFlowDinic(const BasicCSRGraph<T> &, size_t, size_t); \
+    template MaximumFlow<T> Algorithms::maxFlowDinic(const BasicGraph<T> &, size_t, size_t); \
+    template bool Algorithms::bipartition(const BasicCSRGraph<T> &, vector<size_t> &, vector<size_t> &); \
+    template bool Algorithms::bipartition(const BasicGraph<T> &, vector<size_t> &, vector<size_t> &); \
+    template vector<pair<size_t, size_t>> Algorithms::maximumMatching(const BasicCSRGraph<T> &); \
+    template vector<pair<size_t, size_t>> Algorithms::maximumMatching(const BasicGraph<T> &); \
+    template vector<pair<size_t, size_t>> Algorithms::maximumMatchingPushRelabel(const BasicCSRGraph<T> &, size_t); \
+    template vector<float> Algorithms::pageRank<float>(const BasicCSRGraph<T> &, const PageRankOptions &); \
+    template vector<double> Algorithms::pageRank<double>(const BasicCSRGraph<T> &, const PageRankOptions &); \
+    template vector<float> Algorithms::pageRank<float>(const BasicGraph<T> &, const PageRankOptions &); \
+    template vector<double> Algorithms::pageRank<double>(const BasicGraph<T> &, const PageRankOptions &); \
+    template vector<pair<size_t, float>> Algorithms::personalizedPageRank<float>(const BasicCSRGraph<T> &, size_t, \
+                                                                                 const PageRankOptions &); \
+    template vector<pair<size_t, double>> Algorithms::personalizedPageRank<double>(const BasicCSRGraph<T> &, size_t, \
+                                                                                   const PageRankOptions &); \
+    template uint64_t Algorithms::countTriangles(const BasicCSRGraph<T> &, size_t); \
+    template uint64_t Algorithms::countTriangles(const BasicGraph<T> &, size_t); \
+    template vector<double> Algorithms::clusteringCoefficients(const BasicCSRGraph<T> &, size_t); \
+    template vector<double> Algorithms::clusteringCoefficients(const BasicGraph<T> &, size_t);
+
+    ARIEL_INSTANTIATE_ALGORITHMS(int)
+    ARIEL_INSTANTIATE_ALGORITHMS(int64_t)
+    ARIEL_INSTANTIATE_ALGORITHMS(float)
+    ARIEL_INSTANTIATE_ALGORITHMS(double)
+    ARIEL_INSTANTIATE_ALGORITHMS(uint8_t)
+}
@@ -1,5 +1,43 @@
+#ifndef ALGORITHMS_HPP
+#define ALGORITHMS_HPP
+
+#include <functional>
 #include "Graph.hpp"
+#include "CSRGraph.hpp"
+#include "CompressedGraph.hpp"
 namespace ariel{
+    // a minimum spanning forest: the chosen edges in both directions and their total weight
+    template <typename T>
+    struct SpanningForest
+    {
+        BasicGraph<T> forest;
+        T weight;
+    };
+
+    // a maximum flow: its value, the flow on every edge in the order of the edges of the CSR graph, and the
+    // vertices on the source side of a minimum cut
+    template <typename T>
+    struct MaximumFlow
+    {
+        T value;
+        vector<T> edgeFlow;
+        vector<bool> sourceSide;
+    };
+
+    // the parameters of PageRank: the rank follows an edge with probability damping and otherwise jumps to a
+    // random vertex, or back to the seed in the personalized variant. the iterations stop once the ranks change by
+    // less than tolerance in total, and the push variant leaves at most tolerance of residual per out-edge
+    struct PageRankOptions
+    {
+        double damping;
+        double tolerance;
+        size_t maxIterations;
+        size_t threads; // 0 for the hardware concurrency
+
+        PageRankOptions() : damping(0.85), tolerance(1e-6), maxIterations(100), threads(0) {}
+    };
+
+    // every algorithm works on any weight type the graph is instantiated for, see Graph.hpp
     class Algorithms{
 
         // private:
@@ -11,18 +49,131 @@ namespace ariel{
 
             ~Algorithms();
 
-            static bool isConnected(Graph g);
+            template <typename T>
+            static bool isConnected(BasicGraph<T> g);
 
-            static string shortestPath(Graph g, int start, int end);
+            // the same breadth-first searches, decoding the compressed adjacency lists on the fly
+            template <typename T>
+            static bool isConnected(const BasicCompressedGraph<T> &g);
+
+            template <typename T>
+            static string shortestPath(BasicGraph<T> g, int start, int end);
+            template <typename T>
+            static string shortestPath(const BasicCompressedGraph<T> &g, int start, int end);
             // this function checks whether there is a cycle in the graph or not. if there is it prints
             // the cycle is: for example 1 -> 2 -> 3. and if there is not it simply returns 0
-            static  bool isContainsCycle(Graph g);
+            template <typename T>
+            static  bool isContainsCycle(BasicGraph<T> g);
 
             // this function checks whether a graph is isBipartite or not, returning the partiotion of the graph to two parts if possible 
-            static string isBipartite(Graph g);
+            template <typename T>
+            static string isBipartite(BasicGraph<T> g);
+
+            // the two sides behind isBipartite, with the graph taken as undirected; false if it is not bipartite
+            template <typename T>
+            static bool bipartition(const BasicCSRGraph<T> &g, vector<size_t> &partA, vector<size_t> &partB);
+            template <typename T>
+            static bool bipartition(const BasicGraph<T> &g, vector<size_t> &partA, vector<size_t> &partB);
 
             // this function returns whether there is a negative cycle in the graph or not
-            static string negativeCycle(Graph g);
+            template <typename T>
+            static string negativeCycle(BasicGraph<T> g);
+
+            // this function returns the matrix of shortest distances between every pair of vertices
+            template <typename T>
+            static BasicGraph<T> allPairsShortestPaths(const BasicGraph<T> &g, size_t threads = 0);
+
+            // Johnson's algorithm: all pairs shortest paths for sparse graphs with negative edges.
+            // the streaming form hands every row of the distance matrix to rowSink, in order of the source vertex,
+            // keeping at most rowsInFlight rows in memory at once
+            template <typename T>
+            static BasicGraph<T> johnsonShortestPaths(const BasicGraph<T> &g, size_t threads = 0);
+            template <typename T>
+            static void johnsonShortestPaths(const BasicCSRGraph<T> &g,
+                                             const function<void(size_t, const vector<typename BasicCSRGraph<T>::Weight> &)> &rowSink,
+                                             size_t rowsInFlight = 64, size_t threads = 0);
+
+            // strongly connected components: the component of every vertex, numbered so that every edge between
+            // two components goes from the lower id to the higher one, and the condensation DAG of the components
+            template <typename T>
+            static vector<size_t> stronglyConnectedComponents(const BasicGraph<T> &g, size_t threads = 0);
+            template <typename T>
+            static vector<size_t> stronglyConnectedComponents(const BasicCSRGraph<T> &g, size_t threads = 0);
+            template <typename T>
+            static bool isStronglyConnected(const BasicGraph<T> &g);
+            template <typename T>
+            static Graph condensation(const BasicGraph<T> &g, const vector<size_t> &components);
+
+            // topological orders of a DAG, as one sequence or as levels of independent vertices, and linear time
+            // shortest, longest and critical paths that follow the order instead of using a priority queue
+            template <typename T>
+            static vector<size_t> topologicalSort(const BasicCSRGraph<T> &g);
+            template <typename T>
+            static vector<size_t> topologicalSort(const BasicGraph<T> &g);
+            template <typename T>
+            static vector<vector<size_t>> topologicalLevels(const BasicCSRGraph<T> &g, size_t threads = 0);
+            template <typename T>
+            static vector<T> dagShortestPaths(const BasicCSRGraph<T> &g, size_t source);
+            template <typename T>
+            static vector<T> dagShortestPaths(const BasicGraph<T> &g, size_t source);
+            template <typename T>
+            static vector<T> dagLongestPaths(const BasicCSRGraph<T> &g, size_t source);
+            template <typename T>
+            static vector<T> dagLongestPaths(const BasicGraph<T> &g, size_t source);
+            template <typename T>
+            static vector<size_t> criticalPath(const BasicCSRGraph<T> &g);
+
+            // minimum spanning forests of the graph taken as undirected: Prim for dense graphs, Kruskal for sparse
+            // ones and a parallel Borůvka for many cores, all giving a forest of the same total weight
+            template <typename T>
+            static SpanningForest<T> primSpanningForest(const BasicGraph<T> &g);
+            template <typename T>
+            static SpanningForest<T> kruskalSpanningForest(const BasicGraph<T> &g);
+            template <typename T>
+            static SpanningForest<T> boruvkaSpanningForest(const BasicGraph<T> &g, size_t threads = 0);
+
+            // maximum flows from source to sink with the weights as capacities, computed on a residual CSR network:
+            // highest-label push-relabel with global relabeling and gaps, and Dinic's blocking flows
+            template <typename T>
+            static MaximumFlow<T> maxFlowPushRelabel(const BasicCSRGraph<T> &g, size_t source, size_t sink);
+            template <typename T>
+            static MaximumFlow<T> maxFlowPushRelabel(const BasicGraph<T> &g, size_t source, size_t sink);
+            template <typename T>
+            static MaximumFlow<T> maxFlowDinic(const BasicCSRGraph<T> &g, size_t source, size_t sink);
+            template <typename T>
+            static MaximumFlow<T> maxFlowDinic(const BasicGraph<T> &g, size_t source, size_t sink);
+
+            // maximum cardinality matchings of a bipartite graph as (vertex of partA, vertex of partB) pairs:
+            // Hopcroft-Karp, and a parallel push-relabel for very large graphs
+            template <typename T>
+            static vector<pair<size_t, size_t>> maximumMatching(const BasicCSRGraph<T> &g);
+            template <typename T>
+            static vector<pair<size_t, size_t>> maximumMatching(const BasicGraph<T> &g);
+            template <typename T>
+            static vector<pair<size_t, size_t>> maximumMatchingPushRelabel(const BasicCSRGraph<T> &g, size_t threads = 0);
+
+            // PageRank of every vertex, edges unweighted, with ranks of type R (float or double) that sum to 1:
+            // Algorithms::pageRank<float>(g). the personalized form pushes from one seed and only returns, and only
+            // visits, the vertices near it, by decreasing rank
+            template <typename R, typename T>
+            static vector<R> pageRank(const BasicCSRGraph<T> &g, const PageRankOptions &options = PageRankOptions());
+            template <typename R, typename T>
+            static vector<R> pageRank(const BasicGraph<T> &g, const PageRankOptions &options = PageRankOptions());
+            template <typename R, typename T>
+            static vector<pair<size_t, R>> personalizedPageRank(const BasicCSRGraph<T> &g, size_t seed,
+                                                                const PageRankOptions &options = PageRankOptions());
+
+            // triangles of the graph taken as undirected, counted by intersecting neighbor lists oriented by
+            // degree, and the local clustering coefficient of every vertex
+            template <typename T>
+            static uint64_t countTriangles(const BasicCSRGraph<T> &g, size_t threads = 0);
+            template <typename T>
+            static uint64_t countTriangles(const BasicGraph<T> &g, size_t threads = 0);
+            template <typename T>
+            static vector<double> clusteringCoefficients(const BasicCSRGraph<T> &g, size_t threads = 0);
+            template <typename T>
+            static vector<double> clusteringCoefficients(const BasicGraph<T> &g, size_t threads = 0);
 
     };
-}
\ No newline at end of file
+}
+#endif // ALGORITHMS_HPP
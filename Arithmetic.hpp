@@ -0,0 +1,218 @@
+#ifndef ARITHMETIC_HPP
+#define ARITHMETIC_HPP
+
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <vector>
+#include "Parallel.hpp"
+
+namespace ariel
+{
+    /**
+     * @brief Per weight type helpers shared by the arithmetic policies and the semirings.
+     * @details Wide is a type that holds any sum or product of two T without overflowing,
+     * wrapAdd, wrapSub and wrapMul are the two's complement operations for integers and the plain ones for floating point.
+     */
+    template <typename T, bool Integral = std::numeric_limits<T>::is_integer>
+    struct ArithmeticTraits;
+
+    template <typename T>
+    struct ArithmeticTraits<T, true>
+    {
+        typedef typename std::conditional<(sizeof(T) < sizeof(long long)), long long, __int128>::type Wide;
+        typedef typename std::make_unsigned<typename std::common_type<T, int>::type>::type Unsigned;
+
+        static T wrapAdd(T a, T b) { return static_cast<T>(static_cast<Unsigned>(a) + static_cast<Unsigned>(b)); }
+        static T wrapSub(T a, T b) { return static_cast<T>(static_cast<Unsigned>(a) - static_cast<Unsigned>(b)); }
+        static T wrapMul(T a, T b) { return static_cast<T>(static_cast<Unsigned>(a) * static_cast<Unsigned>(b)); }
+    };
+
+    template <typename T>
+    struct ArithmeticTraits<T, false>
+    {
+        typedef typename std::conditional<(sizeof(T) < sizeof(double)), double, long double>::type Wide;
+
+        static T wrapAdd(T a, T b) { return a + b; }
+        static T wrapSub(T a, T b) { return a - b; }
+        static T wrapMul(T a, T b) { return a * b; }
+    };
+
+    /**
+     * @brief Clamps a wide value to the range of T.
+     */
+    template <typename T, typename W>
+    T clampTo(W v)
+    {
+        const W lo = static_cast<W>(std::numeric_limits<T>::lowest());
+        const W hi = static_cast<W>(std::numeric_limits<T>::max());
+        return static_cast<T>(v < lo ? lo : (v > hi ? hi : v));
+    }
+
+    /**
+     * @brief Clamps a wide value to the range of T and raises the overflow flag if it did not fit.
+     */
+    template <typename T, typename W>
+    T flagged(W v, int &overflow)
+    {
+        overflow |= (v < static_cast<W>(std::numeric_limits<T>::lowest())) | (v > static_cast<W>(std::numeric_limits<T>::max()));
+        return clampTo<T>(v);
+    }
+
+    /*
+     * Arithmetic policies for the graph operators. Every policy exposes the same static interface for a weight type T:
+     *   add, sub, mul(a, b, overflow)              element-wise operations on T
+     *   Accumulator<T>                             the type a matrix product accumulates in
+     *   accumulate(acc, a, b, overflow)            acc + a * b
+     *   narrow<T>(acc, overflow)                   converts an accumulator back to T
+     *   reportsOverflow                            whether the policy ever sets the overflow flag
+     * Instead of branching, a policy that detects overflow ORs a flag that the caller inspects once per row,
+     * which keeps the loops vectorizable. Policies that never fail simply ignore the flag.
+     */
+
+    /**
+     * @brief Two's complement wrap around, the behavior of plain int arithmetic but well defined.
+     */
+    struct Wrapping
+    {
+        template <typename T>
+        using Accumulator = T;
+        static const bool reportsOverflow = false;
+
+        template <typename T>
+        static T add(T a, T b, int &) { return ArithmeticTraits<T>::wrapAdd(a, b); }
+        template <typename T>
+        static T sub(T a, T b, int &) { return ArithmeticTraits<T>::wrapSub(a, b); }
+        template <typename T>
+        static T mul(T a, T b, int &) { return ArithmeticTraits<T>::wrapMul(a, b); }
+        template <typename T>
+        static T accumulate(T acc, T a, T b, int &) { return ArithmeticTraits<T>::wrapAdd(acc, ArithmeticTraits<T>::wrapMul(a, b)); }
+        template <typename T>
+        static T narrow(T acc, int &) { return acc; }
+    };
+
+    /**
+     * @brief Results are clamped to the range of the weight type after every operation.
+     */
+    struct Saturating
+    {
+        template <typename T>
+        using Accumulator = typename ArithmeticTraits<T>::Wide;
+        static const bool reportsOverflow = false;
+
+        template <typename T>
+        static T add(T a, T b, int &) { return clampTo<T>(static_cast<Accumulator<T>>(a) + b); }
+        template <typename T>
+        static T sub(T a, T b, int &) { return clampTo<T>(static_cast<Accumulator<T>>(a) - b); }
+        template <typename T>
+        static T mul(T a, T b, int &) { return clampTo<T>(static_cast<Accumulator<T>>(a) * b); }
+        template <typename T>
+        static Accumulator<T> accumulate(Accumulator<T> acc, T a, T b, int &)
+        {
+            return clampTo<T>(acc + clampTo<T>(static_cast<Accumulator<T>>(a) * b));
+        }
+        template <typename T>
+        static T narrow(Accumulator<T> acc, int &) { return static_cast<T>(acc); }
+    };
+
+    /**
+     * @brief Every operation, including each partial sum of a matrix product, must fit in the weight type.
+     * @details The operation that overflowed raises an overflow_error.
+     */
+    struct Checked
+    {
+        template <typename T>
+        using Accumulator = T;
+        static const bool reportsOverflow = true;
+
+        template <typename T>
+        static T add(T a, T b, int &overflow) { return flagged<T>(static_cast<typename ArithmeticTraits<T>::Wide>(a) + b, overflow); }
+        template <typename T>
+        static T sub(T a, T b, int &overflow) { return flagged<T>(static_cast<typename ArithmeticTraits<T>::Wide>(a) - b, overflow); }
+        template <typename T>
+        static T mul(T a, T b, int &overflow) { return flagged<T>(static_cast<typename ArithmeticTraits<T>::Wide>(a) * b, overflow); }
+        template <typename T>
+        static T accumulate(T acc, T a, T b, int &overflow)
+        {
+            return flagged<T>(acc + static_cast<typename ArithmeticTraits<T>::Wide>(a) * b, overflow);
+        }
+        template <typename T>
+        static T narrow(T acc, int &) { return acc; }
+    };
+
+    /**
+     * @brief Matrix products accumulate in a wider type and only the final entry must fit in the weight type.
+     * @details Partial sums may leave the range as long as they come back, e.g. large positive and negative
+     * walk weights cancelling out. Element-wise operations behave like Checked.
+     */
+    struct Widened
+    {
+        template <typename T>
+        using Accumulator = typename ArithmeticTraits<T>::Wide;
+        static const bool reportsOverflow = true;
+
+        template <typename T>
+        static T add(T a, T b, int &overflow) { return Checked::add(a, b, overflow); }
+        template <typename T>
+        static T sub(T a, T b, int &overflow) { return Checked::sub(a, b, overflow); }
+        template <typename T>
+        static T mul(T a, T b, int &overflow) { return Checked::mul(a, b, overflow); }
+        template <typename T>
+        static Accumulator<T> accumulate(Accumulator<T> acc, T a, T b, int &)
+        {
+            return acc + static_cast<Accumulator<T>>(a) * b;
+        }
+        template <typename T>
+        static T narrow(Accumulator<T> acc, int &overflow) { return flagged<T>(acc, overflow); }
+    };
+
+    /**
+     * @brief Computes c = a * b for square n x n matrices under an arithmetic policy.
+     * @param a The rows of the left operand.
+     * @param b The rows of the right operand.
+     * @param c The rows of the result, they must not alias a or b.
+     * @param n The dimension of the matrices.
+     * @param threads The number of threads to use, 0 for the hardware concurrency.
+     * @return True if any entry overflowed according to the policy.
+     * @details Rows are computed in parallel, each into a row of policy accumulators that is narrowed at the end.
+     * The overflow flags are collected per row and only inspected by the caller, since worker threads cannot throw.
+     */
+    template <typename P, typename T>
+    bool policyProduct(const T *const *a, const T *const *b, T *const *c, size_t n, size_t threads = 0)
+    {
+        typedef typename P::template Accumulator<T> Acc;
+        std::vector<int> rowOverflow(n, 0);
+        parallelFor(0, n, [&](size_t i)
+                    {
+                        std::vector<Acc> acc(n, Acc(0));
+                        int overflow = 0;
+                        for (size_t k = 0; k < n; ++k)
+                        {
+                            T aik = a[i][k];
+                            if (aik == T(0))
+                            {
+                                continue;
+                            }
+                            const T *bk = b[k];
+                            for (size_t j = 0; j < n; ++j)
+                            {
+                                acc[j] = P::template accumulate<T>(acc[j], aik, bk[j], overflow);
+                            }
+                        }
+                        for (size_t j = 0; j < n; ++j)
+                        {
+                            c[i][j] = P::template narrow<T>(acc[j], overflow);
+                        }
+                        rowOverflow[i] = overflow;
+                    },
+                    threads);
+
+        int overflow = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            overflow |= rowOverflow[i];
+        }
+        return overflow != 0;
+    }
+}
+#endif // ARITHMETIC_HPP
@@ -0,0 +1,450 @@
+/*
+ * Throughput benchmarks for the graph library, run with "make bench".
+ */
+
+#include "Algorithms.hpp"
+#include "Graph.hpp"
+#include "GraphIO.hpp"
+#include "Reorder.hpp"
+#include "Parallel.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+using namespace std;
+using namespace ariel;
+
+/**
+ * @brief Runs a function a few times and returns the fastest run in seconds.
+ */
+static double bestOf(int runs, const function<void()> &body)
+{
+    double best = 0;
+    for (int r = 0; r < runs; ++r)
+    {
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        body();
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        if (r == 0 || seconds < best)
+        {
+            best = seconds;
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief A dense graph with pseudo-random weights in [-999, 999], about a third of them zero.
+ */
+static Graph randomGraph(size_t n)
+{
+    vector<vector<int>> matrix(n, vector<int>(n));
+    unsigned long long state = 88172645463325252ULL;
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (size_t j = 0; j < n; ++j)
+        {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            matrix[i][j] = state % 3 == 0 ? 0 : static_cast<int>(state % 1999) - 999;
+        }
+    }
+    Graph g;
+    g.loadGraph(matrix);
+    return g;
+}
+
+static void benchmarkMatrixParser()
+{
+    const size_t n = 2000;
+    Graph g = randomGraph(n);
+    ostringstream bracketed;
+    bracketed << g;
+    ostringstream plain;
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (size_t j = 0; j < n; ++j)
+        {
+            plain << g.getEdge(i, j) << (j + 1 == n ? '\n' : ' ');
+        }
+    }
+
+    const string texts[] = {bracketed.str(), plain.str()};
+    const char *names[] = {"operator<< format", "whitespace format"};
+    vector<size_t> threadCounts(1, 1);
+    if (workerCount() > 1)
+    {
+        threadCounts.push_back(workerCount());
+    }
+    for (int f = 0; f < 2; ++f)
+    {
+        for (size_t threads : threadCounts)
+        {
+            const string &text = texts[f];
+            double seconds = bestOf(3, [&]()
+                                    { GraphIO::parseMatrix<int>(text.data(), text.size(), threads); });
+            printf("parseMatrix %-18s %2zu threads: %8.1f MB/s\n", names[f], threads, text.size() / seconds / 1e6);
+        }
+    }
+}
+
+static void benchmarkSerializer()
+{
+    const size_t n = 2000;
+    Graph g = randomGraph(n);
+    ostringstream sized;
+    sized << g;
+    double bytes = static_cast<double>(sized.str().size());
+
+    double seconds = bestOf(3, [&]()
+                            {
+                                ofstream out("/dev/null");
+                                out << g;
+                            });
+    printf("operator<<                          : %8.1f MB/s\n", bytes / seconds / 1e6);
+    vector<size_t> threadCounts(1, 1);
+    if (workerCount() > 1)
+    {
+        threadCounts.push_back(workerCount());
+    }
+    for (size_t threads : threadCounts)
+    {
+        seconds = bestOf(3, [&]()
+                         { GraphIO::writeMatrix(g, "/dev/null", threads); });
+        printf("writeMatrix                %2zu threads: %8.1f MB/s\n", threads, bytes / seconds / 1e6);
+    }
+}
+
+/**
+ * @brief Builds a CSR graph with unit weights from an edge list, relabeling the vertices at random.
+ */
+static CSRGraph shuffledGraph(size_t n, const vector<pair<size_t, size_t>> &edges)
+{
+    vector<size_t> label(n);
+    for (size_t v = 0; v < n; ++v)
+    {
+        label[v] = v;
+    }
+    unsigned long long state = 2463534242ULL;
+    for (size_t v = n; v > 1; --v)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        swap(label[v - 1], label[state % v]);
+    }
+    vector<pair<size_t, size_t>> shuffled;
+    shuffled.reserve(edges.size());
+    for (const pair<size_t, size_t> &edge : edges)
+    {
+        shuffled.push_back(make_pair(label[edge.first], label[edge.second]));
+    }
+    sort(shuffled.begin(), shuffled.end());
+    vector<size_t> offsets(n + 1, 0);
+    vector<size_t> targets;
+    targets.reserve(shuffled.size());
+    for (const pair<size_t, size_t> &edge : shuffled)
+    {
+        offsets[edge.first + 1]++;
+        targets.push_back(edge.second);
+    }
+    for (size_t v = 0; v < n; ++v)
+    {
+        offsets[v + 1] += offsets[v];
+    }
+    vector<int> weights(targets.size(), 1);
+    return CSRGraph(std::move(offsets), std::move(targets), std::move(weights));
+}
+
+/**
+ * @brief A breadth-first search over all the vertices, returning how many were reached.
+ */
+static size_t breadthFirst(const CSRGraph &g)
+{
+    size_t n = g.getNumVertices();
+    vector<bool> visited(n, false);
+    vector<size_t> queue;
+    queue.reserve(n);
+    for (size_t start = 0; start < n; ++start)
+    {
+        if (visited[start])
+        {
+            continue;
+        }
+        visited[start] = true;
+        queue.push_back(start);
+        for (size_t head = queue.size() - 1; head < queue.size(); ++head)
+        {
+            size_t v = queue[head];
+            for (size_t e = g.getOffsets()[v]; e < g.getOffsets()[v + 1]; ++e)
+            {
+                size_t u = g.getTargets()[e];
+                if (!visited[u])
+                {
+                    visited[u] = true;
+                    queue.push_back(u);
+                }
+            }
+        }
+    }
+    return queue.size();
+}
+
+static void benchmarkReordering()
+{
+    // A 1000 x 1000 grid, the shape of meshes and road networks
+    const size_t side = 1000;
+    vector<pair<size_t, size_t>> gridEdges;
+    for (size_t r = 0; r < side; ++r)
+    {
+        for (size_t c = 0; c < side; ++c)
+        {
+            size_t v = r * side + c;
+            if (c + 1 < side)
+            {
+                gridEdges.push_back(make_pair(v, v + 1));
+                gridEdges.push_back(make_pair(v + 1, v));
+            }
+            if (r + 1 < side)
+            {
+                gridEdges.push_back(make_pair(v, v + side));
+                gridEdges.push_back(make_pair(v + side, v));
+            }
+        }
+    }
+
+    // A skewed R-MAT style graph, the shape of social and web graphs
+    const size_t scale = 20;
+    vector<pair<size_t, size_t>> rmatEdges;
+    unsigned long long state = 88172645463325252ULL;
+    for (size_t e = 0; e < (size_t(8) << scale); ++e)
+    {
+        size_t from = 0, to = 0;
+        for (size_t bit = 0; bit < scale; ++bit)
+        {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            unsigned quadrant = state % 100;
+            from = from << 1 | (quadrant >= 76 ? 1 : 0);
+            to = to << 1 | (quadrant >= 57 && quadrant < 76 ? 1 : quadrant >= 95 ? 1 : 0);
+        }
+        if (from != to)
+        {
+            rmatEdges.push_back(make_pair(from, to));
+        }
+    }
+    sort(rmatEdges.begin(), rmatEdges.end());
+    rmatEdges.erase(unique(rmatEdges.begin(), rmatEdges.end()), rmatEdges.end());
+
+    const CSRGraph graphs[] = {shuffledGraph(side * side, gridEdges), shuffledGraph(size_t(1) << scale, rmatEdges)};
+    const char *graphNames[] = {"grid", "rmat"};
+    for (int k = 0; k < 2; ++k)
+    {
+        const CSRGraph &g = graphs[k];
+        const char *orderNames[] = {"random", "bfs", "rcm", "degree", "gorder"};
+        for (int o = 0; o < 5; ++o)
+        {
+            CSRGraph reordered = g;
+            double orderSeconds = 0;
+            if (o > 0)
+            {
+                chrono::steady_clock::time_point start = chrono::steady_clock::now();
+                Permutation p = o == 1   ? Reorder::bfsOrder(g)
+                                : o == 2 ? Reorder::reverseCuthillMcKee(g)
+                                : o == 3 ? Reorder::degreeSort(g)
+                                         : Reorder::gorder(g);
+                reordered = Reorder::permute(g, p);
+                orderSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            }
+            double seconds = bestOf(3, [&]()
+                                    { breadthFirst(reordered); });
+            printf("bfs %-4s %-6s order: %7.1f ms (ordering %7.1f ms)\n", graphNames[k], orderNames[o],
+                   seconds * 1e3, orderSeconds * 1e3);
+        }
+    }
+}
+
+/**
+ * @brief The brute-force sub-matrix search containsGraph used before, kept as the baseline.
+ */
+static bool naiveContains(const Graph &g, const Graph &other)
+{
+    size_t thisSize = g.getNumVertices();
+    size_t otherSize = other.getNumVertices();
+    if (thisSize < otherSize)
+    {
+        return false;
+    }
+    for (size_t i = 0; i <= thisSize - otherSize; ++i)
+    {
+        for (size_t j = 0; j <= thisSize - otherSize; ++j)
+        {
+            bool subMatrixFound = true;
+            for (size_t m = 0; m < otherSize; ++m)
+            {
+                if (!equal(other.getRow(m), other.getRow(m) + otherSize, g.getRow(i + m) + j))
+                {
+                    subMatrixFound = false;
+                    break;
+                }
+            }
+            if (subMatrixFound)
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief A sparse graph whose non-zero entries are 1, placed with probability 1 / oneIn.
+ */
+static Graph sparseGraph(size_t n, size_t oneIn)
+{
+    vector<vector<int>> matrix(n, vector<int>(n, 0));
+    unsigned long long state = 88172645463325252ULL;
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (size_t j = 0; j < n; ++j)
+        {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            matrix[i][j] = state % oneIn == 0 ? 1 : 0;
+        }
+    }
+    Graph g;
+    g.loadGraph(matrix);
+    return g;
+}
+
+static void benchmarkContainsGraph()
+{
+    // A very sparse graph and an empty pattern with one mark in its last cell, so the brute force compares
+    // nearly the whole pattern at every position before it finds the mismatch
+    const size_t sizes[][2] = {{1000, 100}, {5000, 500}};
+    for (const size_t *size : sizes)
+    {
+        Graph big = sparseGraph(size[0], 4096);
+        Graph small(static_cast<int>(size[1]));
+        small.setEdge(size[1] - 1, size[1] - 1, 2);
+        small.getNumEdges();
+        big.getNumEdges();
+        bool found = false;
+        double seconds = bestOf(3, [&]()
+                                { found = big.containsGraph(small); });
+        printf("containsGraph %5zu / %3zu rolling hash: %9.1f ms (%s)\n", size[0], size[1], seconds * 1e3,
+               found ? "found" : "absent");
+        if (size[0] <= 1000)
+        {
+            seconds = bestOf(1, [&]()
+                             { found = naiveContains(big, small); });
+            printf("containsGraph %5zu / %3zu brute force : %9.1f ms (%s)\n", size[0], size[1], seconds * 1e3,
+                   found ? "found" : "absent");
+        }
+    }
+}
+
+/**
+ * @brief Builds a CSR network from an edge list with capacities, edges sorted by source.
+ */
+static CSRGraph network(size_t n, vector<pair<pair<size_t, size_t>, int>> edges)
+{
+    sort(edges.begin(), edges.end());
+    vector<size_t> offsets(n + 1, 0), targets;
+    vector<int> capacities;
+    for (const pair<pair<size_t, size_t>, int> &edge : edges)
+    {
+        offsets[edge.first.first + 1]++;
+        targets.push_back(edge.first.second);
+        capacities.push_back(edge.second);
+    }
+    for (size_t v = 0; v < n; ++v)
+    {
+        offsets[v + 1] += offsets[v];
+    }
+    return CSRGraph(std::move(offsets), std::move(targets), std::move(capacities));
+}
+
+static void benchmarkMaxFlow()
+{
+    unsigned long long state = 88172645463325252ULL;
+    auto random = [&state](unsigned bound)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return static_cast<size_t>(state % bound);
+    };
+
+    // A 300 x 300 grid with edges both ways between neighbors, the source feeding the left column and the
+    // right column draining into the sink
+    const size_t side = 300;
+    size_t gridSource = side * side, gridSink = side * side + 1;
+    vector<pair<pair<size_t, size_t>, int>> gridEdges;
+    for (size_t row = 0; row < side; ++row)
+    {
+        for (size_t col = 0; col < side; ++col)
+        {
+            size_t v = row * side + col;
+            if (col + 1 < side)
+            {
+                gridEdges.push_back(make_pair(make_pair(v, v + 1), 1 + static_cast<int>(random(100))));
+                gridEdges.push_back(make_pair(make_pair(v + 1, v), 1 + static_cast<int>(random(100))));
+            }
+            if (row + 1 < side)
+            {
+                gridEdges.push_back(make_pair(make_pair(v, v + side), 1 + static_cast<int>(random(100))));
+                gridEdges.push_back(make_pair(make_pair(v + side, v), 1 + static_cast<int>(random(100))));
+            }
+        }
+        gridEdges.push_back(make_pair(make_pair(gridSource, row * side), 1000));
+        gridEdges.push_back(make_pair(make_pair(row * side + side - 1, gridSink), 1000));
+    }
+    CSRGraph grid = network(side * side + 2, gridEdges);
+
+    // A random network with eight edges per vertex
+    const size_t n = 100000;
+    vector<pair<pair<size_t, size_t>, int>> randomEdges;
+    for (size_t u = 0; u < n; ++u)
+    {
+        for (int k = 0; k < 8; ++k)
+        {
+            randomEdges.push_back(make_pair(make_pair(u, random(n)), 1 + static_cast<int>(random(1000))));
+        }
+    }
+    CSRGraph sparse = network(n, randomEdges);
+
+    const CSRGraph *networks[] = {&grid, &sparse};
+    const char *networkNames[] = {"grid", "random"};
+    const size_t sources[] = {gridSource, 0}, sinks[] = {gridSink, n - 1};
+    for (size_t k = 0; k < 2; ++k)
+    {
+        int value = 0;
+        double seconds = bestOf(3, [&]()
+                                { value = Algorithms::maxFlowPushRelabel(*networks[k], sources[k], sinks[k]).value; });
+        printf("max flow %-6s push-relabel: %9.1f ms (flow %d)\n", networkNames[k], seconds * 1e3, value);
+        seconds = bestOf(3, [&]()
+                         { value = Algorithms::maxFlowDinic(*networks[k], sources[k], sinks[k]).value; });
+        printf("max flow %-6s Dinic       : %9.1f ms (flow %d)\n", networkNames[k], seconds * 1e3, value);
+    }
+}
+
+int main()
+{
+    benchmarkMatrixParser();
+    benchmarkSerializer();
+    benchmarkReordering();
+    benchmarkContainsGraph();
+    benchmarkMaxFlow();
+    return 0;
+}
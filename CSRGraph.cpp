@@ -0,0 +1,198 @@
+#include <stdexcept>
+#include <utility>
+#include "CSRGraph.hpp"
+
+using namespace std;
+using namespace ariel;
+
+template <typename T>
+BasicCSRGraph<T>::BasicCSRGraph() : offsets(1, 0) {} // An empty graph
+
+/**
+ * @brief Builds the CSR form of a graph, every non-zero entry of the adjacency matrix becomes an edge.
+ * @param g The graph to convert.
+ */
+template <typename T>
+BasicCSRGraph<T>::BasicCSRGraph(const BasicGraph<T> &g)
+{
+    size_t numVertices = g.getNumVertices();
+    offsets.assign(numVertices + 1, 0);
+    for (size_t u = 0; u < numVertices; ++u)
+    {
+        const T *row = g.getRow(u);
+        size_t count = 0;
+        for (size_t v = 0; v < numVertices; ++v)
+        {
+            count += row[v] != T(0) ? 1 : 0;
+        }
+        offsets[u + 1] = offsets[u] + count;
+    }
+    targets.resize(offsets[numVertices]);
+    weights.resize(offsets[numVertices]);
+    for (size_t u = 0; u < numVertices; ++u)
+    {
+        const T *row = g.getRow(u);
+        size_t pos = offsets[u];
+        for (size_t v = 0; v < numVertices; ++v)
+        {
+            if (row[v] != T(0))
+            {
+                targets[pos] = v;
+                weights[pos] = row[v];
+                ++pos;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Builds a CSR graph from its raw arrays.
+ * @param offsets The start of every vertex's edge range, numVertices + 1 entries.
+ * @param targets The head of every edge.
+ * @param weights The weight of every edge.
+ * @throws invalid_argument If the arrays are not consistent with each other.
+ */
+template <typename T>
+BasicCSRGraph<T>::BasicCSRGraph(vector<size_t> offsets, vector<size_t> targets, vector<T> weights)
+    : offsets(std::move(offsets)), targets(std::move(targets)), weights(std::move(weights))
+{
+    if (this->offsets.empty() || this->offsets.back() != this->targets.size() || this->targets.size() != this->weights.size())
+    {
+        throw invalid_argument("Invalid graph: inconsistent CSR arrays.");
+    }
+    size_t numVertices = this->offsets.size() - 1;
+    for (size_t v = 0; v < numVertices; ++v)
+    {
+        if (this->offsets[v] > this->offsets[v + 1])
+        {
+            throw invalid_argument("Invalid graph: CSR offsets are not sorted.");
+        }
+    }
+    for (size_t e = 0; e < this->targets.size(); ++e)
+    {
+        if (this->targets[e] >= numVertices)
+        {
+            throw invalid_argument("Invalid graph: CSR edge points outside the graph.");
+        }
+    }
+}
+
+/**
+ * @brief Gets the number of vertices in the graph.
+ * @return The number of vertices in the graph.
+ */
+template <typename T>
+size_t BasicCSRGraph<T>::getNumVertices() const
+{
+    return offsets.size() - 1;
+}
+
+/**
+ * @brief Gets the number of edges in the graph.
+ * @return The number of edges in the graph.
+ */
+template <typename T>
+size_t BasicCSRGraph<T>::getNumEdges() const
+{
+    return targets.size();
+}
+
+/**
+ * @brief Gets the out-degree of a vertex.
+ * @param v The vertex.
+ * @return The number of edges leaving v.
+ */
+template <typename T>
+size_t BasicCSRGraph<T>::degree(size_t v) const
+{
+    return offsets[v + 1] - offsets[v];
+}
+
+/**
+ * @brief Gets the offsets array.
+ * @return A constant reference to the offsets array, numVertices + 1 entries.
+ */
+template <typename T>
+const vector<size_t> &BasicCSRGraph<T>::getOffsets() const
+{
+    return offsets;
+}
+
+/**
+ * @brief Gets the edge heads.
+ * @return A constant reference to the edge heads.
+ */
+template <typename T>
+const vector<size_t> &BasicCSRGraph<T>::getTargets() const
+{
+    return targets;
+}
+
+/**
+ * @brief Gets the edge weights.
+ * @return A constant reference to the edge weights.
+ */
+template <typename T>
+const vector<T> &BasicCSRGraph<T>::getWeights() const
+{
+    return weights;
+}
+
+/**
+ * @brief Builds the graph with every edge reversed.
+ * @return The transposed graph, its edge lists are sorted by source.
+ */
+template <typename T>
+BasicCSRGraph<T> BasicCSRGraph<T>::transpose() const
+{
+    size_t numVertices = getNumVertices();
+    vector<size_t> revOffsets(numVertices + 1, 0);
+    for (size_t e = 0; e < targets.size(); ++e)
+    {
+        revOffsets[targets[e] + 1]++;
+    }
+    for (size_t v = 0; v < numVertices; ++v)
+    {
+        revOffsets[v + 1] += revOffsets[v];
+    }
+    vector<size_t> next(revOffsets.begin(), revOffsets.end() - 1);
+    vector<size_t> revTargets(targets.size());
+    vector<T> revWeights(targets.size());
+    for (size_t u = 0; u < numVertices; ++u)
+    {
+        for (size_t e = offsets[u]; e < offsets[u + 1]; ++e)
+        {
+            size_t pos = next[targets[e]]++;
+            revTargets[pos] = u;
+            revWeights[pos] = weights[e];
+        }
+    }
+    return BasicCSRGraph(std::move(revOffsets), std::move(revTargets), std::move(revWeights));
+}
+
+/**
+ * @brief Expands the graph back into an adjacency matrix.
+ * @return The equivalent Graph, parallel edges keep the last weight.
+ */
+template <typename T>
+BasicGraph<T> BasicCSRGraph<T>::toGraph() const
+{
+    size_t numVertices = getNumVertices();
+    vector<vector<T>> adjmat(numVertices, vector<T>(numVertices, T(0)));
+    for (size_t u = 0; u < numVertices; ++u)
+    {
+        for (size_t e = offsets[u]; e < offsets[u + 1]; ++e)
+        {
+            adjmat[u][targets[e]] = weights[e];
+        }
+    }
+    BasicGraph<T> g;
+    g.loadGraph(std::move(adjmat));
+    return g;
+}
+
+template class ariel::BasicCSRGraph<int>;
+template class ariel::BasicCSRGraph<int64_t>;
+template class ariel::BasicCSRGraph<float>;
+template class ariel::BasicCSRGraph<double>;
+template class ariel::BasicCSRGraph<uint8_t>;
@@ -0,0 +1,41 @@
+#ifndef CSRGRAPH_HPP
+#define CSRGRAPH_HPP
+
+#include <vector>
+#include "Graph.hpp"
+using namespace std;
+
+namespace ariel
+{
+    /**
+     * @brief A compressed sparse row view of a weighted directed graph.
+     * @details The out-edges of vertex v are targets[offsets[v]] .. targets[offsets[v + 1] - 1] with the matching
+     * entries of weights. Sparse algorithms use it to visit only existing edges instead of scanning matrix rows.
+     */
+    template <typename T>
+    class BasicCSRGraph
+    {
+    private:
+        vector<size_t> offsets;
+        vector<size_t> targets;
+        vector<T> weights;
+
+    public:
+        typedef T Weight;
+
+        BasicCSRGraph();
+        explicit BasicCSRGraph(const BasicGraph<T> &g);
+        BasicCSRGraph(vector<size_t> offsets, vector<size_t> targets, vector<T> weights);
+        size_t getNumVertices() const;
+        size_t getNumEdges() const;
+        size_t degree(size_t v) const;
+        const vector<size_t> &getOffsets() const;
+        const vector<size_t> &getTargets() const;
+        const vector<T> &getWeights() const;
+        BasicCSRGraph transpose() const;
+        BasicGraph<T> toGraph() const;
+    };
+
+    typedef BasicCSRGraph<int> CSRGraph;
+}
+#endif // CSRGRAPH_HPP
@@ -0,0 +1,180 @@
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include "CompressedGraph.hpp"
+
+using namespace std;
+using namespace ariel;
+
+template <typename T>
+const size_t BasicCompressedGraph<T>::BLOCK_SIZE;
+
+/**
+ * @brief Appends the LEB128 encoding of a value, 7 bits per byte with the high bit set on all but the last byte.
+ */
+static void encodeVarint(vector<uint8_t> &bytes, size_t value)
+{
+    while (value >= 0x80)
+    {
+        bytes.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    bytes.push_back(static_cast<uint8_t>(value));
+}
+
+template <typename T>
+BasicCompressedGraph<T>::BasicCompressedGraph() : edgeOffsets(1, 0), vertexBlocks(1, 0) {} // An empty graph
+
+/**
+ * @brief Compresses a CSR graph.
+ * @param g The graph to compress, its edge lists need not be sorted.
+ * @throws invalid_argument If a vertex has two edges to the same target.
+ */
+template <typename T>
+BasicCompressedGraph<T>::BasicCompressedGraph(const BasicCSRGraph<T> &g)
+{
+    size_t numVertices = g.getNumVertices();
+    const vector<size_t> &offsets = g.getOffsets();
+    const vector<size_t> &targets = g.getTargets();
+    const vector<T> &csrWeights = g.getWeights();
+
+    edgeOffsets.assign(offsets.begin(), offsets.end());
+    vertexBlocks.assign(numVertices + 1, 0);
+    weights.resize(targets.size());
+    bytes.reserve(targets.size());
+
+    vector<pair<size_t, T>> edges;
+    for (size_t u = 0; u < numVertices; ++u)
+    {
+        edges.clear();
+        for (size_t e = offsets[u]; e < offsets[u + 1]; ++e)
+        {
+            edges.push_back(make_pair(targets[e], csrWeights[e]));
+        }
+        sort(edges.begin(), edges.end(), [](const pair<size_t, T> &a, const pair<size_t, T> &b)
+             { return a.first < b.first; });
+        for (size_t i = 0; i < edges.size(); ++i)
+        {
+            if (i > 0 && edges[i].first == edges[i - 1].first)
+            {
+                throw invalid_argument("Invalid graph: parallel edges cannot be compressed.");
+            }
+            if (i % BLOCK_SIZE == 0)
+            {
+                blockFirst.push_back(edges[i].first);
+                blockBytes.push_back(bytes.size());
+            }
+            else
+            {
+                encodeVarint(bytes, edges[i].first - edges[i - 1].first);
+            }
+            weights[offsets[u] + i] = edges[i].second;
+        }
+        vertexBlocks[u + 1] = blockFirst.size();
+    }
+    bytes.shrink_to_fit();
+}
+
+/**
+ * @brief Compresses a graph, every non-zero entry of the adjacency matrix becomes an edge.
+ * @param g The graph to compress.
+ */
+template <typename T>
+BasicCompressedGraph<T>::BasicCompressedGraph(const BasicGraph<T> &g) : BasicCompressedGraph(BasicCSRGraph<T>(g)) {}
+
+/**
+ * @brief Gets the number of vertices in the graph.
+ * @return The number of vertices in the graph.
+ */
+template <typename T>
+size_t BasicCompressedGraph<T>::getNumVertices() const
+{
+    return edgeOffsets.size() - 1;
+}
+
+/**
+ * @brief Gets the number of edges in the graph.
+ * @return The number of edges in the graph.
+ */
+template <typename T>
+size_t BasicCompressedGraph<T>::getNumEdges() const
+{
+    return weights.size();
+}
+
+/**
+ * @brief Gets the out-degree of a vertex.
+ * @param v The vertex.
+ * @return The number of edges leaving v.
+ */
+template <typename T>
+size_t BasicCompressedGraph<T>::degree(size_t v) const
+{
+    return edgeOffsets[v + 1] - edgeOffsets[v];
+}
+
+/**
+ * @brief Checks if there is an edge between two vertices.
+ * @param from The source vertex.
+ * @param to The target vertex.
+ * @return True if the edge exists.
+ * @details A binary search over the first targets of the blocks of from finds the only block that may hold the
+ * edge, so at most BLOCK_SIZE - 1 gaps are decoded.
+ */
+template <typename T>
+bool BasicCompressedGraph<T>::hasEdge(size_t from, size_t to) const
+{
+    vector<size_t>::const_iterator first = blockFirst.begin() + static_cast<ptrdiff_t>(vertexBlocks[from]);
+    vector<size_t>::const_iterator last = blockFirst.begin() + static_cast<ptrdiff_t>(vertexBlocks[from + 1]);
+    vector<size_t>::const_iterator found = upper_bound(first, last, to);
+    if (found == first)
+    {
+        return false;
+    }
+    size_t block = static_cast<size_t>(found - blockFirst.begin()) - 1;
+    size_t edgesBefore = (block - vertexBlocks[from]) * BLOCK_SIZE;
+    size_t count = min(BLOCK_SIZE, degree(from) - edgesBefore);
+    size_t target = blockFirst[block];
+    const uint8_t *cursor = bytes.data() + blockBytes[block];
+    for (size_t i = 1; i < count && target < to; ++i)
+    {
+        target += decodeVarint(cursor);
+    }
+    return target == to;
+}
+
+/**
+ * @brief Gets the memory taken by the compressed adjacency lists, without the weights.
+ * @return The size in bytes of the offsets, the skip arrays and the encoded gaps.
+ */
+template <typename T>
+size_t BasicCompressedGraph<T>::compressedBytes() const
+{
+    return (edgeOffsets.size() + vertexBlocks.size() + blockFirst.size() + blockBytes.size()) * sizeof(size_t) + bytes.size();
+}
+
+/**
+ * @brief Decompresses the graph.
+ * @return The equivalent CSR graph, with every edge list sorted by target.
+ */
+template <typename T>
+BasicCSRGraph<T> BasicCompressedGraph<T>::toCSR() const
+{
+    size_t numVertices = getNumVertices();
+    vector<size_t> targets;
+    targets.reserve(getNumEdges());
+    for (size_t u = 0; u < numVertices; ++u)
+    {
+        for (const Edge &e : neighbors(u))
+        {
+            targets.push_back(e.target);
+        }
+    }
+    return BasicCSRGraph<T>(edgeOffsets, std::move(targets), weights);
+}
+
+template class ariel::BasicCompressedGraph<int>;
+template class ariel::BasicCompressedGraph<int64_t>;
+template class ariel::BasicCompressedGraph<float>;
+template class ariel::BasicCompressedGraph<double>;
+template class ariel::BasicCompressedGraph<uint8_t>;
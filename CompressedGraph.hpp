@@ -0,0 +1,175 @@
+#ifndef COMPRESSEDGRAPH_HPP
+#define COMPRESSEDGRAPH_HPP
+
+#include <cstdint>
+#include <vector>
+#include "Graph.hpp"
+#include "CSRGraph.hpp"
+using namespace std;
+
+namespace ariel
+{
+    /**
+     * @brief A read-only weighted directed graph whose adjacency lists are compressed.
+     * @details The out-neighbors of every vertex are sorted and cut into blocks of BLOCK_SIZE edges. A block stores
+     * its first neighbor in a skip array and the gaps to the following neighbors as LEB128 varints, 7 bits per byte,
+     * so vertices with nearby neighbors, e.g. after reordering, take about one byte per edge instead of eight.
+     * Weights are stored uncompressed. Neighbors are decoded on the fly by NeighborIterator, and the skip array
+     * lets hasEdge jump to the one block that may hold an edge.
+     */
+    template <typename T>
+    class BasicCompressedGraph
+    {
+    public:
+        typedef T Weight;
+        static const size_t BLOCK_SIZE = 64;
+
+        /**
+         * @brief An edge as produced by NeighborIterator.
+         */
+        struct Edge
+        {
+            size_t target;
+            T weight;
+        };
+
+        /**
+         * @brief Iterates over the out-edges of a vertex in increasing order of the target, decoding as it goes.
+         */
+        class NeighborIterator
+        {
+        private:
+            const BasicCompressedGraph *graph;
+            size_t edge;           // index of the current edge among all edges
+            size_t last;           // one past the last edge of the vertex
+            size_t blockEdge;      // position of the current edge inside its block
+            size_t block;          // the current block
+            const uint8_t *cursor; // the next gap to decode
+            Edge current;
+
+            void load();
+
+        public:
+            NeighborIterator(const BasicCompressedGraph *graph, size_t edge, size_t last, size_t block);
+            const Edge &operator*() const { return current; }
+            const Edge *operator->() const { return &current; }
+            NeighborIterator &operator++();
+            bool operator==(const NeighborIterator &other) const { return edge == other.edge; }
+            bool operator!=(const NeighborIterator &other) const { return edge != other.edge; }
+        };
+
+        /**
+         * @brief The out-edges of one vertex, usable in a range-based for loop.
+         */
+        class NeighborRange
+        {
+        private:
+            NeighborIterator first, last;
+
+        public:
+            NeighborRange(NeighborIterator first, NeighborIterator last) : first(first), last(last) {}
+            NeighborIterator begin() const { return first; }
+            NeighborIterator end() const { return last; }
+        };
+
+    private:
+        vector<size_t> edgeOffsets;  // the edges of v are edgeOffsets[v] .. edgeOffsets[v + 1] - 1
+        vector<size_t> vertexBlocks; // the blocks of v are vertexBlocks[v] .. vertexBlocks[v + 1] - 1
+        vector<size_t> blockFirst;   // the first target of every block
+        vector<size_t> blockBytes;   // where the gaps of every block start in bytes
+        vector<uint8_t> bytes;
+        vector<T> weights;
+
+    public:
+        BasicCompressedGraph();
+        explicit BasicCompressedGraph(const BasicCSRGraph<T> &g);
+        explicit BasicCompressedGraph(const BasicGraph<T> &g);
+        size_t getNumVertices() const;
+        size_t getNumEdges() const;
+        size_t degree(size_t v) const;
+        NeighborRange neighbors(size_t v) const;
+        bool hasEdge(size_t from, size_t to) const;
+        size_t compressedBytes() const;
+        BasicCSRGraph<T> toCSR() const;
+    };
+
+    typedef BasicCompressedGraph<int> CompressedGraph;
+
+    /**
+     * @brief Decodes one LEB128 varint and advances the cursor past it.
+     */
+    inline size_t decodeVarint(const uint8_t *&cursor)
+    {
+        size_t value = *cursor++;
+        if (value < 0x80) // most gaps fit one byte
+        {
+            return value;
+        }
+        value &= 0x7f;
+        unsigned shift = 7;
+        uint8_t byte;
+        do
+        {
+            byte = *cursor++;
+            value |= static_cast<size_t>(byte & 0x7f) << shift;
+            shift += 7;
+        } while (byte & 0x80);
+        return value;
+    }
+
+    template <typename T>
+    inline BasicCompressedGraph<T>::NeighborIterator::NeighborIterator(const BasicCompressedGraph *graph, size_t edge, size_t last, size_t block)
+        : graph(graph), edge(edge), last(last), blockEdge(0), block(block), cursor(nullptr)
+    {
+        load();
+    }
+
+    /**
+     * @brief Fills in the current edge, starting a new block every BLOCK_SIZE edges.
+     */
+    template <typename T>
+    inline void BasicCompressedGraph<T>::NeighborIterator::load()
+    {
+        if (edge >= last)
+        {
+            return;
+        }
+        if (blockEdge == 0)
+        {
+            current.target = graph->blockFirst[block];
+            cursor = graph->bytes.data() + graph->blockBytes[block];
+        }
+        else
+        {
+            current.target += decodeVarint(cursor);
+        }
+        current.weight = graph->weights[edge];
+    }
+
+    template <typename T>
+    inline typename BasicCompressedGraph<T>::NeighborIterator &BasicCompressedGraph<T>::NeighborIterator::operator++()
+    {
+        ++edge;
+        if (++blockEdge == BLOCK_SIZE)
+        {
+            blockEdge = 0;
+            ++block;
+        }
+        load();
+        return *this;
+    }
+
+    /**
+     * @brief Gets the out-edges of a vertex.
+     * @param v The vertex.
+     * @return A range over the edges leaving v, sorted by target.
+     */
+    template <typename T>
+    inline typename BasicCompressedGraph<T>::NeighborRange BasicCompressedGraph<T>::neighbors(size_t v) const
+    {
+        size_t first = edgeOffsets[v], last = edgeOffsets[v + 1];
+        return NeighborRange(NeighborIterator(this, first, last, vertexBlocks[v]),
+                             NeighborIterator(this, last, last, vertexBlocks[v + 1]));
+    }
+}
+#endif // COMPRESSEDGRAPH_HPP
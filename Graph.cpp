@@ -1,39 +1,143 @@
+#include <algorithm>
+#include <cstring>
 #include <iostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
 #include "Graph.hpp"
 
 using namespace std;
 using namespace ariel;
 
+/**
+ * @brief The splitmix64 finalizer, a fast bijective mix of 64 bits.
+ */
+static inline uint64_t mix64(uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+/**
+ * @brief The contribution of one cell of the matrix to the fingerprint of a graph.
+ * @param index The position of the cell in the row-major matrix.
+ * @param value The weight in the cell.
+ * @return 0 for an empty cell, including -0.0, which compares equal to 0.
+ */
+template <typename T>
+static inline uint64_t cellMix(size_t index, T value)
+{
+    if (value == T(0))
+    {
+        return 0;
+    }
+    uint64_t bits = 0;
+    memcpy(&bits, &value, sizeof(T));
+    return mix64(bits + 0x9e3779b97f4a7c15ULL * (index + 1));
+}
+
+/**
+ * @brief The value one cell contributes to the hashes of containsGraph, 0 for an empty cell.
+ */
+template <typename T>
+static inline uint64_t cellKey(T value)
+{
+    if (value == T(0))
+    {
+        return 0;
+    }
+    uint64_t bits = 0;
+    memcpy(&bits, &value, sizeof(T));
+    return mix64(bits);
+}
+
+/**
+ * @brief Appends a row at the bottom of a band of column hashes, hash = hash * base + cell.
+ */
+template <typename T>
+static void addRowToBand(uint64_t *columns, const T *row, size_t size, uint64_t base)
+{
+    for (size_t j = 0; j < size; ++j)
+    {
+        columns[j] = columns[j] * base + cellKey(row[j]);
+    }
+}
+
+/**
+ * @brief Drops the top row of a band of column hashes.
+ * @param power The row base to the power of the band height minus one, the weight of the top row.
+ */
+template <typename T>
+static void removeRowFromBand(uint64_t *columns, const T *row, size_t size, uint64_t power)
+{
+    for (size_t j = 0; j < size; ++j)
+    {
+        columns[j] -= cellKey(row[j]) * power;
+    }
+}
+
+/**
+ * @brief Compares two matrices of integers byte by byte, which the library does with vector instructions.
+ */
+template <typename T>
+static bool sameWeights(const T *a, const T *b, size_t count, false_type)
+{
+    return memcmp(a, b, count * sizeof(T)) == 0;
+}
+
+/**
+ * @brief Compares two matrices of floating point weights by value, 0.0 == -0.0 and NaN is never equal.
+ */
+template <typename T>
+static bool sameWeights(const T *a, const T *b, size_t count, true_type)
+{
+    return equal(a, a + count, b);
+}
 
-Graph::Graph() {}  // An empty constructor
 
-Graph::~Graph() {} // A destructor
+template <typename T>
+BasicGraph<T>::BasicGraph() : numvertices(0), mapped(nullptr), cellHash(0), cellHashValid(false), edgeCount(0), asymmetricPairs(0), statsValid(false) {}  // An empty constructor
+
+template <typename T>
+BasicGraph<T>::~BasicGraph() {} // A destructor
 
 /**
  * @brief Constructs a Graph with a given number of vertices.
  * @param size The number of vertices in the graph.
  */
-Graph::Graph(int size) {
-    adjacencymatrix = std::vector<std::vector<int>>(size, std::vector<int>(size, 0));
+template <typename T>
+BasicGraph<T>::BasicGraph(int size) : mapped(nullptr), cellHash(0), cellHashValid(false), edgeCount(0), asymmetricPairs(0), statsValid(false) {
+    numvertices = static_cast<size_t>(size);
+    adjacencymatrix.assign(numvertices * numvertices, T(0));
 }
 
 /**
- * @brief Prints the number of edges and vertices in the graph.
+ * @brief Constructs a read-only view over an adjacency matrix owned by someone else.
+ * @param numVertices The number of vertices in the graph.
+ * @param data numVertices * numVertices weights in row-major order, they are never written through the view.
+ * @param owner Keeps data alive for as long as the view or any copy of it uses it.
  */
-void Graph::printGraph()
+template <typename T>
+BasicGraph<T>::BasicGraph(size_t numVertices, const T *data, shared_ptr<const void> owner)
+    : numvertices(numVertices), mapped(data), backing(std::move(owner)), cellHash(0), cellHashValid(false), edgeCount(0), asymmetricPairs(0), statsValid(false)
 {
-    int numofedges = 0;
-    for (size_t i = 0; i < this->adjacencymatrix.size(); ++i)
+    if (!backing)
     {
-        for (size_t j = 0; j < this->adjacencymatrix[i].size(); ++j)
-        {
-            if (adjacencymatrix[i][j] != 0)
-            {
-                numofedges++;
-            }
-        }
+        throw invalid_argument("a graph view needs an owner for its data");
     }
-    cout << "Graph with " << this->adjacencymatrix.size() << " vertices and " << numofedges << " edges." << endl;
+}
+
+/**
+ * @brief Prints the number of edges and vertices in the graph.
+ */
+template <typename T>
+void BasicGraph<T>::printGraph()
+{
+    cout << "Graph with " << this->numvertices << " vertices and " << numofedges(*this) << " edges." << endl;
 }
 
 /**
@@ -41,7 +145,8 @@ void Graph::printGraph()
  * @param adjmat An adjacency matrix representing the graph to be loaded.
  * @details This function also checks whether the graph is a valid square matrix and throws an exception if it is not.
  */
-void Graph::loadGraph(vector<vector<int>> adjmat)
+template <typename T>
+void BasicGraph<T>::loadGraph(vector<vector<T>> adjmat)
 {
     for (size_t i = 0; i < adjmat.size(); i++)
     {
@@ -50,116 +155,240 @@ void Graph::loadGraph(vector<vector<int>> adjmat)
             throw invalid_argument("Invalid graph: The graph is not a square matrix.");
         }
     }
-    adjacencymatrix = adjmat;
+    numvertices = adjmat.size();
+    mapped = nullptr;
+    backing.reset();
+    cellHashValid = false; // even an empty matrix, which no row write below would invalidate
+    statsValid = false;
+    adjacencymatrix.resize(numvertices * numvertices);
+    for (size_t i = 0; i < numvertices; i++)
+    {
+        copy(adjmat[i].begin(), adjmat[i].end(), mutableRow(i));
+    }
 }
 
 /**
  * @brief Gets the adjacency matrix of the graph.
- * @return A constant reference to the adjacency matrix of the graph.
+ * @return A copy of the adjacency matrix of the graph as nested rows.
+ * @details The graph stores its matrix contiguously, prefer getRow, getEdge or getData on hot paths.
  */
-const vector<vector<int>> &Graph::getAdjacencyMatrix() const
+template <typename T>
+vector<vector<T>> BasicGraph<T>::getAdjacencyMatrix() const
 {
-    return adjacencymatrix;
+    vector<vector<T>> matrix(numvertices);
+    for (size_t i = 0; i < numvertices; i++)
+    {
+        matrix[i].assign(getRow(i), getRow(i) + numvertices);
+    }
+    return matrix;
 }
 
 /**
- * @brief Gets the number of vertices in the graph.
- * @return The number of vertices in the graph.
+ * @brief Sets the weight of an edge, 0 removes it.
+ * @param from The source vertex.
+ * @param to The target vertex.
+ * @param weight The new entry [from][to] of the adjacency matrix.
+ * @throws invalid_argument If a vertex is not in the graph.
  */
-size_t Graph::getNumVertices() const
+template <typename T>
+void BasicGraph<T>::setEdge(size_t from, size_t to, T weight)
 {
-    return adjacencymatrix.size();
+    if (from >= numvertices || to >= numvertices)
+    {
+        throw invalid_argument("the vertex is not in the graph");
+    }
+    bool hashed = cellHashValid;
+    bool counted = statsValid;
+    size_t index = from * numvertices + to;
+    T old = getData()[index];
+    T mirror = getData()[to * numvertices + from];
+    uint64_t change = cellMix(index, weight) - cellMix(index, old);
+    mutableRow(from)[to] = weight;
+    if (hashed)
+    {
+        cellHash += change; // the fingerprint is a sum, so one cell is swapped out in O(1)
+        cellHashValid = true;
+    }
+    if (counted)
+    {
+        if ((old != T(0)) != (weight != T(0)))
+        {
+            size_t added = weight != T(0) ? 1 : 0;
+            edgeCount = edgeCount - 1 + 2 * added;
+            outDegrees[from] = outDegrees[from] - 1 + 2 * added;
+            inDegrees[to] = inDegrees[to] - 1 + 2 * added;
+        }
+        if (from != to)
+        {
+            asymmetricPairs = asymmetricPairs - (old != mirror ? 1 : 0) + (weight != mirror ? 1 : 0);
+        }
+        statsValid = true;
+    }
 }
 
 /**
- * @brief Checks if the current graph and the given graph are both square matrices of the same size.
- * @param mat The graph to compare with.
- * @return True if both graphs are square matrices of the same size, false otherwise.
+ * @brief Gets a 64-bit fingerprint of the graph, equal graphs have equal fingerprints.
+ * @return A hash of the number of vertices and of every non-zero entry with its position.
+ * @details The fingerprint is cached. setEdge adjusts it in constant time and every other modification drops it,
+ * so it is recomputed in one pass over the matrix only when it is asked for again.
  */
-bool Graph::issquared(const Graph &mat) const
+template <typename T>
+uint64_t BasicGraph<T>::fingerprint() const
 {
-    if (this->getNumVertices() != mat.adjacencymatrix.size())
+    if (!cellHashValid)
     {
-        return false;
+        const T *data = getData();
+        uint64_t sum = 0;
+        for (size_t i = 0; i < numvertices * numvertices; ++i)
+        {
+            sum += cellMix(i, data[i]);
+        }
+        cellHash = sum;
+        cellHashValid = true;
     }
+    return mix64(cellHash ^ mix64(numvertices));
+}
 
-    int size = this->getNumVertices();
-    for (int i = 0; i < size; ++i)
+/**
+ * @brief Recomputes the cached edge count, degrees and symmetry in one pass over the matrix, if they were dropped.
+ */
+template <typename T>
+void BasicGraph<T>::updateStats() const
+{
+    if (statsValid)
     {
-        if (this->adjacencymatrix[i].size() != size || mat.adjacencymatrix[i].size() != size)
+        return;
+    }
+    const T *data = getData();
+    edgeCount = 0;
+    asymmetricPairs = 0;
+    outDegrees.assign(numvertices, 0);
+    inDegrees.assign(numvertices, 0);
+    for (size_t i = 0; i < numvertices; ++i)
+    {
+        const T *row = data + i * numvertices;
+        size_t degree = 0;
+        for (size_t j = 0; j < numvertices; ++j)
         {
-            return false;
+            size_t edge = row[j] != T(0) ? 1 : 0;
+            degree += edge;
+            inDegrees[j] += edge;
+        }
+        outDegrees[i] = degree;
+        edgeCount += degree;
+        for (size_t j = i + 1; j < numvertices; ++j)
+        {
+            asymmetricPairs += row[j] != data[j * numvertices + i] ? 1 : 0;
         }
     }
-    return true;
+    statsValid = true;
 }
 
 /**
- * @brief Increments each element in the adjacency matrix by 1 (prefix increment).
- * @return A reference to the modified graph.
+ * @brief Gets the number of edges, the non-zero entries of the matrix.
+ * @return The cached edge count, see updateStats.
+ */
+template <typename T>
+size_t BasicGraph<T>::getNumEdges() const
+{
+    updateStats();
+    return edgeCount;
+}
+
+/**
+ * @brief Gets the number of edges leaving a vertex.
+ * @param v The vertex.
+ * @return The number of non-zero entries in row v.
+ * @throws invalid_argument If the vertex is not in the graph.
  */
-Graph &Graph::operator++()
+template <typename T>
+size_t BasicGraph<T>::getOutDegree(size_t v) const
 {
-    int k = this->getNumVertices();
-    for (int i = 0; i < k; i++)
+    if (v >= numvertices)
     {
-        for (int j = 0; j < k; j++)
-        {
-            this->adjacencymatrix[i][j]++;
-        }
+        throw invalid_argument("the vertex is not in the graph");
     }
-    return *this;
+    updateStats();
+    return outDegrees[v];
 }
 
 /**
- * @brief Increments each element in the adjacency matrix by 1 (postfix increment).
- * @return A reference to the modified graph.
+ * @brief Gets the number of edges entering a vertex.
+ * @param v The vertex.
+ * @return The number of non-zero entries in column v.
+ * @throws invalid_argument If the vertex is not in the graph.
  */
-Graph &Graph::operator++(int)
+template <typename T>
+size_t BasicGraph<T>::getInDegree(size_t v) const
 {
-    int k = this->getNumVertices();
-    for (int i = 0; i < k; i++)
+    if (v >= numvertices)
     {
-        for (int j = 0; j < k; j++)
-        {
-            this->adjacencymatrix[i][j]++;
-        }
+        throw invalid_argument("the vertex is not in the graph");
     }
-    return *this;
+    updateStats();
+    return inDegrees[v];
+}
+
+/**
+ * @brief Checks if the graph is undirected, i.e. its matrix equals its transpose.
+ * @return True if every entry [i][j] equals [j][i].
+ */
+template <typename T>
+bool BasicGraph<T>::isSymmetric() const
+{
+    updateStats();
+    return asymmetricPairs == 0;
+}
+
+/**
+ * @brief Checks if the current graph and the given graph are both square matrices of the same size.
+ * @param mat The graph to compare with.
+ * @return True if both graphs are square matrices of the same size, false otherwise.
+ */
+template <typename T>
+bool BasicGraph<T>::issquared(const BasicGraph &mat) const
+{
+    return this->numvertices == mat.numvertices;
+}
+
+/**
+ * @brief Increments each element in the adjacency matrix by 1 (prefix increment).
+ * @return A reference to the modified graph.
+ */
+template <typename T>
+BasicGraph<T> &BasicGraph<T>::operator++()
+{
+    return increment<Wrapping>();
+}
+
+/**
+ * @brief Increments each element in the adjacency matrix by 1 (postfix increment).
+ * @return A reference to the modified graph.
+ */
+template <typename T>
+BasicGraph<T> &BasicGraph<T>::operator++(int)
+{
+    return increment<Wrapping>();
 }
 
 /**
  * @brief Decrements each element in the adjacency matrix by 1 (postfix decrement).
  * @return A reference to the modified graph.
  */
-Graph &Graph::operator--(int)
+template <typename T>
+BasicGraph<T> &BasicGraph<T>::operator--(int)
 {
-    int k = this->getNumVertices();
-    for (int i = 0; i < k; i++)
-    {
-        for (int j = 0; j < k; j++)
-        {
-            this->adjacencymatrix[i][j]--;
-        }
-    }
-    return *this;
+    return decrement<Wrapping>();
 }
 
 /**
  * @brief Decrements each element in the adjacency matrix by 1 (prefix decrement).
  * @return A reference to the modified graph.
  */
-Graph &Graph::operator--()
+template <typename T>
+BasicGraph<T> &BasicGraph<T>::operator--()
 {
-    int k = this->getNumVertices();
-    for (int i = 0; i < k; i++)
-    {
-        for (int j = 0; j < k; j++)
-        {
-            this->adjacencymatrix[i][j]--;
-        }
-    }
-    return *this;
+    return decrement<Wrapping>();
 }
 
 /**
@@ -167,24 +396,21 @@ Graph &Graph::operator--()
  * @param mat The graph to add.
  * @return A reference to the modified graph.
  * @throws invalid_argument If the dimensions of the matrices do not match.
+ * @details Overflow wraps around like the Wrapping policy.
  */
-Graph &Graph::operator+=(const Graph &mat)
+template <typename T>
+BasicGraph<T> &BasicGraph<T>::operator+=(const BasicGraph &mat)
 {
-    int size = this->getNumVertices();
-    for (int i = 0; i < size; i++)
+    if (!issquared(mat))
     {
-        if (size != mat.adjacencymatrix.size() || size != mat.adjacencymatrix[i].size())
-        {
-            __throw_invalid_argument("non compatible dimensions of the matrix");
-        }
+        throw invalid_argument("non compatible dimensions of the matrix");
     }
 
-    for (int i = 0; i < size; i++)
+    detach();
+    const T *other = mat.getData();
+    for (size_t i = 0; i < adjacencymatrix.size(); i++)
     {
-        for (int j = 0; j < size; j++)
-        {
-            this->adjacencymatrix[i][j] += mat.adjacencymatrix[i][j];
-        }
+        this->adjacencymatrix[i] = ArithmeticTraits<T>::wrapAdd(this->adjacencymatrix[i], other[i]);
     }
 
     return *this;
@@ -195,24 +421,21 @@ Graph &Graph::operator+=(const Graph &mat)
  * @param mat The graph to subtract.
  * @return A reference to the modified graph.
  * @throws invalid_argument If the dimensions of the matrices do not match.
+ * @details Overflow wraps around like the Wrapping policy.
  */
-Graph &Graph::operator-=(const Graph &mat)
+template <typename T>
+BasicGraph<T> &BasicGraph<T>::operator-=(const BasicGraph &mat)
 {
-    int size = this->getNumVertices();
-    for (int i = 0; i < size; i++)
+    if (!issquared(mat))
     {
-        if (size != mat.adjacencymatrix.size() || size != mat.adjacencymatrix[i].size())
-        {
-            __throw_invalid_argument("non compatible dimensions of the matrix");
-        }
+        throw invalid_argument("non compatible dimensions of the matrix");
     }
 
-    for (int i = 0; i < size; i++)
+    detach();
+    const T *other = mat.getData();
+    for (size_t i = 0; i < adjacencymatrix.size(); i++)
     {
-        for (int j = 0; j < size; j++)
-        {
-            this->adjacencymatrix[i][j] -= mat.adjacencymatrix[i][j];
-        }
+        this->adjacencymatrix[i] = ArithmeticTraits<T>::wrapSub(this->adjacencymatrix[i], other[i]);
     }
 
     return *this;
@@ -223,28 +446,12 @@ Graph &Graph::operator-=(const Graph &mat)
  * @param mat The graph to add.
  * @return A new graph with the result of the addition.
  * @throws invalid_argument If the dimensions of the matrices do not match.
+ * @details Overflow wraps around, use add<Saturating>, add<Checked> or add<Widened> for other behaviors.
  */
-Graph Graph::operator+(const Graph &mat)
+template <typename T>
+BasicGraph<T> BasicGraph<T>::operator+(const BasicGraph &mat)
 {
-    for (size_t i = 0; i < this->adjacencymatrix.size(); i++)
-    {
-        if (this->adjacencymatrix.size() != mat.adjacencymatrix.size() || this->adjacencymatrix.size() != mat.adjacencymatrix[i].size())
-        {
-            __throw_invalid_argument("dimensions do not correlate with each other!");
-        }
-    }
-    vector<vector<int>> newadj(this->getNumVertices(), vector<int>(this->getNumVertices(), 0));
-    Graph g;
-
-    for (size_t i = 0; i < this->adjacencymatrix.size(); i++)
-    {
-        for (size_t j = 0; j < this->adjacencymatrix.size(); j++)
-        {
-            newadj[i][j] = this->adjacencymatrix[i][j] + mat.adjacencymatrix[i][j];
-        }
-    }
-    g.adjacencymatrix = newadj;
-    return g;
+    return add<Wrapping>(mat);
 }
 
 /**
@@ -252,14 +459,13 @@ Graph Graph::operator+(const Graph &mat)
  * @param k The scalar to divide by.
  * @return A reference to the modified graph.
  */
-Graph &Graph::operator/=(int k)
+template <typename T>
+BasicGraph<T> &BasicGraph<T>::operator/=(int k)
 {
-    for (int i = 0; i < this->adjacencymatrix.size(); i++)
+    detach();
+    for (size_t i = 0; i < adjacencymatrix.size(); i++)
     {
-        for (int j = 0; j < this->adjacencymatrix.size(); j++)
-        {
-            this->adjacencymatrix[i][j] /= k;
-        }
+        this->adjacencymatrix[i] = static_cast<T>(this->adjacencymatrix[i] / k);
     }
 
     return *this;
@@ -270,27 +476,22 @@ Graph &Graph::operator/=(int k)
  * @param mat The graph to subtract.
  * @return A new graph with the result of the subtraction.
  * @throws invalid_argument If the dimensions of the matrices do not match.
+ * @details Overflow wraps around like the Wrapping policy.
  */
-Graph Graph::operator-(const Graph &mat)
+template <typename T>
+BasicGraph<T> BasicGraph<T>::operator-(const BasicGraph &mat)
 {
-    vector<vector<int>> newadj(this->getNumVertices(), vector<int>(this->getNumVertices(), 0));
-    Graph g;
-    for (size_t i = 0; i < this->adjacencymatrix.size(); i++)
+    if (!issquared(mat))
     {
-        if (this->adjacencymatrix.size() != mat.adjacencymatrix.size() || this->adjacencymatrix.size() != mat.adjacencymatrix[i].size())
-        {
-            __throw_invalid_argument("dimensions do not correlate with each other!");
-        }
+        throw invalid_argument("dimensions do not correlate with each other!");
     }
-
-    for (size_t i = 0; i < this->adjacencymatrix.size(); i++)
+    BasicGraph g(static_cast<int>(numvertices));
+    const T *a = getData();
+    const T *b = mat.getData();
+    for (size_t i = 0; i < g.adjacencymatrix.size(); i++)
     {
-        for (size_t j = 0; j < this->adjacencymatrix.size(); j++)
-        {
-            newadj[i][j] = this->adjacencymatrix[i][j] - mat.adjacencymatrix[i][j];
-        }
+        g.adjacencymatrix[i] = ArithmeticTraits<T>::wrapSub(a[i], b[i]);
     }
-    g.adjacencymatrix = newadj;
     return g;
 }
 
@@ -298,7 +499,8 @@ Graph Graph::operator-(const Graph &mat)
  * @brief Unary plus operator, returns the graph as is.
  * @return A reference to the graph.
  */
-Graph &Graph::operator+()
+template <typename T>
+BasicGraph<T> &BasicGraph<T>::operator+()
 {
     return *this;
 }
@@ -306,98 +508,331 @@ Graph &Graph::operator+()
 /**
  * @brief Unary minus operator, negates each element in the adjacency matrix.
  * @return A reference to the modified graph.
+ * @details Negating the lowest integer wraps around to itself like the Wrapping policy.
+ */
+template <typename T>
+BasicGraph<T> &BasicGraph<T>::operator-()
+{
+    return scale<Wrapping>(static_cast<T>(-1));
+}
+
+/**
+ * @brief Multiplies the adjacency matrices of two graphs and returns the result as a new graph.
+ * @param mat The graph to multiply with.
+ * @return A new graph with the result of the multiplication.
+ * @throws invalid_argument If the dimensions of the matrices do not match.
+ * @details This is the product over the ordinary (+, *) semiring, see Graph::product.
  */
-Graph &Graph::operator-()
+template <typename T>
+BasicGraph<T> BasicGraph<T>::operator*(const BasicGraph &mat)
 {
-    for (size_t i = 0; i < this->adjacencymatrix.size(); i++)
+    return product(mat, PlusTimes());
+}
+
+/**
+ * @brief Adds the adjacency matrix of another graph to this graph under an arithmetic policy.
+ * @param mat The graph to add.
+ * @return A new graph with the result of the addition.
+ * @throws invalid_argument If the dimensions of the matrices do not match.
+ * @throws overflow_error If an entry overflows and the policy reports overflow.
+ */
+template <typename T>
+template <typename P>
+BasicGraph<T> BasicGraph<T>::add(const BasicGraph &mat) const
+{
+    if (!issquared(mat))
     {
-        for (size_t j = 0; j < this->adjacencymatrix.size(); j++)
-        {
-            this->adjacencymatrix[i][j] = -this->adjacencymatrix[i][j];
-        }
+        throw invalid_argument("dimensions do not correlate with each other!");
     }
-    return *this;
+    BasicGraph g(static_cast<int>(numvertices));
+    const T *a = getData();
+    const T *b = mat.getData();
+    T *c = g.adjacencymatrix.data();
+    int overflow = 0;
+    for (size_t i = 0; i < g.adjacencymatrix.size(); i++)
+    {
+        c[i] = P::add(a[i], b[i], overflow);
+    }
+    if (overflow)
+    {
+        throw overflow_error("integer overflow in graph addition");
+    }
+    return g;
 }
 
 /**
- * @brief Multiplies the adjacency matrices of two graphs and returns the result as a new graph.
+ * @brief Multiplies the adjacency matrices of two graphs under an arithmetic policy.
  * @param mat The graph to multiply with.
+ * @param threads The number of threads to use, 0 for the hardware concurrency.
  * @return A new graph with the result of the multiplication.
  * @throws invalid_argument If the dimensions of the matrices do not match.
+ * @throws overflow_error If an entry overflows and the policy reports overflow.
+ * @details Wrapping products are exactly the (+, *) semiring, so they take the blocked semiring kernel.
  */
-Graph Graph::operator*(const Graph &mat)
+template <typename T>
+template <typename P>
+BasicGraph<T> BasicGraph<T>::multiply(const BasicGraph &mat, size_t threads) const
 {
+    if (is_same<P, Wrapping>::value)
+    {
+        return product(mat, PlusTimes(), threads);
+    }
     if (!issquared(mat))
     {
-        __throw_invalid_argument("dimensions of the matrices do not correlate");
+        throw invalid_argument("dimensions of the matrices do not correlate");
+    }
+    BasicGraph g(static_cast<int>(numvertices));
+    vector<const T *> left(numvertices), right(numvertices);
+    vector<T *> result(numvertices);
+    for (size_t i = 0; i < numvertices; ++i)
+    {
+        left[i] = getRow(i);
+        right[i] = mat.getRow(i);
+        result[i] = g.mutableRow(i);
     }
-    int size = this->adjacencymatrix.size();
-    vector<vector<int>> newadj(this->getNumVertices(), vector<int>(this->getNumVertices(), 0));
-    // Perform matrix multiplication
-    for (int i = 0; i < size; ++i)
+    if (policyProduct<P>(left.data(), right.data(), result.data(), numvertices, threads))
     {
-        for (int j = 0; j < size; ++j)
+        throw overflow_error("integer overflow in graph multiplication");
+    }
+    return g;
+}
+
+/**
+ * @brief Applies op to every entry of the matrix in place, all or nothing.
+ * @param matrix The entries to update.
+ * @param op Callable (T value, int &overflow) -> T in the style of the arithmetic policies.
+ * @param checked Whether op may report overflow.
+ * @param what The name of the operation for the error message.
+ * @throws overflow_error If op reports overflow, the matrix is left unchanged in that case.
+ * @details When the operation may overflow a first pass only computes the overflow flags,
+ * so the matrix is never left half updated.
+ */
+template <typename T, typename Op>
+static void applyInPlace(vector<T> &matrix, Op op, bool checked, const char *what)
+{
+    if (checked)
+    {
+        int overflow = 0;
+        for (size_t i = 0; i < matrix.size(); i++)
         {
-            for (int k = 0; k < size; ++k)
-            {
-                newadj[i][j] += this->adjacencymatrix[i][k] * mat.adjacencymatrix[k][j];
-            }
+            op(matrix[i], overflow);
+        }
+        if (overflow)
+        {
+            throw overflow_error(string("integer overflow in graph ") + what);
         }
     }
-    Graph g;
-    g.adjacencymatrix = newadj;
-    return g;
+    int ignored = 0;
+    for (size_t i = 0; i < matrix.size(); i++)
+    {
+        matrix[i] = op(matrix[i], ignored);
+    }
 }
 
 /**
- * @brief Multiplies each element in the adjacency matrix by a scalar.
+ * @brief Multiplies each element in the adjacency matrix by a scalar under an arithmetic policy.
  * @param scalar The scalar to multiply by.
  * @return A reference to the modified graph.
+ * @throws overflow_error If an entry overflows and the policy reports overflow, the graph is left unchanged.
  */
-Graph& Graph::operator*=(int scalar)
+template <typename T>
+template <typename P>
+BasicGraph<T> &BasicGraph<T>::scale(T scalar)
 {
-    int size = this->adjacencymatrix.size();
-    for (int i = 0; i < size; ++i)
+    detach();
+    applyInPlace(adjacencymatrix, [scalar](T value, int &overflow)
+                 { return P::mul(value, scalar, overflow); },
+                 P::reportsOverflow, "scaling");
+    return *this;
+}
+
+/**
+ * @brief Adds 1 to each element in the adjacency matrix under an arithmetic policy.
+ * @return A reference to the modified graph.
+ * @throws overflow_error If an entry overflows and the policy reports overflow, the graph is left unchanged.
+ */
+template <typename T>
+template <typename P>
+BasicGraph<T> &BasicGraph<T>::increment()
+{
+    detach();
+    applyInPlace(adjacencymatrix, [](T value, int &overflow)
+                 { return P::add(value, T(1), overflow); },
+                 P::reportsOverflow, "increment");
+    return *this;
+}
+
+/**
+ * @brief Subtracts 1 from each element in the adjacency matrix under an arithmetic policy.
+ * @return A reference to the modified graph.
+ * @throws overflow_error If an entry overflows and the policy reports overflow, the graph is left unchanged.
+ */
+template <typename T>
+template <typename P>
+BasicGraph<T> &BasicGraph<T>::decrement()
+{
+    detach();
+    applyInPlace(adjacencymatrix, [](T value, int &overflow)
+                 { return P::sub(value, T(1), overflow); },
+                 P::reportsOverflow, "decrement");
+    return *this;
+}
+
+/**
+ * @brief Raises the adjacency matrix to the k-th power using exponentiation by squaring.
+ * @param k The exponent, 0 gives the identity matrix.
+ * @return A new graph whose entry [i][j] counts the walks of length k from i to j.
+ */
+template <typename T>
+BasicGraph<T> BasicGraph<T>::pow(unsigned long long k) const
+{
+    return power(k, PlusTimes());
+}
+
+/**
+ * @brief Converts the adjacency matrix to the distance matrix the MinPlus semiring works on.
+ * @return A new graph with 0 on the diagonal, the weight of every edge, and numeric_limits<T>::max(),
+ * the MinPlus "no path", wherever there is no edge. A negative self-loop keeps its weight.
+ * @details Squaring the result with product<MinPlus> ceil(log2(n - 1)) times gives the shortest distances.
+ */
+template <typename T>
+BasicGraph<T> BasicGraph<T>::distanceMatrix() const
+{
+    BasicGraph g(static_cast<int>(numvertices));
+    const T *a = getData();
+    T *d = g.adjacencymatrix.data();
+    for (size_t i = 0; i < numvertices; i++)
     {
-        for (int j = 0; j < size; ++j)
+        for (size_t j = 0; j < numvertices; j++)
         {
-            this -> adjacencymatrix[i][j]*=scalar;
+            T w = a[i * numvertices + j];
+            if (i == j)
+            {
+                d[i * numvertices + j] = w < T(0) ? w : T(0);
+            }
+            else
+            {
+                d[i * numvertices + j] = w == T(0) ? numeric_limits<T>::max() : w;
+            }
         }
     }
-    return *this;
+    return g;
 }
 
 /**
- * @brief Multiplies each element in the adjacency matrix by a scalar and returns the result as a new graph.
- * @param k The scalar to multiply by.
- * @return A reference to the modified graph.
+ * @brief Raises the adjacency matrix to the k-th power modulo a positive modulus.
+ * @param k The exponent, 0 gives the identity matrix.
+ * @param modulus The modulus, every entry of the result is in [0, modulus).
+ * @return A new graph whose entry [i][j] counts the walks of length k from i to j, modulo modulus.
+ * @throws invalid_argument If the modulus is not positive, does not fit the weight type,
+ * or the weight type is not an integer type.
+ * @details Intermediate values are reduced after every operation so walk counts never overflow.
  */
-Graph &Graph::operator*(int k)
+template <typename T>
+BasicGraph<T> BasicGraph<T>::pow(unsigned long long k, int modulus) const
 {
-    for (size_t i = 0; i < this->getNumVertices(); i++)
+    if (!numeric_limits<T>::is_integer)
+    {
+        throw invalid_argument("modular powers need an integer weight type");
+    }
+    if (modulus <= 0 || static_cast<long long>(modulus) - 1 > static_cast<long long>(numeric_limits<T>::max()))
+    {
+        throw invalid_argument("the modulus must be positive and fit the weight type");
+    }
+    ModPlusTimes ring(modulus);
+    BasicGraph base(*this);
+    base.detach();
+    for (size_t i = 0; i < base.adjacencymatrix.size(); i++)
     {
-        for (size_t j = 0; j < this->getNumVertices(); j++)
+        base.adjacencymatrix[i] = ring.reduce(base.adjacencymatrix[i]);
+    }
+    return base.power(k, ring);
+}
+
+/**
+ * @brief Raises the adjacency matrix to the k-th power over a semiring.
+ * @param k The exponent.
+ * @param semiring The semiring to multiply in.
+ * @return A new graph holding the power.
+ * @details Three matrices are allocated up front, the result, the running square and a scratch matrix,
+ * together with their row pointers. Every product is written into the scratch matrix which is then swapped,
+ * storage and row pointers alike, with its destination, so no matrix is reallocated during the O(log k)
+ * multiplications. Each multiplication still starts its own worker threads, see semiringProduct.
+ */
+template <typename T>
+template <typename S>
+BasicGraph<T> BasicGraph<T>::power(unsigned long long k, const S &semiring) const
+{
+    int size = static_cast<int>(numvertices);
+    BasicGraph result(size), base(*this), scratch(size);
+    base.detach();
+    vector<T *> resultRows(numvertices), baseRows(numvertices), scratchRows(numvertices);
+    for (size_t i = 0; i < numvertices; i++)
+    {
+        resultRows[i] = result.mutableRow(i);
+        baseRows[i] = base.mutableRow(i);
+        scratchRows[i] = scratch.mutableRow(i);
+        for (size_t j = 0; j < numvertices; j++)
         {
-            this->adjacencymatrix[i][j] = k * this->adjacencymatrix[i][j];
+            resultRows[i][j] = i == j ? semiring.template one<T>() : semiring.template zero<T>();
         }
     }
-    return *this;
+
+    while (k > 0)
+    {
+        if (k & 1)
+        {
+            semiringProduct(semiring, resultRows.data(), baseRows.data(), scratchRows.data(), numvertices, 0);
+            result.adjacencymatrix.swap(scratch.adjacencymatrix);
+            resultRows.swap(scratchRows);
+        }
+        k >>= 1;
+        if (k > 0)
+        {
+            semiringProduct(semiring, baseRows.data(), baseRows.data(), scratchRows.data(), numvertices, 0);
+            base.adjacencymatrix.swap(scratch.adjacencymatrix);
+            baseRows.swap(scratchRows);
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Multiplies each element in the adjacency matrix by a scalar.
+ * @param scalar The scalar to multiply by.
+ * @return A reference to the modified graph.
+ */
+template <typename T>
+BasicGraph<T> &BasicGraph<T>::operator*=(int scalar)
+{
+    return scale<Wrapping>(static_cast<T>(scalar));
+}
+
+/**
+ * @brief Multiplies each element in the adjacency matrix by a scalar and returns the result as a new graph.
+ * @param k The scalar to multiply by.
+ * @return A reference to the modified graph.
+ * @details Overflow wraps around like the Wrapping policy.
+ */
+template <typename T>
+BasicGraph<T> &BasicGraph<T>::operator*(int k)
+{
+    return scale<Wrapping>(static_cast<T>(k));
 }
 
 /**
  * @brief Divides each element in the adjacency matrix by a scalar and returns the result as a new graph.
  * @param k The scalar to divide by.
  * @return A reference to the modified graph.
+ * @details Integer weights are truncated toward zero, floating point weights are divided exactly.
  */
-Graph &Graph::operator/(int k)
+template <typename T>
+BasicGraph<T> &BasicGraph<T>::operator/(int k)
 {
-    double t = 1.0 / k;
-    for (size_t i = 0; i < this->getNumVertices(); i++)
+    detach();
+    for (size_t i = 0; i < adjacencymatrix.size(); i++)
     {
-        for (size_t j = 0; j < this->getNumVertices(); j++)
-        {
-            this->adjacencymatrix[i][j] = t * this->adjacencymatrix[i][j];
-        }
+        this->adjacencymatrix[i] = static_cast<T>(this->adjacencymatrix[i] / k);
     }
     return *this;
 }
@@ -406,65 +841,94 @@ Graph &Graph::operator/(int k)
  * @brief Checks if the graph contains another graph's adjacency matrix as a sub-matrix.
  * @param other The graph to check against.
  * @return True if this graph contains the other graph, false otherwise.
+ * @details A two-dimensional Rabin-Karp search. Every column of an m-row band of this matrix is hashed, the band
+ * slides down one row at a time, and an m-wide window slides along the column hashes, so every m x m window is
+ * hashed in O(1) and the whole search takes O(n^2) instead of O(n^2 m^2). Only windows whose hash equals the hash
+ * of the other matrix are compared cell by cell. A graph with fewer edges can never contain one with more.
  */
-bool Graph::containsGraph(const Graph &other) const
+template <typename T>
+bool BasicGraph<T>::containsGraph(const BasicGraph &other) const
 {
-    vector<vector<int>> thisMatrix = this->getAdjacencyMatrix();
-    vector<vector<int>> otherMatrix = other.getAdjacencyMatrix();
     size_t thisSize = this->getNumVertices();
     size_t otherSize = other.getNumVertices();
 
-    if (thisSize < otherSize)
+    if (thisSize < otherSize || getNumEdges() < other.getNumEdges())
     {
         return false;
     }
+    if (otherSize == 0)
+    {
+        return true;
+    }
+
+    const uint64_t rowBase = 0x100000001b3ULL, columnBase = 0x9e3779b97f4a7c15ULL;
+    uint64_t rowPower = 1, columnPower = 1; // the bases to the power otherSize - 1
+    for (size_t k = 1; k < otherSize; ++k)
+    {
+        rowPower *= rowBase;
+        columnPower *= columnBase;
+    }
+
+    // The hash of the pattern, built the same way as the windows
+    vector<uint64_t> columns(thisSize, 0);
+    for (size_t m = 0; m < otherSize; ++m)
+    {
+        addRowToBand(columns.data(), other.getRow(m), otherSize, rowBase);
+    }
+    uint64_t pattern = 0;
+    for (size_t j = 0; j < otherSize; ++j)
+    {
+        pattern = pattern * columnBase + columns[j];
+    }
 
-    for (size_t i = 0; i <= thisSize - otherSize; ++i)
+    fill(columns.begin(), columns.end(), 0);
+    for (size_t m = 0; m + 1 < otherSize; ++m)
+    {
+        addRowToBand(columns.data(), getRow(m), thisSize, rowBase);
+    }
+    for (size_t i = 0; i + otherSize <= thisSize; ++i)
     {
-        for (size_t j = 0; j <= thisSize - otherSize; ++j)
+        addRowToBand(columns.data(), getRow(i + otherSize - 1), thisSize, rowBase);
+        uint64_t window = 0;
+        for (size_t j = 0; j < otherSize; ++j)
+        {
+            window = window * columnBase + columns[j];
+        }
+        for (size_t j = 0;; ++j)
         {
-            bool subMatrixFound = true;
-            for (size_t m = 0; m < otherSize; ++m)
+            if (window == pattern)
             {
-                for (size_t n = 0; n < otherSize; ++n)
+                bool subMatrixFound = true;
+                for (size_t m = 0; m < otherSize && subMatrixFound; ++m)
                 {
-                    if (thisMatrix[i + m][j + n] != otherMatrix[m][n])
-                    {
-                        subMatrixFound = false;
-                        break;
-                    }
+                    subMatrixFound = equal(other.getRow(m), other.getRow(m) + otherSize, getRow(i + m) + j);
                 }
-                if (!subMatrixFound)
+                if (subMatrixFound)
                 {
-                    break;
+                    return true;
                 }
             }
-            if (subMatrixFound)
+            if (j + otherSize == thisSize)
             {
-                return true;
+                break;
             }
+            window = (window - columns[j] * columnPower) * columnBase + columns[j + otherSize];
         }
+        removeRowFromBand(columns.data(), getRow(i), thisSize, rowPower);
     }
 
     return false;
 }
 
 /**
- * @brief Counts the number of edges in the graph.
+ * @brief Counts the number of edges in a graph.
  * @param other The graph to count edges for.
- * @return The number of edges in the graph.
+ * @return The number of edges in other, taken from its cache.
  */
-int Graph::numofedges(const Graph &other) const
+template <typename T>
+int BasicGraph<T>::numofedges(const BasicGraph &other) const
 {
-    int count = 0;
-    for (size_t i = 0; i < this->adjacencymatrix.size(); i++)
-    {
-        for (size_t j = 0; j < this->adjacencymatrix.size(); j++)
-        {
-            count += (this->adjacencymatrix[i][j]) ? 1 : 0;
-        }
-    }
-    return count;
+    return static_cast<int>(other.getNumEdges());
 }
 
 /**
@@ -472,7 +936,8 @@ int Graph::numofedges(const Graph &other) const
  * @param mat The graph to compare with.
  * @return True if this graph is greater than or equal to the other graph, false otherwise.
  */
-bool Graph::operator>=(const Graph &mat) const
+template <typename T>
+bool BasicGraph<T>::operator>=(const BasicGraph &mat) const
 {
     return *this > mat || *this == mat;
 }
@@ -482,7 +947,8 @@ bool Graph::operator>=(const Graph &mat) const
  * @param mat The graph to compare with.
  * @return True if this graph is less than or equal to the other graph, false otherwise.
  */
-bool Graph::operator<=(const Graph &mat) const
+template <typename T>
+bool BasicGraph<T>::operator<=(const BasicGraph &mat) const
 {
     return *this < mat || *this == mat;
 }
@@ -492,7 +958,8 @@ bool Graph::operator<=(const Graph &mat) const
  * @param mat The graph to compare with.
  * @return True if this graph is less than the other graph, false otherwise.
  */
-bool Graph::operator<(const Graph &mat) const
+template <typename T>
+bool BasicGraph<T>::operator<(const BasicGraph &mat) const
 {
     if (mat.containsGraph(*this))
     {
@@ -513,7 +980,7 @@ bool Graph::operator<(const Graph &mat) const
     {
         return true;
     }
-    if (numofedges(*this) == mat.numofedges(mat) && adjacencymatrix.size() < mat.adjacencymatrix.size())
+    if (numofedges(*this) == mat.numofedges(mat) && numvertices < mat.numvertices)
     {
         return true;
     }
@@ -525,7 +992,8 @@ bool Graph::operator<(const Graph &mat) const
  * @param mat The graph to compare with.
  * @return True if this graph is greater than the other graph, false otherwise.
  */
-bool Graph::operator>(const Graph &mat) const
+template <typename T>
+bool BasicGraph<T>::operator>(const BasicGraph &mat) const
 {
     if (containsGraph(mat))
     {
@@ -543,7 +1011,7 @@ bool Graph::operator>(const Graph &mat) const
     {
         return true;
     }
-    if (numofedges(*this) == numofedges(mat) && adjacencymatrix.size() >= mat.adjacencymatrix.size())
+    if (numofedges(*this) == numofedges(mat) && numvertices >= mat.numvertices)
     {
         return true;
     }
@@ -553,27 +1021,18 @@ bool Graph::operator>(const Graph &mat) const
 /**
  * @brief Checks if this graph is equal to another graph.
  * @param mat The graph to compare with.
- * @return True if the graphs are equal, false otherwise.
- * @throws invalid_argument If the dimensions of the matrices do not match.
+ * @return True if the graphs are equal, false otherwise, also when their sizes differ.
+ * @details Different fingerprints decide most unequal pairs without reading the matrices, which are only
+ * compared when the fingerprints match.
  */
-bool Graph::operator==(const Graph &mat) const
+template <typename T>
+bool BasicGraph<T>::operator==(const BasicGraph &mat) const
 {
-    if (!issquared(mat))
-    {
-        __throw_invalid_argument("non compatible dimensions");
-    }
-    int size = this->adjacencymatrix.size();
-    for (int i = 0; i < size; i++)
+    if (!issquared(mat) || fingerprint() != mat.fingerprint())
     {
-        for (int j = 0; j < size; j++)
-        {
-            if (this->adjacencymatrix[i][j] != mat.adjacencymatrix[i][j])
-            {
-                return false;
-            }
-        }
+        return false;
     }
-    return true;
+    return sameWeights(getData(), mat.getData(), numvertices * numvertices, is_floating_point<T>());
 }
 
 /**
@@ -581,8 +1040,38 @@ bool Graph::operator==(const Graph &mat) const
  * @param mat The graph to compare with.
  * @return True if the graphs are not equal, false otherwise.
  */
-bool Graph::operator!=(const Graph &mat) const
+template <typename T>
+bool BasicGraph<T>::operator!=(const BasicGraph &mat) const
 {
     return !(*this == mat);
 }
 
+// Explicit instantiations for the supported weight types
+#define ARIEL_INSTANTIATE_GRAPH(T) \
+    template class ariel::BasicGraph<T>; \
+    template BasicGraph<T> BasicGraph<T>::add<Wrapping>(const BasicGraph<T> &) const; \
+    template BasicGraph<T> BasicGraph<T>::add<Saturating>(const BasicGraph<T> &) const; \
+    template BasicGraph<T> BasicGraph<T>::add<Checked>(const BasicGraph<T> &) const; \
+    template BasicGraph<T> BasicGraph<T>::add<Widened>(const BasicGraph<T> &) const; \
+    template BasicGraph<T> BasicGraph<T>::multiply<Wrapping>(const BasicGraph<T> &, size_t) const; \
+    template BasicGraph<T> BasicGraph<T>::multiply<Saturating>(const BasicGraph<T> &, size_t) const; \
+    template BasicGraph<T> BasicGraph<T>::multiply<Checked>(const BasicGraph<T> &, size_t) const; \
+    template BasicGraph<T> BasicGraph<T>::multiply<Widened>(const BasicGraph<T> &, size_t) const; \
+    template BasicGraph<T> &BasicGraph<T>::scale<Wrapping>(T); \
+    template BasicGraph<T> &BasicGraph<T>::scale<Saturating>(T); \
+    template BasicGraph<T> &BasicGraph<T>::scale<Checked>(T); \
+    template BasicGraph<T> &BasicGraph<T>::scale<Widened>(T); \
+    template BasicGraph<T> &BasicGraph<T>::increment<Wrapping>(); \
+    template BasicGraph<T> &BasicGraph<T>::increment<Saturating>(); \
+    template BasicGraph<T> &BasicGraph<T>::increment<Checked>(); \
+    template BasicGraph<T> &BasicGraph<T>::increment<Widened>(); \
+    template BasicGraph<T> &BasicGraph<T>::decrement<Wrapping>(); \
+    template BasicGraph<T> &BasicGraph<T>::decrement<Saturating>(); \
+    template BasicGraph<T> &BasicGraph<T>::decrement<Checked>(); \
+    template BasicGraph<T> &BasicGraph<T>::decrement<Widened>();
+
+ARIEL_INSTANTIATE_GRAPH(int)
+ARIEL_INSTANTIATE_GRAPH(int64_t)
+ARIEL_INSTANTIATE_GRAPH(float)
+ARIEL_INSTANTIATE_GRAPH(double)
+ARIEL_INSTANTIATE_GRAPH(uint8_t)
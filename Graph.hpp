@@ -1,66 +1,136 @@
 #ifndef GRAPH_HPP
 #define GRAPH_HPP
 
+#include <cstdint>
 #include <iostream>
+#include <memory>
+#include <stdexcept>
 #include <vector>
+#include "Arithmetic.hpp"
+#include "Semiring.hpp"
 using namespace std;
 
 namespace ariel
 {
-    class Graph
+    class GraphIO;
+
+    /**
+     * @brief A weighted directed graph stored as a dense adjacency matrix, a non-zero entry is an edge.
+     * @details The matrix is kept in one contiguous row-major array, so narrow weight types give denser storage
+     * and more SIMD lanes per instruction. The class is explicitly instantiated in Graph.cpp for
+     * int, int64_t, float, double and uint8_t, and Graph is the int instantiation.
+     *
+     * A graph may also be a read-only view over memory it does not own, e.g. a memory-mapped file (see GraphIO).
+     * Copies of a view share that memory, and the first operation that modifies a view copies the matrix
+     * into storage of its own, so the viewed memory is never written.
+     *
+     * The graph caches a 64-bit fingerprint of its matrix that decides most comparisons without reading it,
+     * and its edge count, degrees and symmetry, which make the statistics and the ordering operators O(1).
+     * The cache makes const member functions write to the object, so like the standard containers a graph must
+     * not be compared from several threads at once while it is being modified.
+     */
+    template <typename T>
+    class BasicGraph
     {
+        friend class GraphIO; // the loaders write straight into the matrix
+
     private:
-        vector<vector<int>> adjacencymatrix;
-        bool issquared(const Graph &other) const;
-        bool containsGraph(const Graph &other) const;
-        int numofedges(const Graph &other) const;
+        size_t numvertices;
+        vector<T> adjacencymatrix;
+        const T *mapped;                // the viewed matrix, only meaningful while backing is set
+        shared_ptr<const void> backing; // keeps the viewed memory alive, empty when the graph owns its matrix
+        mutable uint64_t cellHash;      // the sum of the mixes of all non-zero cells, see fingerprint
+        mutable bool cellHashValid;     // cleared by every modification except setEdge, which adjusts cellHash
+        mutable size_t edgeCount;       // the statistics below are cached the same way as cellHash
+        mutable vector<size_t> outDegrees;
+        mutable vector<size_t> inDegrees;
+        mutable size_t asymmetricPairs; // pairs i < j with [i][j] != [j][i]
+        mutable bool statsValid;
+        void detach();
+        bool issquared(const BasicGraph &other) const;
+        int numofedges(const BasicGraph &other) const;
+        void updateStats() const;
+        T *mutableRow(size_t i);
+        template <typename S>
+        static void productInto(const BasicGraph &a, const BasicGraph &b, BasicGraph &out, const S &semiring, size_t threads);
+        template <typename S>
+        BasicGraph power(unsigned long long k, const S &semiring) const;
 
     public:
-        Graph();
-        Graph(int);
-        ~Graph();
+        typedef T Weight;
+
+        BasicGraph();
+        BasicGraph(int);
+        BasicGraph(size_t numVertices, const T *data, shared_ptr<const void> owner);
+        ~BasicGraph();
+        bool isView() const;
         void printGraph();
-        void loadGraph(vector<vector<int>> adjmat);
-        const vector<vector<int>> &getAdjacencyMatrix() const;
+        void loadGraph(vector<vector<T>> adjmat);
+        vector<vector<T>> getAdjacencyMatrix() const;
+        const T *getRow(size_t i) const;
+        T getEdge(size_t from, size_t to) const;
+        void setEdge(size_t from, size_t to, T weight);
+        const T *getData() const;
         size_t getNumVertices() const;
-        Graph &operator++();
-        Graph &operator+();
-        Graph &operator-();
-        Graph &operator++(int);
-        Graph &operator--();
-        Graph &operator--(int);
-        Graph &operator-=(const Graph &mat);
-        Graph &operator+=(const Graph &mat);
-        Graph &operator*=(int scalar);
-        Graph &operator/=(int scalar);
-        Graph operator+(const Graph &mat);
-        Graph operator-(const Graph &mat);
-        Graph operator*(const Graph &mat);
-        Graph &operator*(int);
-        Graph &operator/(int);
-        bool operator==(const Graph &mat) const;
-        bool operator>=(const Graph &mat) const;
-        bool operator<=(const Graph &mat) const;
-        bool operator!=(const Graph &mat) const;
-        bool operator<(const Graph &mat) const;
-        bool operator>(const Graph &mat) const;
-
-        friend ostream &operator<<(ostream &os, const Graph &graph)
+        uint64_t fingerprint() const;
+        size_t getNumEdges() const;
+        size_t getOutDegree(size_t v) const;
+        size_t getInDegree(size_t v) const;
+        bool isSymmetric() const;
+        bool containsGraph(const BasicGraph &other) const;
+        BasicGraph &operator++();
+        BasicGraph &operator+();
+        BasicGraph &operator-();
+        BasicGraph &operator++(int);
+        BasicGraph &operator--();
+        BasicGraph &operator--(int);
+        BasicGraph &operator-=(const BasicGraph &mat);
+        BasicGraph &operator+=(const BasicGraph &mat);
+        BasicGraph &operator*=(int scalar);
+        BasicGraph &operator/=(int scalar);
+        BasicGraph operator+(const BasicGraph &mat);
+        BasicGraph operator-(const BasicGraph &mat);
+        BasicGraph operator*(const BasicGraph &mat);
+        template <typename S>
+        BasicGraph product(const BasicGraph &mat, const S &semiring = S(), size_t threads = 0) const;
+        BasicGraph pow(unsigned long long k) const;
+        BasicGraph pow(unsigned long long k, int modulus) const;
+        BasicGraph distanceMatrix() const;
+        template <typename P>
+        BasicGraph add(const BasicGraph &mat) const;
+        template <typename P>
+        BasicGraph multiply(const BasicGraph &mat, size_t threads = 0) const;
+        template <typename P>
+        BasicGraph &scale(T scalar);
+        template <typename P>
+        BasicGraph &increment();
+        template <typename P>
+        BasicGraph &decrement();
+        BasicGraph &operator*(int);
+        BasicGraph &operator/(int);
+        bool operator==(const BasicGraph &mat) const;
+        bool operator>=(const BasicGraph &mat) const;
+        bool operator<=(const BasicGraph &mat) const;
+        bool operator!=(const BasicGraph &mat) const;
+        bool operator<(const BasicGraph &mat) const;
+        bool operator>(const BasicGraph &mat) const;
+
+        friend ostream &operator<<(ostream &os, const BasicGraph &graph)
         {
-            const vector<vector<int>> &matrix = graph.getAdjacencyMatrix();
-            for (size_t i = 0; i < matrix.size(); ++i)
+            size_t size = graph.getNumVertices();
+            for (size_t i = 0; i < size; ++i)
             {
                 os << "[";
-                for (size_t j = 0; j < matrix[i].size(); ++j)
+                for (size_t j = 0; j < size; ++j)
                 {
-                    os << matrix[i][j];
-                    if (j != matrix[i].size() - 1)
+                    os << +graph.getEdge(i, j); // + prints uint8_t weights as numbers, not characters
+                    if (j != size - 1)
                     {
                         os << ", ";
                     }
                 }
                 os << "]";
-                if (i != matrix.size() - 1)
+                if (i != size - 1)
                 {
                     os << ", ";
                 }
@@ -68,5 +138,150 @@ namespace ariel
             return os;
         }
     };
+
+    typedef BasicGraph<int> Graph;
+
+    /**
+     * @brief Gets a row of the adjacency matrix.
+     * @param i The source vertex.
+     * @return A pointer to the getNumVertices() weights of the edges leaving i.
+     */
+    template <typename T>
+    inline const T *BasicGraph<T>::getRow(size_t i) const
+    {
+        return getData() + i * numvertices;
+    }
+
+    /**
+     * @brief Gets the weight of an edge, 0 if there is no edge.
+     * @param from The source vertex.
+     * @param to The target vertex.
+     * @return The entry [from][to] of the adjacency matrix.
+     */
+    template <typename T>
+    inline T BasicGraph<T>::getEdge(size_t from, size_t to) const
+    {
+        return getData()[from * numvertices + to];
+    }
+
+    /**
+     * @brief Gets the whole adjacency matrix as one contiguous row-major array.
+     * @return A pointer to getNumVertices() * getNumVertices() weights.
+     */
+    template <typename T>
+    inline const T *BasicGraph<T>::getData() const
+    {
+        return backing ? mapped : adjacencymatrix.data();
+    }
+
+    /**
+     * @brief Checks if the graph is a view over memory it does not own.
+     * @return True until the graph is modified or reloaded.
+     */
+    template <typename T>
+    inline bool BasicGraph<T>::isView() const
+    {
+        return static_cast<bool>(backing);
+    }
+
+    /**
+     * @brief Gives a view its own copy of the matrix, called before every modification.
+     * @details Also drops the cached fingerprint and statistics, which are recomputed the next time they are needed.
+     */
+    template <typename T>
+    inline void BasicGraph<T>::detach()
+    {
+        cellHashValid = false;
+        statsValid = false;
+        if (backing)
+        {
+            adjacencymatrix.assign(mapped, mapped + numvertices * numvertices);
+            mapped = nullptr;
+            backing.reset();
+        }
+    }
+
+    /**
+     * @brief Gets the number of vertices in the graph.
+     * @return The number of vertices in the graph.
+     */
+    template <typename T>
+    inline size_t BasicGraph<T>::getNumVertices() const
+    {
+        return numvertices;
+    }
+
+    /**
+     * @brief Gets a writable row of the adjacency matrix.
+     */
+    template <typename T>
+    inline T *BasicGraph<T>::mutableRow(size_t i)
+    {
+        detach();
+        return adjacencymatrix.data() + i * numvertices;
+    }
+
+    /**
+     * @brief Multiplies the adjacency matrices of two graphs over a semiring and returns the result as a new graph.
+     * @param mat The graph to multiply with.
+     * @param semiring The semiring to multiply in, e.g. PlusTimes, MinPlus, MaxMin or BooleanSemiring.
+     * @param threads The number of threads to use, 0 for the hardware concurrency.
+     * @return A new graph with the result of the multiplication.
+     * @throws invalid_argument If the dimensions of the matrices do not match.
+     * @details With MinPlus on a distance matrix this is one step of shortest paths by repeated squaring,
+     * with MaxMin on a capacity matrix one step of widest paths. MinPlus reads numeric_limits<T>::max() as "no path"
+     * rather than 0, so convert an adjacency matrix with distanceMatrix first.
+     */
+    template <typename T>
+    template <typename S>
+    BasicGraph<T> BasicGraph<T>::product(const BasicGraph &mat, const S &semiring, size_t threads) const
+    {
+        if (!issquared(mat))
+        {
+            throw invalid_argument("dimensions of the matrices do not correlate");
+        }
+        BasicGraph g(static_cast<int>(getNumVertices()));
+        productInto(*this, mat, g, semiring, threads);
+        return g;
+    }
+
+    /**
+     * @brief Writes the semiring product of two graphs into the already sized matrix of a third one.
+     * @param a The left operand.
+     * @param b The right operand.
+     * @param out Receives the product, it must be a different object than a and b.
+     * @param semiring The semiring to multiply in.
+     * @param threads The number of threads to use, 0 for the hardware concurrency.
+     */
+    template <typename T>
+    template <typename S>
+    void BasicGraph<T>::productInto(const BasicGraph &a, const BasicGraph &b, BasicGraph &out, const S &semiring, size_t threads)
+    {
+        size_t size = a.getNumVertices();
+        vector<const T *> left(size), right(size);
+        vector<T *> result(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            left[i] = a.getRow(i);
+            right[i] = b.getRow(i);
+            result[i] = out.mutableRow(i);
+        }
+        semiringProduct(semiring, left.data(), right.data(), result.data(), size, threads);
+    }
+}
+
+namespace std
+{
+    /**
+     * @brief Hashes graphs by their fingerprint, so they can be kept in unordered containers.
+     */
+    template <typename T>
+    struct hash<ariel::BasicGraph<T>>
+    {
+        size_t operator()(const ariel::BasicGraph<T> &g) const
+        {
+            return static_cast<size_t>(g.fingerprint());
+        }
+    };
 }
 #endif // GRAPH_HPP
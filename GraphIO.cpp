@@ -0,0 +1,1080 @@
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <type_traits>
+#include <stdexcept>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "GraphIO.hpp"
+
+using namespace std;
+using namespace ariel;
+
+static_assert(sizeof(GraphFileHeader) == 64, "the binary graph header must be 64 bytes");
+
+const uint32_t GraphIO::FORMAT_VERSION;
+const uint32_t GraphIO::DENSE;
+const uint32_t GraphIO::CSR;
+
+namespace
+{
+    const char GRAPH_MAGIC[8] = {'A', 'R', 'I', 'E', 'L', 'G', 'R', '\0'};
+
+    // Sections start at multiples of this, enough for any weight type and a cache line
+    const uint64_t SECTION_ALIGN = 64;
+
+    uint64_t alignUp(uint64_t pos)
+    {
+        return (pos + SECTION_ALIGN - 1) / SECTION_ALIGN * SECTION_ALIGN;
+    }
+
+    /**
+     * @brief The format is little-endian and used in place, so it can only be read and written natively on such hosts.
+     */
+    void requireLittleEndian()
+    {
+        const uint16_t probe = 1;
+        unsigned char low;
+        memcpy(&low, &probe, 1);
+        if (low != 1)
+        {
+            throw runtime_error("binary graph files need a little-endian host");
+        }
+    }
+
+    /**
+     * @brief A whole file mapped read-only into memory, unmapped when destroyed.
+     */
+    class MappedFile
+    {
+    private:
+        void *addr;
+        size_t length;
+        MappedFile(const MappedFile &);
+        MappedFile &operator=(const MappedFile &);
+
+    public:
+        explicit MappedFile(const string &path) : addr(MAP_FAILED), length(0)
+        {
+            int fd = open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+            {
+                throw runtime_error("cannot open graph file " + path + ": " + strerror(errno));
+            }
+            struct stat info;
+            if (fstat(fd, &info) != 0)
+            {
+                int error = errno;
+                close(fd);
+                throw runtime_error("cannot stat graph file " + path + ": " + strerror(error));
+            }
+            length = static_cast<size_t>(info.st_size);
+            if (length == 0)
+            {
+                close(fd); // an empty file cannot be mapped, it is simply no bytes
+                addr = nullptr;
+                return;
+            }
+            addr = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            int error = errno;
+            close(fd); // the mapping stays valid without the descriptor
+            if (addr == MAP_FAILED)
+            {
+                throw runtime_error("cannot map graph file " + path + ": " + strerror(error));
+            }
+        }
+
+        ~MappedFile()
+        {
+            if (length != 0)
+            {
+                munmap(addr, length);
+            }
+        }
+
+        const unsigned char *data() const
+        {
+            return static_cast<const unsigned char *>(addr);
+        }
+
+        size_t size() const
+        {
+            return length;
+        }
+    };
+
+    /**
+     * @brief Checks that a mapped file is a graph file of weight type T and returns its header.
+     * @throws invalid_argument If the file is not a graph file, has another version or weight type, or is truncated.
+     */
+    template <typename T>
+    GraphFileHeader readHeader(const MappedFile &file, const string &path)
+    {
+        if (file.size() < sizeof(GraphFileHeader))
+        {
+            throw invalid_argument("Invalid graph file: " + path + " is too short.");
+        }
+        GraphFileHeader header;
+        memcpy(&header, file.data(), sizeof(header));
+        if (memcmp(header.magic, GRAPH_MAGIC, sizeof(GRAPH_MAGIC)) != 0)
+        {
+            throw invalid_argument("Invalid graph file: " + path + " is not a binary graph file.");
+        }
+        if (header.version != GraphIO::FORMAT_VERSION)
+        {
+            throw invalid_argument("Invalid graph file: unsupported version " + to_string(header.version) + ".");
+        }
+        if (header.weightType != WeightCode<T>::value || header.weightSize != sizeof(T))
+        {
+            throw invalid_argument("Invalid graph file: the file holds another weight type.");
+        }
+
+        // Every section must lie inside the file, checked without overflowing
+        uint64_t size = file.size();
+        uint64_t n = header.numVertices;
+        uint64_t m = header.numEdges;
+        bool fits;
+        if (header.layout == GraphIO::DENSE)
+        {
+            fits = header.weightsPos % SECTION_ALIGN == 0 && header.weightsPos <= size &&
+                   (n == 0 || n <= (size - header.weightsPos) / sizeof(T) / n);
+        }
+        else if (header.layout == GraphIO::CSR)
+        {
+            fits = header.offsetsPos % SECTION_ALIGN == 0 && header.targetsPos % SECTION_ALIGN == 0 &&
+                   header.weightsPos % SECTION_ALIGN == 0 &&
+                   header.offsetsPos <= size && n < (size - header.offsetsPos) / sizeof(uint64_t) &&
+                   header.targetsPos <= size && m <= (size - header.targetsPos) / sizeof(uint64_t) &&
+                   header.weightsPos <= size && m <= (size - header.weightsPos) / sizeof(T);
+        }
+        else
+        {
+            throw invalid_argument("Invalid graph file: unknown layout.");
+        }
+        if (!fits)
+        {
+            throw invalid_argument("Invalid graph file: " + path + " is truncated.");
+        }
+        return header;
+    }
+
+    GraphFileHeader makeHeader(uint32_t layout, uint32_t weightType, uint32_t weightSize, uint64_t numVertices, uint64_t numEdges)
+    {
+        GraphFileHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, GRAPH_MAGIC, sizeof(GRAPH_MAGIC));
+        header.version = GraphIO::FORMAT_VERSION;
+        header.layout = layout;
+        header.weightType = weightType;
+        header.weightSize = weightSize;
+        header.numVertices = numVertices;
+        header.numEdges = numEdges;
+        return header;
+    }
+
+    /**
+     * @brief Writes bytes at the given position of the file, padding with zeros up to it.
+     */
+    void writeAt(ofstream &out, uint64_t pos, const void *bytes, uint64_t count)
+    {
+        static const char zeros[SECTION_ALIGN] = {};
+        uint64_t current = static_cast<uint64_t>(out.tellp());
+        out.write(zeros, static_cast<streamsize>(pos - current));
+        out.write(static_cast<const char *>(bytes), static_cast<streamsize>(count));
+    }
+
+    /**
+     * @brief Writes an array of size_t as uint64.
+     */
+    void writeWide(ofstream &out, uint64_t pos, const vector<size_t> &values)
+    {
+        if (sizeof(size_t) == sizeof(uint64_t))
+        {
+            writeAt(out, pos, values.data(), values.size() * sizeof(uint64_t));
+            return;
+        }
+        vector<uint64_t> wide(values.begin(), values.end());
+        writeAt(out, pos, wide.data(), wide.size() * sizeof(uint64_t));
+    }
+
+    /*
+     * Text parsing helpers. They scan [p, end) ranges of a buffer in place, advancing p past what they consumed,
+     * and report malformed input by returning false instead of throwing so the caller can name the line.
+     */
+
+    inline bool isBlank(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    inline bool isDigit(char c)
+    {
+        return static_cast<unsigned>(c - '0') < 10u;
+    }
+
+    inline const char *skipBlanks(const char *p, const char *end)
+    {
+        while (p != end && isBlank(*p))
+        {
+            ++p;
+        }
+        return p;
+    }
+
+    /**
+     * @brief Parses a run of decimal digits.
+     * @return False if there are no digits or the number does not fit 64 bits.
+     */
+    inline bool parseUnsigned(const char *&p, const char *end, uint64_t &value)
+    {
+        const char *start = p;
+        uint64_t result = 0;
+        while (p != end && isDigit(*p))
+        {
+            unsigned digit = static_cast<unsigned>(*p - '0');
+            if (result > (numeric_limits<uint64_t>::max() - digit) / 10)
+            {
+                return false;
+            }
+            result = result * 10 + digit;
+            ++p;
+        }
+        value = result;
+        return p != start;
+    }
+
+    /**
+     * @brief Parses an optionally signed integer weight, false if it does not fit T.
+     */
+    template <typename T>
+    bool parseWeight(const char *&p, const char *end, T &value, true_type)
+    {
+        bool negative = false;
+        if (p != end && (*p == '-' || *p == '+'))
+        {
+            negative = *p == '-';
+            ++p;
+        }
+        uint64_t magnitude;
+        if (!parseUnsigned(p, end, magnitude))
+        {
+            return false;
+        }
+        const uint64_t maxMagnitude = static_cast<uint64_t>(numeric_limits<T>::max());
+        const uint64_t minMagnitude = numeric_limits<T>::is_signed ? maxMagnitude + 1 : 0;
+        if (magnitude > (negative ? minMagnitude : maxMagnitude))
+        {
+            return false;
+        }
+        value = negative ? static_cast<T>(0 - magnitude) : static_cast<T>(magnitude);
+        return true;
+    }
+
+    /**
+     * @brief Parses a floating point weight with strtod, the token is copied out since the buffer is not terminated.
+     * @return False for a token too long for the copy, or a value that is not finite or does not fit T.
+     */
+    template <typename T>
+    bool parseWeight(const char *&p, const char *end, T &value, false_type)
+    {
+        char token[64];
+        size_t length = 0;
+        while (p != end && !isBlank(*p) && length < sizeof(token) - 1)
+        {
+            token[length++] = *p++;
+        }
+        if (length == 0 || (p != end && !isBlank(*p)))
+        {
+            return false;
+        }
+        token[length] = '\0';
+        char *stop;
+        errno = 0;
+        double parsed = strtod(token, &stop);
+        if (stop != token + length || errno == ERANGE || !std::isfinite(parsed) ||
+            parsed < static_cast<double>(numeric_limits<T>::lowest()) || parsed > static_cast<double>(numeric_limits<T>::max()))
+        {
+            return false;
+        }
+        value = static_cast<T>(parsed);
+        return true;
+    }
+
+    template <typename T>
+    bool parseWeight(const char *&p, const char *end, T &value)
+    {
+        return parseWeight(p, end, value, integral_constant<bool, numeric_limits<T>::is_integer>());
+    }
+
+    /**
+     * @brief Parses one line of an edge list, "u v" or "u v w" separated by blanks.
+     * @param isEdge Cleared for blank lines and comments starting with # or %.
+     * @return False if the line is malformed.
+     */
+    template <typename T>
+    bool parseEdgeLine(const char *p, const char *end, uint64_t &u, uint64_t &v, T &w, bool &isEdge)
+    {
+        p = skipBlanks(p, end);
+        isEdge = p != end && *p != '#' && *p != '%';
+        if (!isEdge)
+        {
+            return true;
+        }
+        if (!parseUnsigned(p, end, u) || p == end || !isBlank(*p))
+        {
+            return false;
+        }
+        p = skipBlanks(p, end);
+        if (!parseUnsigned(p, end, v) || (p != end && !isBlank(*p)))
+        {
+            return false;
+        }
+        p = skipBlanks(p, end);
+        w = T(1);
+        if (p != end && !parseWeight(p, end, w))
+        {
+            return false;
+        }
+        return skipBlanks(p, end) == end;
+    }
+
+    /**
+     * @brief Reads an edge list chunk by chunk and calls visit(u, v, w) for every edge, in file order.
+     * @param chunkBytes The size of the read buffer, it only grows if a single line is longer.
+     * @throws runtime_error If the file cannot be read.
+     * @throws invalid_argument If a line is malformed.
+     * @details Only whole lines are parsed, the partial line at the end of a chunk is moved to the front of the
+     * buffer and completed by the next read.
+     */
+    template <typename T, typename Visitor>
+    void scanEdgeList(const string &path, size_t chunkBytes, Visitor visit)
+    {
+        ifstream in(path.c_str(), ios::binary);
+        if (!in)
+        {
+            throw runtime_error("cannot open edge list " + path);
+        }
+        vector<char> buffer(max<size_t>(chunkBytes, 64));
+        size_t carried = 0;
+        uint64_t lineNumber = 0;
+        bool last = false;
+        while (!last)
+        {
+            if (carried == buffer.size())
+            {
+                buffer.resize(buffer.size() * 2);
+            }
+            in.read(buffer.data() + carried, static_cast<streamsize>(buffer.size() - carried));
+            if (in.bad())
+            {
+                throw runtime_error("cannot read edge list " + path);
+            }
+            last = !in;
+            const char *line = buffer.data();
+            const char *stop = line + carried + static_cast<size_t>(in.gcount());
+            while (line != stop)
+            {
+                const char *newline = static_cast<const char *>(memchr(line, '\n', static_cast<size_t>(stop - line)));
+                if (newline == nullptr && !last)
+                {
+                    break;
+                }
+                const char *lineEnd = newline == nullptr ? stop : newline;
+                ++lineNumber;
+                uint64_t u, v;
+                T w;
+                bool isEdge;
+                if (!parseEdgeLine(line, lineEnd, u, v, w, isEdge))
+                {
+                    throw invalid_argument("Invalid edge list: malformed line " + to_string(lineNumber) + ".");
+                }
+                if (isEdge)
+                {
+                    visit(u, v, w);
+                }
+                line = newline == nullptr ? stop : newline + 1;
+            }
+            carried = static_cast<size_t>(stop - line);
+            memmove(buffer.data(), line, carried);
+        }
+    }
+
+    /**
+     * @brief 1 if c can be part of a number token, 0 otherwise.
+     * @details Written with comparisons only, no table lookup, so that loops classifying a whole buffer vectorize.
+     */
+    inline unsigned numberClass(char c)
+    {
+        return static_cast<unsigned>(static_cast<unsigned>(c - '0') < 10u) | (c == '-') | (c == '+') | (c == '.') | (c == 'e') | (c == 'E');
+    }
+
+    inline bool isMatrixSeparator(char c)
+    {
+        return isBlank(c) || c == '\n' || c == ',' || c == '[' || c == ']';
+    }
+
+    // Chunks of a text matrix smaller than this are not worth a task of their own
+    const size_t MIN_PARSE_CHUNK = 64 * 1024;
+
+    /**
+     * @brief Counts the number tokens starting in [begin, end) of a text, and the brackets in it.
+     */
+    struct ChunkCounts
+    {
+        size_t tokens;
+        size_t opening;
+        size_t closing;
+    };
+
+    ChunkCounts countChunk(const char *text, size_t begin, size_t end)
+    {
+        ChunkCounts counts = {0, 0, 0};
+        if (begin == end)
+        {
+            return counts;
+        }
+        size_t first = begin;
+        if (begin == 0)
+        {
+            counts.tokens += numberClass(text[0]);
+            first = 1;
+        }
+        // Branch-free so that the compiler can vectorize the scan
+        size_t tokens = 0, opening = 0, closing = 0;
+        for (size_t i = first; i < end; ++i)
+        {
+            tokens += numberClass(text[i]) & (numberClass(text[i - 1]) ^ 1u);
+            opening += text[i] == '[';
+            closing += text[i] == ']';
+        }
+        counts.tokens += tokens;
+        counts.opening += opening + (first != begin && text[0] == '[');
+        counts.closing += closing + (first != begin && text[0] == ']');
+        return counts;
+    }
+
+    /**
+     * @brief A row delimiter of a text matrix, '[', ']' or a line break, and the number of entries before it.
+     */
+    struct RowMark
+    {
+        char delimiter;
+        size_t entry;
+    };
+
+    /**
+     * @brief Parses the number tokens starting in [begin, end) of a text into consecutive entries of out.
+     * @param marks Receives the row delimiters of the range, with entry counted from the start of the range.
+     * @return False if the range holds a character that is neither a separator nor part of a valid number.
+     */
+    template <typename T>
+    bool parseChunk(const char *text, size_t begin, size_t end, T *out, vector<RowMark> &marks)
+    {
+        const T *first = out;
+        size_t i = begin;
+        while (i < end)
+        {
+            if (!numberClass(text[i]))
+            {
+                if (!isMatrixSeparator(text[i]))
+                {
+                    return false;
+                }
+                if (text[i] == '[' || text[i] == ']' || text[i] == '\n')
+                {
+                    RowMark mark = {text[i], static_cast<size_t>(out - first)};
+                    marks.push_back(mark);
+                }
+                ++i;
+                continue;
+            }
+            size_t tokenEnd = i;
+            while (tokenEnd < end && numberClass(text[tokenEnd]))
+            {
+                ++tokenEnd;
+            }
+            const char *p = text + i;
+            if (!parseWeight(p, text + tokenEnd, *out) || p != text + tokenEnd)
+            {
+                return false;
+            }
+            ++out;
+            i = tokenEnd;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Checks that every row of a parsed text matrix holds exactly numVertices entries.
+     * @param marks The row delimiters of every chunk.
+     * @param firstEntry The entry every chunk starts at.
+     * @param bracketed Whether rows are the bracket groups of the operator<< format, or else the non-blank lines.
+     * @details The entry counts alone would accept ragged rows whose lengths happen to add up to the square.
+     */
+    bool rowsAreSquare(const vector<vector<RowMark>> &marks, const vector<size_t> &firstEntry, size_t numVertices,
+                       bool bracketed)
+    {
+        size_t rowStart = 0;
+        bool inRow = false;
+        for (size_t c = 0; c < marks.size(); ++c)
+        {
+            for (const RowMark &mark : marks[c])
+            {
+                size_t entry = firstEntry[c] + mark.entry;
+                if (!bracketed && mark.delimiter == '\n')
+                {
+                    if (entry != rowStart && entry != rowStart + numVertices)
+                    {
+                        return false;
+                    }
+                    rowStart = entry;
+                }
+                else if (bracketed && mark.delimiter == '[')
+                {
+                    if (inRow || entry != rowStart)
+                    {
+                        return false;
+                    }
+                    inRow = true;
+                }
+                else if (bracketed && mark.delimiter == ']')
+                {
+                    if (!inRow || entry != rowStart + numVertices)
+                    {
+                        return false;
+                    }
+                    inRow = false;
+                    rowStart = entry;
+                }
+            }
+        }
+        // The last line may lack its line break
+        size_t total = firstEntry.back();
+        return bracketed ? !inRow && total == rowStart : total == rowStart || total == rowStart + numVertices;
+    }
+
+    // The decimal digits of 00 to 99, two characters each, so integers are formatted two digits per step
+    const char DIGIT_PAIRS[] =
+        "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+        "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+
+    /**
+     * @brief Writes the decimal form of an integer, exactly as ostream does by default.
+     * @return One past the last character written, at most 20 characters are written.
+     */
+    inline char *formatInteger(char *out, long long value)
+    {
+        unsigned long long magnitude = static_cast<unsigned long long>(value);
+        if (value < 0)
+        {
+            *out++ = '-';
+            magnitude = 0 - magnitude;
+        }
+        char digits[20];
+        char *p = digits + sizeof(digits);
+        while (magnitude >= 100)
+        {
+            unsigned pair = static_cast<unsigned>(magnitude % 100) * 2;
+            magnitude /= 100;
+            *--p = DIGIT_PAIRS[pair + 1];
+            *--p = DIGIT_PAIRS[pair];
+        }
+        if (magnitude >= 10)
+        {
+            unsigned pair = static_cast<unsigned>(magnitude) * 2;
+            *--p = DIGIT_PAIRS[pair + 1];
+            *--p = DIGIT_PAIRS[pair];
+        }
+        else
+        {
+            *--p = static_cast<char>('0' + magnitude);
+        }
+        size_t length = static_cast<size_t>(digits + sizeof(digits) - p);
+        memcpy(out, p, length);
+        return out + length;
+    }
+
+    // The longest text of one weight, "-1.23457e-308" for floating point and 20 characters for int64_t
+    const size_t MAX_WEIGHT_CHARS = 24;
+
+    template <typename T>
+    char *formatWeight(char *out, T value, true_type)
+    {
+        return formatInteger(out, static_cast<long long>(value));
+    }
+
+    /**
+     * @brief Floating point weights use %g, which is what ostream does with its default precision of 6.
+     */
+    template <typename T>
+    char *formatWeight(char *out, T value, false_type)
+    {
+        return out + snprintf(out, MAX_WEIGHT_CHARS, "%g", static_cast<double>(value));
+    }
+
+    /**
+     * @brief Formats rows [first, last) of a graph in the operator<< format into a buffer.
+     * @param text Must hold (last - first) * (n * (MAX_WEIGHT_CHARS + 2) + 4) characters.
+     * @return The number of characters written.
+     */
+    template <typename T>
+    size_t formatRows(const BasicGraph<T> &g, size_t first, size_t last, char *text)
+    {
+        size_t n = g.getNumVertices();
+        char *out = text;
+        for (size_t i = first; i < last; ++i)
+        {
+            const T *row = g.getRow(i);
+            *out++ = '[';
+            for (size_t j = 0; j < n; ++j)
+            {
+                out = formatWeight(out, row[j], integral_constant<bool, numeric_limits<T>::is_integer>());
+                if (j != n - 1)
+                {
+                    *out++ = ',';
+                    *out++ = ' ';
+                }
+            }
+            *out++ = ']';
+            if (i != n - 1)
+            {
+                *out++ = ',';
+                *out++ = ' ';
+            }
+        }
+        return static_cast<size_t>(out - text);
+    }
+
+    // Rows are formatted in blocks of about this many bytes, one block per thread at a time
+    const size_t FORMAT_BLOCK_BYTES = 1 << 20;
+
+    /**
+     * @brief Formats a graph in the operator<< format block by block and hands the blocks to a sink in order.
+     * @param sink Called with a batch of formatted blocks, as buffers and their lengths, in output order.
+     * @details Every batch formats one block of rows per thread in parallel, so memory stays bounded by the
+     * number of threads times the block size, whatever the size of the graph.
+     */
+    template <typename T, typename Sink>
+    void formatMatrix(const BasicGraph<T> &g, size_t threads, Sink sink)
+    {
+        size_t n = g.getNumVertices();
+        size_t rowBytes = n * (MAX_WEIGHT_CHARS + 2) + 4;
+        size_t rowsPerBlock = max<size_t>(1, FORMAT_BLOCK_BYTES / rowBytes);
+        size_t blocksPerBatch = workerCount(threads);
+        vector<vector<char>> buffers(min(blocksPerBatch, (n + rowsPerBlock - 1) / rowsPerBlock));
+        vector<size_t> lengths(buffers.size());
+        for (size_t b = 0; b < buffers.size(); ++b)
+        {
+            buffers[b].resize(rowsPerBlock * rowBytes);
+        }
+        for (size_t first = 0; first < n; first += buffers.size() * rowsPerBlock)
+        {
+            size_t count = min(buffers.size(), (n - first + rowsPerBlock - 1) / rowsPerBlock);
+            parallelFor(0, count, [&](size_t b)
+                        {
+                            size_t begin = first + b * rowsPerBlock;
+                            lengths[b] = formatRows(g, begin, min(n, begin + rowsPerBlock), buffers[b].data());
+                        },
+                        threads);
+            sink(buffers, lengths, count);
+        }
+    }
+
+    ofstream openForWriting(const string &path)
+    {
+        ofstream out(path.c_str(), ios::binary | ios::trunc);
+        if (!out)
+        {
+            throw runtime_error("cannot create graph file " + path);
+        }
+        return out;
+    }
+
+    void finishWriting(ofstream &out, const string &path)
+    {
+        out.close();
+        if (!out)
+        {
+            throw runtime_error("cannot write graph file " + path);
+        }
+    }
+}
+
+/**
+ * @brief Writes a graph to a binary file in the dense layout.
+ * @param g The graph to write.
+ * @param path The file to create or overwrite.
+ * @throws runtime_error If the file cannot be written.
+ */
+template <typename T>
+void GraphIO::writeBinary(const BasicGraph<T> &g, const string &path)
+{
+    requireLittleEndian();
+    uint64_t n = g.getNumVertices();
+    const T *data = g.getData();
+    uint64_t edges = 0;
+    for (uint64_t i = 0; i < n * n; ++i)
+    {
+        edges += data[i] != T(0) ? 1 : 0;
+    }
+    GraphFileHeader header = makeHeader(DENSE, WeightCode<T>::value, sizeof(T), n, edges);
+    header.weightsPos = alignUp(sizeof(header));
+
+    ofstream out = openForWriting(path);
+    writeAt(out, 0, &header, sizeof(header));
+    writeAt(out, header.weightsPos, data, n * n * sizeof(T));
+    finishWriting(out, path);
+}
+
+/**
+ * @brief Writes a graph to a binary file in the CSR layout, compact for sparse graphs.
+ * @param g The graph to write.
+ * @param path The file to create or overwrite.
+ * @throws runtime_error If the file cannot be written.
+ */
+template <typename T>
+void GraphIO::writeBinary(const BasicCSRGraph<T> &g, const string &path)
+{
+    requireLittleEndian();
+    uint64_t n = g.getNumVertices();
+    uint64_t m = g.getNumEdges();
+    GraphFileHeader header = makeHeader(CSR, WeightCode<T>::value, sizeof(T), n, m);
+    header.offsetsPos = alignUp(sizeof(header));
+    header.targetsPos = alignUp(header.offsetsPos + (n + 1) * sizeof(uint64_t));
+    header.weightsPos = alignUp(header.targetsPos + m * sizeof(uint64_t));
+
+    ofstream out = openForWriting(path);
+    writeAt(out, 0, &header, sizeof(header));
+    writeWide(out, header.offsetsPos, g.getOffsets());
+    writeWide(out, header.targetsPos, g.getTargets());
+    writeAt(out, header.weightsPos, g.getWeights().data(), m * sizeof(T));
+    finishWriting(out, path);
+}
+
+/**
+ * @brief Opens a binary graph file as a graph.
+ * @param path The file to open.
+ * @return For a dense file, a read-only view directly over the memory-mapped matrix. The mapping lives as long as
+ * the view or any copy of it, and modifying the graph first copies the matrix into memory. A CSR file is expanded
+ * into an ordinary graph.
+ * @throws runtime_error If the file cannot be opened or mapped.
+ * @throws invalid_argument If the file is not a valid graph file with weights of type T.
+ */
+template <typename T>
+BasicGraph<T> GraphIO::mapGraph(const string &path)
+{
+    requireLittleEndian();
+    shared_ptr<MappedFile> file = make_shared<MappedFile>(path);
+    GraphFileHeader header = readHeader<T>(*file, path);
+    if (header.layout == CSR)
+    {
+        return loadCSR<T>(path).toGraph();
+    }
+    const T *matrix = reinterpret_cast<const T *>(file->data() + header.weightsPos);
+    return BasicGraph<T>(static_cast<size_t>(header.numVertices), matrix, file);
+}
+
+/**
+ * @brief Reads a binary graph file into CSR form.
+ * @param path The file to read.
+ * @return The graph, the arrays are copied straight out of the mapped file. A dense file is converted.
+ * @throws runtime_error If the file cannot be opened or mapped.
+ * @throws invalid_argument If the file is not a valid graph file with weights of type T.
+ */
+template <typename T>
+BasicCSRGraph<T> GraphIO::loadCSR(const string &path)
+{
+    requireLittleEndian();
+    MappedFile file(path);
+    GraphFileHeader header = readHeader<T>(file, path);
+    if (header.layout == DENSE)
+    {
+        return BasicCSRGraph<T>(mapGraph<T>(path));
+    }
+    const uint64_t *offsets = reinterpret_cast<const uint64_t *>(file.data() + header.offsetsPos);
+    const uint64_t *targets = reinterpret_cast<const uint64_t *>(file.data() + header.targetsPos);
+    const T *weights = reinterpret_cast<const T *>(file.data() + header.weightsPos);
+    return BasicCSRGraph<T>(vector<size_t>(offsets, offsets + header.numVertices + 1),
+                            vector<size_t>(targets, targets + header.numEdges),
+                            vector<T>(weights, weights + header.numEdges));
+}
+
+/**
+ * @brief Loads a text edge list into CSR form without ever holding the text or a matrix in memory.
+ * @param path The edge list, one "u v w" line per edge with 0-based vertices. The weight defaults to 1,
+ * edges of weight 0 only add their vertices since 0 means "no edge", and lines starting with # or % are comments.
+ * @param chunkBytes The size of the read buffer.
+ * @return The graph with max(u, v) + 1 vertices, the edges of every vertex in file order.
+ * @throws runtime_error If the file cannot be read or changes between the two passes.
+ * @throws invalid_argument If a line is malformed, a vertex does not fit size_t or a weight does not fit T.
+ * @details The file is read twice. The first pass only counts the out-degree of every vertex, which gives the
+ * CSR offsets, and the second pass writes every edge straight into its slot. Memory use is the CSR arrays plus
+ * one chunk, and numbers are parsed in place by hand instead of through iostream.
+ */
+template <typename T>
+BasicCSRGraph<T> GraphIO::loadEdgeList(const string &path, size_t chunkBytes)
+{
+    vector<size_t> offsets(1, 0);
+    size_t numVertices = 0;
+    scanEdgeList<T>(path, chunkBytes, [&](uint64_t u, uint64_t v, T w)
+                    {
+                        if (max(u, v) >= numeric_limits<size_t>::max() - 1)
+                        {
+                            throw invalid_argument("Invalid edge list: vertex " + to_string(max(u, v)) + " is too large.");
+                        }
+                        numVertices = max(numVertices, static_cast<size_t>(max(u, v)) + 1);
+                        if (w == T(0))
+                        {
+                            return;
+                        }
+                        if (u + 2 > offsets.size())
+                        {
+                            offsets.resize(max(static_cast<size_t>(u) + 2, offsets.size() * 2), 0);
+                        }
+                        offsets[u + 1]++;
+                    });
+    offsets.resize(numVertices + 1, 0);
+    for (size_t v = 0; v < numVertices; ++v)
+    {
+        offsets[v + 1] += offsets[v];
+    }
+
+    vector<size_t> next(offsets.begin(), offsets.end() - 1);
+    vector<size_t> targets(offsets.back());
+    vector<T> weights(offsets.back());
+    bool changed = false;
+    scanEdgeList<T>(path, chunkBytes, [&](uint64_t u, uint64_t v, T w)
+                    {
+                        if (w == T(0))
+                        {
+                            return;
+                        }
+                        if (u >= numVertices || v >= numVertices || next[u] == offsets[u + 1])
+                        {
+                            changed = true;
+                            return;
+                        }
+                        targets[next[u]] = static_cast<size_t>(v);
+                        weights[next[u]] = w;
+                        next[u]++;
+                    });
+    for (size_t v = 0; v < numVertices && !changed; ++v)
+    {
+        changed = next[v] != offsets[v + 1];
+    }
+    if (changed)
+    {
+        throw runtime_error("edge list " + path + " changed while it was loaded");
+    }
+    return BasicCSRGraph<T>(std::move(offsets), std::move(targets), std::move(weights));
+}
+
+/**
+ * @brief Reads a dense text matrix file, see parseMatrix for the accepted formats.
+ * @param path The file to read, it is memory-mapped rather than copied.
+ * @param threads The number of threads to use, 0 for the hardware concurrency.
+ * @return The graph.
+ * @throws runtime_error If the file cannot be opened or mapped.
+ * @throws invalid_argument If the text is not a square matrix of numbers that fit T.
+ */
+template <typename T>
+BasicGraph<T> GraphIO::readMatrix(const string &path, size_t threads)
+{
+    MappedFile file(path);
+    return parseMatrix<T>(reinterpret_cast<const char *>(file.data()), file.size(), threads);
+}
+
+/**
+ * @brief Parses a dense text matrix into a graph.
+ * @param text The text, either in the operator<< format "[0, 1, 0], [1, 0, 1], [0, 1, 0]", whose rows may also
+ * be on separate lines, or as plain rows of whitespace separated numbers, one row per line.
+ * @param length The length of the text in bytes.
+ * @param threads The number of threads to use, 0 for the hardware concurrency.
+ * @return The graph, its size is the number of entries of the first row.
+ * @throws invalid_argument If the text is not a square matrix of numbers that fit T.
+ * @details The text is cut into chunks at separators and parsed in two parallel passes. The first pass counts the
+ * numbers starting in every chunk with a branch-free scan, and a prefix sum over the counts gives the matrix
+ * entry every chunk starts at. The second pass parses every chunk straight into the graph's matrix and notes
+ * where rows end, which is then checked row by row.
+ */
+template <typename T>
+BasicGraph<T> GraphIO::parseMatrix(const char *text, size_t length, size_t threads)
+{
+    // The size of the matrix is the number of entries in the first row
+    size_t start = 0;
+    while (start < length && (isBlank(text[start]) || text[start] == '\n'))
+    {
+        ++start;
+    }
+    bool bracketed = start < length && text[start] == '[';
+    size_t rowEnd = start;
+    while (rowEnd < length && text[rowEnd] != (bracketed ? ']' : '\n'))
+    {
+        ++rowEnd;
+    }
+    size_t numVertices = countChunk(text, start, rowEnd).tokens;
+
+    size_t chunks = min(workerCount(threads) * 4, max<size_t>(1, length / MIN_PARSE_CHUNK));
+    vector<size_t> bounds(chunks + 1, length);
+    bounds[0] = 0;
+    for (size_t c = 1; c < chunks; ++c)
+    {
+        // Move every cut forward to a separator so that no number is split between two chunks
+        size_t cut = max(bounds[c - 1], length / chunks * c);
+        while (cut < length && numberClass(text[cut]))
+        {
+            ++cut;
+        }
+        bounds[c] = cut;
+    }
+
+    vector<ChunkCounts> counts(chunks);
+    parallelFor(0, chunks, [&](size_t c)
+                { counts[c] = countChunk(text, bounds[c], bounds[c + 1]); },
+                threads);
+    vector<size_t> firstEntry(chunks + 1, 0);
+    size_t opening = 0, closing = 0;
+    for (size_t c = 0; c < chunks; ++c)
+    {
+        firstEntry[c + 1] = firstEntry[c] + counts[c].tokens;
+        opening += counts[c].opening;
+        closing += counts[c].closing;
+    }
+    bool shaped = firstEntry[chunks] == numVertices * numVertices &&
+                  (bracketed ? opening == numVertices && closing == numVertices : opening == 0 && closing == 0);
+    if (!shaped)
+    {
+        throw invalid_argument("Invalid graph: The graph is not a square matrix.");
+    }
+
+    BasicGraph<T> g(static_cast<int>(numVertices));
+    if (numVertices == 0)
+    {
+        return g;
+    }
+    T *matrix = g.mutableRow(0);
+    vector<char> valid(chunks);
+    vector<vector<RowMark>> marks(chunks);
+    parallelFor(0, chunks, [&](size_t c)
+                { valid[c] = parseChunk(text, bounds[c], bounds[c + 1], matrix + firstEntry[c], marks[c]); },
+                threads);
+    if (find(valid.begin(), valid.end(), 0) != valid.end())
+    {
+        throw invalid_argument("Invalid graph: the matrix holds an invalid number.");
+    }
+    if (!rowsAreSquare(marks, firstEntry, numVertices, bracketed))
+    {
+        throw invalid_argument("Invalid graph: The graph is not a square matrix.");
+    }
+    return g;
+}
+
+/**
+ * @brief Writes a graph to a stream, byte for byte like operator<< on a stream with default formatting.
+ * @param g The graph to write.
+ * @param os The stream to write to.
+ * @param threads The number of threads to format on, 0 for the hardware concurrency.
+ * @details Weights are formatted by hand, two digits at a time, into large buffers that are written
+ * with one call each instead of going through the stream's formatting entry by entry.
+ */
+template <typename T>
+void GraphIO::writeMatrix(const BasicGraph<T> &g, ostream &os, size_t threads)
+{
+    formatMatrix(g, threads, [&os](const vector<vector<char>> &buffers, const vector<size_t> &lengths, size_t count)
+                 {
+                     for (size_t b = 0; b < count; ++b)
+                     {
+                         os.write(buffers[b].data(), static_cast<streamsize>(lengths[b]));
+                     }
+                 });
+}
+
+/**
+ * @brief Writes a graph to a file, byte for byte like operator<< on a stream with default formatting.
+ * @param g The graph to write.
+ * @param path The file to create or overwrite.
+ * @param threads The number of threads to format on, 0 for the hardware concurrency.
+ * @throws runtime_error If the file cannot be written.
+ * @details Every batch of formatted blocks goes to the file with a single writev call.
+ */
+template <typename T>
+void GraphIO::writeMatrix(const BasicGraph<T> &g, const string &path, size_t threads)
+{
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        throw runtime_error("cannot create " + path + ": " + strerror(errno));
+    }
+    int error = 0;
+    formatMatrix(g, threads, [&](const vector<vector<char>> &buffers, const vector<size_t> &lengths, size_t count)
+                 {
+                     vector<iovec> pieces;
+                     for (size_t b = 0; b < count; ++b)
+                     {
+                         if (lengths[b] != 0)
+                         {
+                             iovec piece = {const_cast<char *>(buffers[b].data()), lengths[b]};
+                             pieces.push_back(piece);
+                         }
+                     }
+                     size_t next = 0;
+                     while (next < pieces.size() && error == 0)
+                     {
+                         int batch = static_cast<int>(min<size_t>(pieces.size() - next, IOV_MAX));
+                         ssize_t written = writev(fd, &pieces[next], batch);
+                         if (written < 0)
+                         {
+                             error = errno == EINTR ? 0 : errno;
+                             continue;
+                         }
+                         // Skip what was written, a short write leaves part of a piece behind
+                         size_t done = static_cast<size_t>(written);
+                         while (next < pieces.size() && done >= pieces[next].iov_len)
+                         {
+                             done -= pieces[next].iov_len;
+                             ++next;
+                         }
+                         if (next < pieces.size())
+                         {
+                             pieces[next].iov_base = static_cast<char *>(pieces[next].iov_base) + done;
+                             pieces[next].iov_len -= done;
+                         }
+                     }
+                 });
+    if (close(fd) != 0 && error == 0)
+    {
+        error = errno;
+    }
+    if (error != 0)
+    {
+        throw runtime_error("cannot write " + path + ": " + strerror(error));
+    }
+}
+
+#define ARIEL_INSTANTIATE_GRAPHIO(T) \
+    template void GraphIO::writeBinary(const BasicGraph<T> &, const string &); \
+    template void GraphIO::writeBinary(const BasicCSRGraph<T> &, const string &); \
+    template BasicGraph<T> GraphIO::mapGraph(const string &); \
+    template BasicCSRGraph<T> GraphIO::loadCSR(const string &); \
+    template BasicCSRGraph<T> GraphIO::loadEdgeList(const string &, size_t); \
+    template BasicGraph<T> GraphIO::readMatrix(const string &, size_t); \
+    template BasicGraph<T> GraphIO::parseMatrix(const char *, size_t, size_t); \
+    template void GraphIO::writeMatrix(const BasicGraph<T> &, ostream &, size_t); \
+    template void GraphIO::writeMatrix(const BasicGraph<T> &, const string &, size_t);
+
+ARIEL_INSTANTIATE_GRAPHIO(int)
+ARIEL_INSTANTIATE_GRAPHIO(int64_t)
+ARIEL_INSTANTIATE_GRAPHIO(float)
+ARIEL_INSTANTIATE_GRAPHIO(double)
+ARIEL_INSTANTIATE_GRAPHIO(uint8_t)
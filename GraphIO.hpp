@@ -0,0 +1,86 @@
+#ifndef GRAPHIO_HPP
+#define GRAPHIO_HPP
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include "Graph.hpp"
+#include "CSRGraph.hpp"
+using namespace std;
+
+namespace ariel
+{
+    /**
+     * @brief The code stored in binary files for every supported weight type.
+     */
+    template <typename T>
+    struct WeightCode;
+    template <>
+    struct WeightCode<int> { static const uint32_t value = 1; };
+    template <>
+    struct WeightCode<int64_t> { static const uint32_t value = 2; };
+    template <>
+    struct WeightCode<float> { static const uint32_t value = 3; };
+    template <>
+    struct WeightCode<double> { static const uint32_t value = 4; };
+    template <>
+    struct WeightCode<uint8_t> { static const uint32_t value = 5; };
+
+    /**
+     * @brief The header at the start of every binary graph file.
+     * @details All fields are little-endian. The header is 64 bytes and every section starts at a multiple of 64,
+     * so once the file is memory-mapped each section can be used in place as an array of its element type.
+     * A dense file holds the row-major adjacency matrix in its weights section. A CSR file holds numVertices + 1
+     * uint64 offsets, numEdges uint64 targets and numEdges weights.
+     */
+    struct GraphFileHeader
+    {
+        char magic[8];         // "ARIELGR" followed by a zero byte
+        uint32_t version;      // GraphIO::FORMAT_VERSION
+        uint32_t layout;       // GraphIO::DENSE or GraphIO::CSR
+        uint32_t weightType;   // WeightCode<T>::value of the weight type
+        uint32_t weightSize;   // sizeof the weight type
+        uint64_t numVertices;
+        uint64_t numEdges;     // the number of non-zero entries
+        uint64_t offsetsPos;   // byte position of the offsets section, 0 for dense files
+        uint64_t targetsPos;   // byte position of the targets section, 0 for dense files
+        uint64_t weightsPos;   // byte position of the matrix or of the weights section
+    };
+
+    /**
+     * @brief Reading and writing graphs in a versioned binary format.
+     * @details Binary files avoid parsing altogether: mapGraph memory-maps a dense file and returns a read-only
+     * view over the mapping, so opening a graph costs a few system calls no matter how big it is, and pages are
+     * only read from disk when an algorithm touches them. loadEdgeList builds a CSR graph from a text edge list that
+     * may be far too large for a dense matrix, readMatrix parses dense text matrices on several threads, and
+     * writeMatrix is the fast counterpart of operator<<.
+     * Every function is instantiated for the weight types of Graph.
+     */
+    class GraphIO
+    {
+    public:
+        static const uint32_t FORMAT_VERSION = 1;
+        static const uint32_t DENSE = 0;
+        static const uint32_t CSR = 1;
+
+        template <typename T>
+        static void writeBinary(const BasicGraph<T> &g, const string &path);
+        template <typename T>
+        static void writeBinary(const BasicCSRGraph<T> &g, const string &path);
+        template <typename T>
+        static BasicGraph<T> mapGraph(const string &path);
+        template <typename T>
+        static BasicCSRGraph<T> loadCSR(const string &path);
+        template <typename T>
+        static BasicCSRGraph<T> loadEdgeList(const string &path, size_t chunkBytes = 1 << 20);
+        template <typename T>
+        static BasicGraph<T> readMatrix(const string &path, size_t threads = 0);
+        template <typename T>
+        static BasicGraph<T> parseMatrix(const char *text, size_t length, size_t threads = 0);
+        template <typename T>
+        static void writeMatrix(const BasicGraph<T> &g, ostream &os, size_t threads = 0);
+        template <typename T>
+        static void writeMatrix(const BasicGraph<T> &g, const string &path, size_t threads = 0);
+    };
+}
+#endif // GRAPHIO_HPP
@@ -0,0 +1,798 @@
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include "Isomorphism.hpp"
+#include "CSRGraph.hpp"
+#include "Parallel.hpp"
+
+using namespace std;
+using namespace ariel;
+
+namespace
+{
+    const size_t NONE = numeric_limits<size_t>::max();
+
+    /**
+     * @brief What the pattern requires between the vertex matched at some level and one matched earlier.
+     */
+    template <typename T>
+    struct Link
+    {
+        size_t level; // the earlier level
+        T out;        // the pattern weight from the new vertex to the earlier one, 0 for no edge
+        T in;         // the pattern weight from the earlier vertex to the new one
+    };
+
+    /**
+     * @brief Checks if a target entry can stand for a pattern entry.
+     */
+    template <typename T>
+    inline bool edgeFits(T want, T have, const SubgraphOptions &options)
+    {
+        if (want == T(0))
+        {
+            return !options.induced || have == T(0);
+        }
+        return have != T(0) && (!options.matchWeights || have == want);
+    }
+
+    /**
+     * @brief Everything about a search that stays the same while it runs, shared by all the threads.
+     * @details The pattern vertices are matched in a fixed order in the style of VF2++ and RI: the vertex with the
+     * fewest candidates first, then always the vertex with the most edges to the vertices already ordered, so the
+     * edge checks prune the search as early as possible. Every vertex after the first one of its component has a
+     * parent, an earlier neighbor whose image's adjacency list supplies its candidates.
+     */
+    template <typename T>
+    struct MatchPlan
+    {
+        const BasicGraph<T> &target;
+        const SubgraphOptions &options;
+        BasicCSRGraph<T> out;           // the out-neighbors of every target vertex
+        BasicCSRGraph<T> in;            // the in-neighbors of every target vertex
+        vector<size_t> order;           // order[k] is the pattern vertex matched at level k
+        vector<size_t> parent;          // the level of the parent of level k, NONE if it has none
+        vector<bool> parentOut;         // whether the pattern edge goes from the parent to level k
+        vector<vector<Link<T>>> links;  // the entries to check against earlier levels
+        vector<vector<char>> domain;    // domain[k][t] is set if target vertex t passes the filters of level k
+
+        MatchPlan(const BasicGraph<T> &pattern, const BasicGraph<T> &target, const SubgraphOptions &options)
+            : target(target), options(options), out(target), in(out.transpose())
+        {
+            size_t m = pattern.getNumVertices(), n = target.getNumVertices();
+            bool labeled = !options.patternLabels.empty();
+
+            // Label, degree and self-loop filters
+            vector<vector<char>> candidates(m, vector<char>(n, 0));
+            vector<size_t> domainSize(m, 0);
+            for (size_t p = 0; p < m; ++p)
+            {
+                for (size_t t = 0; t < n; ++t)
+                {
+                    bool fits = (!labeled || options.patternLabels[p] == options.targetLabels[t]) &&
+                                target.getOutDegree(t) >= pattern.getOutDegree(p) &&
+                                target.getInDegree(t) >= pattern.getInDegree(p) &&
+                                edgeFits(pattern.getEdge(p, p), target.getEdge(t, t), options);
+                    candidates[p][t] = fits ? 1 : 0;
+                    domainSize[p] += fits ? 1 : 0;
+                }
+            }
+
+            vector<size_t> connections(m, 0);
+            vector<bool> ordered(m, false);
+            for (size_t k = 0; k < m; ++k)
+            {
+                size_t best = NONE;
+                for (size_t p = 0; p < m; ++p)
+                {
+                    if (ordered[p])
+                    {
+                        continue;
+                    }
+                    size_t degree = pattern.getOutDegree(p) + pattern.getInDegree(p);
+                    size_t bestDegree = best == NONE ? 0 : pattern.getOutDegree(best) + pattern.getInDegree(best);
+                    if (best == NONE || connections[p] > connections[best] ||
+                        (connections[p] == connections[best] &&
+                         (domainSize[p] < domainSize[best] || (domainSize[p] == domainSize[best] && degree > bestDegree))))
+                    {
+                        best = p;
+                    }
+                }
+                ordered[best] = true;
+                order.push_back(best);
+                domain.push_back(std::move(candidates[best]));
+
+                parent.push_back(NONE);
+                parentOut.push_back(false);
+                links.push_back(vector<Link<T>>());
+                for (size_t j = 0; j < k; ++j)
+                {
+                    Link<T> link = {j, pattern.getEdge(best, order[j]), pattern.getEdge(order[j], best)};
+                    if (link.in != T(0) && parent[k] == NONE)
+                    {
+                        parent[k] = j;
+                        parentOut[k] = true;
+                    }
+                    else if (link.out != T(0) && parent[k] == NONE)
+                    {
+                        parent[k] = j;
+                    }
+                    if (options.induced || link.out != T(0) || link.in != T(0))
+                    {
+                        links[k].push_back(link);
+                    }
+                }
+                for (size_t q = 0; q < m; ++q)
+                {
+                    if (!ordered[q] && (pattern.getEdge(best, q) != T(0) || pattern.getEdge(q, best) != T(0)))
+                    {
+                        connections[q]++;
+                    }
+                }
+            }
+        }
+    };
+
+    /**
+     * @brief The state of one depth-first search over the plan, one per thread.
+     */
+    template <typename T>
+    struct Searcher
+    {
+        const MatchPlan<T> &plan;
+        const atomic<bool> &stop;
+        vector<size_t> mapping; // mapping[k] is the target vertex of level k
+        vector<char> used;      // the target vertices taken by the current levels
+
+        Searcher(const MatchPlan<T> &plan, const atomic<bool> &stop)
+            : plan(plan), stop(stop), mapping(plan.order.size(), NONE), used(plan.target.getNumVertices(), 0)
+        {
+        }
+
+        bool feasible(size_t level, size_t t) const
+        {
+            for (const Link<T> &link : plan.links[level])
+            {
+                size_t u = mapping[link.level];
+                if (!edgeFits(link.out, plan.target.getEdge(t, u), plan.options) ||
+                    !edgeFits(link.in, plan.target.getEdge(u, t), plan.options))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /**
+         * @brief Tries every candidate for a level and the levels below it up to depth.
+         * @param sink Called with the mapping of every complete match, returns false to end the search.
+         * @return False once the search was ended.
+         */
+        template <typename Sink>
+        bool extend(size_t level, size_t depth, Sink &sink)
+        {
+            if (stop.load(memory_order_relaxed))
+            {
+                return false;
+            }
+            if (level == depth)
+            {
+                return sink(mapping);
+            }
+            size_t from = plan.parent[level];
+            if (from == NONE)
+            {
+                for (size_t t = 0; t < used.size(); ++t)
+                {
+                    if (!tryCandidate(level, t, depth, sink))
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+            const BasicCSRGraph<T> &lists = plan.parentOut[level] ? plan.out : plan.in;
+            size_t u = mapping[from];
+            for (size_t e = lists.getOffsets()[u]; e < lists.getOffsets()[u + 1]; ++e)
+            {
+                if (!tryCandidate(level, lists.getTargets()[e], depth, sink))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        template <typename Sink>
+        bool tryCandidate(size_t level, size_t t, size_t depth, Sink &sink)
+        {
+            if (!plan.domain[level][t] || used[t] || !feasible(level, t))
+            {
+                return true;
+            }
+            mapping[level] = t;
+            used[t] = 1;
+            bool more = extend(level + 1, depth, sink);
+            used[t] = 0;
+            return more;
+        }
+    };
+
+    /**
+     * @brief Mixes a value into a running hash.
+     */
+    inline uint64_t hashMix(uint64_t h, uint64_t value)
+    {
+        h ^= value + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+        h ^= h >> 31;
+        h *= 0xbf58476d1ce4e5b9ULL;
+        return h ^ (h >> 29);
+    }
+
+    template <typename T>
+    inline uint64_t weightBits(T weight)
+    {
+        uint64_t bits = 0;
+        memcpy(&bits, &weight, sizeof(T));
+        return bits;
+    }
+
+    /**
+     * @brief The refinement key of a vertex: its color, its self-loop and the colors of its neighbors with weights.
+     */
+    template <typename T>
+    struct VertexKey
+    {
+        size_t color;
+        T loop;
+        vector<pair<size_t, T>> out;
+        vector<pair<size_t, T>> in;
+
+        bool operator<(const VertexKey &other) const
+        {
+            if (color != other.color)
+            {
+                return color < other.color;
+            }
+            if (loop != other.loop)
+            {
+                return loop < other.loop;
+            }
+            if (out != other.out)
+            {
+                return out < other.out;
+            }
+            return in < other.in;
+        }
+        bool operator==(const VertexKey &other) const
+        {
+            return color == other.color && loop == other.loop && out == other.out && in == other.in;
+        }
+    };
+
+    /**
+     * @brief Computes a canonical labeling by individualization-refinement, in the style of nauty.
+     * @details A coloring gives every vertex the position of its cell in an ordered partition. Refinement
+     * (1-dimensional Weisfeiler-Leman) splits cells by the colors and weights of the neighbors until the partition
+     * is stable. While a cell has several vertices, the search tries each of them in turn as the single first vertex
+     * of the cell and refines again. Every discrete partition at a leaf is a labeling, and the canonical one is the
+     * leaf with the greatest trace of refinement invariants along its path and, among those, the greatest permuted
+     * matrix. Children whose trace is already smaller than the one of the best leaf so far are cut off, and
+     * automorphisms found as leaves with equal matrices prune the children of every node that lie in the orbit
+     * of an explored child.
+     */
+    template <typename T>
+    class Canonizer
+    {
+    public:
+        explicit Canonizer(const BasicGraph<T> &g)
+            : n(g.getNumVertices()), g(g), out(g), in(out.transpose()), haveLeaf(false)
+        {
+        }
+
+        vector<size_t> run()
+        {
+            vector<size_t> color(n, 0);
+            trace.assign(1, refine(color));
+            search(color, 0);
+            return bestLabels;
+        }
+
+    private:
+        size_t n;
+        const BasicGraph<T> &g;
+        BasicCSRGraph<T> out;
+        BasicCSRGraph<T> in;
+        bool haveLeaf;
+        vector<size_t> path;                 // the vertices individualized on the way to the current node
+        vector<size_t> firstPath;            // the same for the first leaf
+        vector<uint64_t> trace;              // the refinement invariants along the current path
+        vector<uint64_t> bestTrace;
+        vector<size_t> firstLabels, bestLabels;
+        vector<T> firstMatrix, bestMatrix;
+        vector<vector<size_t>> automorphisms;
+
+        /**
+         * @brief Refines a coloring until it is stable.
+         * @return An invariant of the refinement, equal for isomorphic inputs.
+         */
+        uint64_t refine(vector<size_t> &color) const
+        {
+            vector<VertexKey<T>> keys(n);
+            vector<size_t> byKey(n);
+            uint64_t h = 0;
+            size_t cells = 0;
+            for (;;)
+            {
+                for (size_t v = 0; v < n; ++v)
+                {
+                    VertexKey<T> &key = keys[v];
+                    key.color = color[v];
+                    key.loop = g.getEdge(v, v);
+                    key.out.clear();
+                    key.in.clear();
+                    for (size_t e = out.getOffsets()[v]; e < out.getOffsets()[v + 1]; ++e)
+                    {
+                        key.out.push_back(make_pair(color[out.getTargets()[e]], out.getWeights()[e]));
+                    }
+                    for (size_t e = in.getOffsets()[v]; e < in.getOffsets()[v + 1]; ++e)
+                    {
+                        key.in.push_back(make_pair(color[in.getTargets()[e]], in.getWeights()[e]));
+                    }
+                    sort(key.out.begin(), key.out.end());
+                    sort(key.in.begin(), key.in.end());
+                    byKey[v] = v;
+                }
+                sort(byKey.begin(), byKey.end(), [&keys](size_t a, size_t b)
+                     { return keys[a] < keys[b]; });
+
+                size_t newCells = 0, start = 0;
+                for (size_t i = 0; i < n; ++i)
+                {
+                    const VertexKey<T> &key = keys[byKey[i]];
+                    if (i == 0 || !(key == keys[byKey[i - 1]]))
+                    {
+                        start = i;
+                        newCells++;
+                        h = hashMix(h, start);
+                        h = hashMix(h, weightBits(key.loop));
+                        for (const pair<size_t, T> &edge : key.out)
+                        {
+                            h = hashMix(hashMix(h, edge.first), weightBits(edge.second));
+                        }
+                        h = hashMix(h, key.out.size());
+                        for (const pair<size_t, T> &edge : key.in)
+                        {
+                            h = hashMix(hashMix(h, edge.first), weightBits(edge.second));
+                        }
+                        h = hashMix(h, key.in.size());
+                    }
+                    color[byKey[i]] = start;
+                }
+                if (newCells == cells)
+                {
+                    return hashMix(h, cells);
+                }
+                cells = newCells;
+            }
+        }
+
+        /**
+         * @brief The adjacency matrix relabeled by a discrete coloring.
+         */
+        vector<T> relabeledMatrix(const vector<size_t> &labels) const
+        {
+            vector<T> matrix(n * n, T(0));
+            for (size_t u = 0; u < n; ++u)
+            {
+                for (size_t e = out.getOffsets()[u]; e < out.getOffsets()[u + 1]; ++e)
+                {
+                    matrix[labels[u] * n + labels[out.getTargets()[e]]] = out.getWeights()[e];
+                }
+            }
+            return matrix;
+        }
+
+        /**
+         * @brief Records the automorphism that maps a leaf labeled `from` onto one labeled `to`.
+         */
+        void addAutomorphism(const vector<size_t> &from, const vector<size_t> &to)
+        {
+            vector<size_t> vertexOf(n), gamma(n);
+            for (size_t v = 0; v < n; ++v)
+            {
+                vertexOf[to[v]] = v;
+            }
+            for (size_t v = 0; v < n; ++v)
+            {
+                gamma[v] = vertexOf[from[v]];
+            }
+            automorphisms.push_back(std::move(gamma));
+        }
+
+        /**
+         * @brief Checks if a vertex lies in the orbit of an explored one under the automorphisms that fix the
+         * first depth vertices of the current path, in which case its subtree mirrors an explored one.
+         */
+        bool inExploredOrbit(size_t w, const vector<size_t> &explored, size_t depth) const
+        {
+            vector<size_t> root(n);
+            for (size_t v = 0; v < n; ++v)
+            {
+                root[v] = v;
+            }
+            auto find = [&root](size_t v)
+            {
+                while (root[v] != v)
+                {
+                    v = root[v] = root[root[v]];
+                }
+                return v;
+            };
+            for (const vector<size_t> &gamma : automorphisms)
+            {
+                bool fixes = true;
+                for (size_t d = 0; d < depth && fixes; ++d)
+                {
+                    fixes = gamma[path[d]] == path[d];
+                }
+                if (!fixes)
+                {
+                    continue;
+                }
+                for (size_t v = 0; v < n; ++v)
+                {
+                    root[find(v)] = find(gamma[v]);
+                }
+            }
+            for (size_t x : explored)
+            {
+                if (find(x) == find(w))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * @brief Compares the trace of the current path with the trace of the best leaf.
+         * @param complete Whether the path ends in a leaf, which makes a proper prefix of the other trace smaller.
+         * @return Negative, zero or positive as the current trace is smaller, equal or greater. Without complete,
+         * zero means that the traces agree as far as both go, so leaves below may still go either way.
+         */
+        int compareTrace(bool complete) const
+        {
+            size_t common = min(trace.size(), bestTrace.size());
+            for (size_t d = 0; d < common; ++d)
+            {
+                if (trace[d] != bestTrace[d])
+                {
+                    return trace[d] < bestTrace[d] ? -1 : 1;
+                }
+            }
+            if (!complete || trace.size() == bestTrace.size())
+            {
+                return 0;
+            }
+            return trace.size() < bestTrace.size() ? -1 : 1;
+        }
+
+        /**
+         * @brief Handles a leaf of the search tree.
+         * @return NONE, or the depth to return to when the leaf revealed that its branch repeats the first one.
+         */
+        size_t leaf(const vector<size_t> &labels)
+        {
+            vector<T> matrix = relabeledMatrix(labels);
+            if (!haveLeaf)
+            {
+                haveLeaf = true;
+                firstPath = path;
+                firstLabels = bestLabels = labels;
+                firstMatrix = bestMatrix = matrix;
+                bestTrace = trace;
+                return NONE;
+            }
+            if (matrix == firstMatrix)
+            {
+                addAutomorphism(firstLabels, labels);
+                size_t common = 0;
+                while (common < path.size() && common < firstPath.size() && path[common] == firstPath[common])
+                {
+                    ++common;
+                }
+                return common;
+            }
+            int order = compareTrace(true);
+            if (order > 0 || (order == 0 && bestMatrix < matrix))
+            {
+                bestLabels = labels;
+                bestMatrix = std::move(matrix);
+                bestTrace = trace;
+            }
+            else if (order == 0 && matrix == bestMatrix)
+            {
+                addAutomorphism(bestLabels, labels);
+            }
+            return NONE;
+        }
+
+        /**
+         * @brief Searches below a node with a refined coloring.
+         * @return NONE, or the depth of the first-path node the search should resume at.
+         */
+        size_t search(const vector<size_t> &color, size_t depth)
+        {
+            // The target cell is the first one with more than one vertex
+            vector<size_t> size(n, 0);
+            for (size_t v = 0; v < n; ++v)
+            {
+                size[color[v]]++;
+            }
+            size_t target = 0;
+            while (target < n && size[target] <= 1)
+            {
+                target++;
+            }
+            if (target == n)
+            {
+                return leaf(color);
+            }
+            vector<size_t> cell;
+            for (size_t v = 0; v < n; ++v)
+            {
+                if (color[v] == target)
+                {
+                    cell.push_back(v);
+                }
+            }
+
+            vector<size_t> explored;
+            for (size_t i = 0; i < cell.size(); ++i)
+            {
+                size_t w = cell[i];
+                if (i > 0 && inExploredOrbit(w, explored, depth))
+                {
+                    continue;
+                }
+                vector<size_t> child = color;
+                for (size_t u : cell)
+                {
+                    if (u != w)
+                    {
+                        child[u] = target + 1;
+                    }
+                }
+                uint64_t invariant = refine(child);
+                trace.resize(depth + 1);
+                trace.push_back(invariant);
+                // Compared against the current best, which may have changed since the parent was compared
+                if (haveLeaf && compareTrace(false) < 0)
+                {
+                    continue; // every leaf below loses to the best one
+                }
+                explored.push_back(w);
+                path.resize(depth);
+                path.push_back(w);
+                size_t resume = search(child, depth + 1);
+                if (resume != NONE && resume < depth)
+                {
+                    return resume;
+                }
+            }
+            return NONE;
+        }
+    };
+}
+
+/**
+ * @brief Finds the occurrences of a pattern graph in a target graph.
+ * @param pattern The graph to look for.
+ * @param target The graph to look in.
+ * @param options Induced or not, weights, vertex labels, the number of matches to find and the threads to use.
+ * @return The embeddings, each mapping every pattern vertex to a distinct target vertex such that every edge of
+ * the pattern maps to an edge of the target. Automorphic matches of the same vertices are reported separately.
+ * @throws invalid_argument If vertex labels are given for one graph but do not cover both graphs.
+ * @details A depth-first search over the pattern vertices in a fixed matching order (see MatchPlan). Candidates
+ * come from the adjacency list of an already matched neighbor and are filtered by label, degree and self-loops
+ * before the edges to the earlier vertices are checked in O(1) each on the dense target matrix.
+ * With several threads the first two levels of the search tree are enumerated up front and the subtrees below
+ * them are handed out to the threads one at a time. The embeddings come out in the same order as on one thread,
+ * except that with a limit the threads may stop at a different set of the same size.
+ */
+template <typename T>
+vector<Isomorphism::Embedding> Isomorphism::subgraphMatches(const BasicGraph<T> &pattern, const BasicGraph<T> &target,
+                                                            const SubgraphOptions &options)
+{
+    size_t m = pattern.getNumVertices(), n = target.getNumVertices();
+    if ((!options.patternLabels.empty() || !options.targetLabels.empty()) &&
+        (options.patternLabels.size() != m || options.targetLabels.size() != n))
+    {
+        throw invalid_argument("the vertex labels do not match the graphs");
+    }
+    vector<Embedding> results;
+    if (m > n)
+    {
+        return results;
+    }
+    if (m == 0)
+    {
+        results.push_back(Embedding());
+        return results;
+    }
+
+    MatchPlan<T> plan(pattern, target, options);
+    auto toEmbedding = [&plan, m](const vector<size_t> &mapping)
+    {
+        Embedding embedding(m);
+        for (size_t k = 0; k < m; ++k)
+        {
+            embedding[plan.order[k]] = mapping[k];
+        }
+        return embedding;
+    };
+    atomic<bool> stop(false);
+    size_t threads = workerCount(options.threads);
+    if (threads <= 1)
+    {
+        Searcher<T> searcher(plan, stop);
+        auto sink = [&](const vector<size_t> &mapping)
+        {
+            results.push_back(toEmbedding(mapping));
+            return options.limit == 0 || results.size() < options.limit;
+        };
+        searcher.extend(0, m, sink);
+        return results;
+    }
+
+    // The first levels of the search tree become independent tasks
+    size_t split = min<size_t>(2, m);
+    vector<vector<size_t>> prefixes;
+    {
+        Searcher<T> searcher(plan, stop);
+        auto sink = [&](const vector<size_t> &mapping)
+        {
+            prefixes.push_back(vector<size_t>(mapping.begin(), mapping.begin() + split));
+            return true;
+        };
+        searcher.extend(0, split, sink);
+    }
+    vector<vector<Embedding>> found(prefixes.size());
+    atomic<size_t> nextTask(0), total(0);
+    size_t workers = min(threads, prefixes.size());
+    parallelFor(0, workers, [&](size_t)
+                {
+                    Searcher<T> searcher(plan, stop);
+                    for (size_t task = nextTask++; task < prefixes.size() && !stop.load(); task = nextTask++)
+                    {
+                        vector<Embedding> &sinkTo = found[task];
+                        auto sink = [&](const vector<size_t> &mapping)
+                        {
+                            sinkTo.push_back(toEmbedding(mapping));
+                            if (options.limit != 0 && ++total >= options.limit)
+                            {
+                                stop = true;
+                                return false;
+                            }
+                            return true;
+                        };
+                        for (size_t k = 0; k < split; ++k)
+                        {
+                            searcher.mapping[k] = prefixes[task][k];
+                            searcher.used[prefixes[task][k]] = 1;
+                        }
+                        searcher.extend(split, m, sink);
+                        for (size_t k = 0; k < split; ++k)
+                        {
+                            searcher.used[prefixes[task][k]] = 0;
+                        }
+                    }
+                },
+                workers);
+
+    for (vector<Embedding> &part : found)
+    {
+        for (Embedding &embedding : part)
+        {
+            if (options.limit != 0 && results.size() == options.limit)
+            {
+                return results;
+            }
+            results.push_back(std::move(embedding));
+        }
+    }
+    return results;
+}
+
+/**
+ * @brief Checks if a graph occurs in another one up to a relabeling of the vertices.
+ * @param pattern The graph to look for.
+ * @param target The graph to look in.
+ * @param options As for subgraphMatches, the limit is ignored.
+ * @return True if there is at least one embedding.
+ * @throws invalid_argument If vertex labels are given for one graph but do not cover both graphs.
+ */
+template <typename T>
+bool Isomorphism::isSubgraph(const BasicGraph<T> &pattern, const BasicGraph<T> &target, const SubgraphOptions &options)
+{
+    SubgraphOptions first = options;
+    first.limit = 1;
+    return !subgraphMatches(pattern, target, first).empty();
+}
+
+/**
+ * @brief Computes a canonical labeling of a graph.
+ * @param g The graph.
+ * @return A permutation that relabels g into its canonical form, the same matrix for every graph isomorphic to g.
+ * @details Individualization-refinement in the style of nauty, see Canonizer. Graphs that refinement alone
+ * tells apart, which are almost all graphs, take a single path of the search tree, and highly symmetric graphs
+ * are kept in check by automorphism pruning. Weights are part of the structure, so the canonical form only
+ * identifies graphs whose relabeled matrices are equal.
+ */
+template <typename T>
+Permutation Isomorphism::canonicalPermutation(const BasicGraph<T> &g)
+{
+    vector<size_t> labels = Canonizer<T>(g).run();
+    vector<size_t> order(labels.size());
+    for (size_t v = 0; v < labels.size(); ++v)
+    {
+        order[labels[v]] = v;
+    }
+    return Permutation(std::move(order));
+}
+
+/**
+ * @brief Relabels a graph into its canonical form.
+ * @param g The graph.
+ * @return The graph permuted by canonicalPermutation, equal (==) for all graphs isomorphic to g.
+ */
+template <typename T>
+BasicGraph<T> Isomorphism::canonicalForm(const BasicGraph<T> &g)
+{
+    return Reorder::permute(g, canonicalPermutation(g));
+}
+
+/**
+ * @brief Hashes a graph up to isomorphism.
+ * @param g The graph.
+ * @return The fingerprint of the canonical form, equal for isomorphic graphs. Graphs with equal hashes are
+ * isomorphic unless the hashes collide, compare their canonical forms to be sure.
+ */
+template <typename T>
+uint64_t Isomorphism::canonicalHash(const BasicGraph<T> &g)
+{
+    return canonicalForm(g).fingerprint();
+}
+
+/**
+ * @brief Checks if two graphs are the same up to a relabeling of the vertices.
+ * @param a The first graph.
+ * @param b The second graph.
+ * @return True if some permutation of the vertices of a turns it into b, weights included.
+ */
+template <typename T>
+bool Isomorphism::isIsomorphic(const BasicGraph<T> &a, const BasicGraph<T> &b)
+{
+    if (a.getNumVertices() != b.getNumVertices() || a.getNumEdges() != b.getNumEdges())
+    {
+        return false;
+    }
+    return canonicalForm(a) == canonicalForm(b);
+}
+
+#define ARIEL_INSTANTIATE_ISOMORPHISM(T) \
+    template vector<Isomorphism::Embedding> Isomorphism::subgraphMatches(const BasicGraph<T> &, const BasicGraph<T> &, const SubgraphOptions &); \
+    template bool Isomorphism::isSubgraph(const BasicGraph<T> &, const BasicGraph<T> &, const SubgraphOptions &); \
+    template Permutation Isomorphism::canonicalPermutation(const BasicGraph<T> &); \
+    template BasicGraph<T> Isomorphism::canonicalForm(const BasicGraph<T> &); \
+    template uint64_t Isomorphism::canonicalHash(const BasicGraph<T> &); \
+    template bool Isomorphism::isIsomorphic(const BasicGraph<T> &, const BasicGraph<T> &);
+
+ARIEL_INSTANTIATE_ISOMORPHISM(int)
+ARIEL_INSTANTIATE_ISOMORPHISM(int64_t)
+ARIEL_INSTANTIATE_ISOMORPHISM(float)
+ARIEL_INSTANTIATE_ISOMORPHISM(double)
+ARIEL_INSTANTIATE_ISOMORPHISM(uint8_t)
@@ -0,0 +1,58 @@
+#ifndef ISOMORPHISM_HPP
+#define ISOMORPHISM_HPP
+
+#include <cstdint>
+#include <vector>
+#include "Graph.hpp"
+#include "Reorder.hpp"
+using namespace std;
+
+namespace ariel
+{
+    /**
+     * @brief What counts as an occurrence of a pattern in a subgraph search, and how many to find.
+     */
+    struct SubgraphOptions
+    {
+        size_t limit;                   // stop after this many embeddings, 0 finds them all
+        bool induced;                   // non-edges of the pattern must map to non-edges as well
+        bool matchWeights;              // mapped edges must have equal weights, not just both be non-zero
+        size_t threads;                 // threads for the search, 0 for the hardware concurrency
+        vector<long long> patternLabels; // optional vertex labels, a vertex only maps to one with the same label
+        vector<long long> targetLabels;
+
+        SubgraphOptions() : limit(0), induced(false), matchWeights(false), threads(1) {}
+    };
+
+    /**
+     * @brief Finding one graph inside another up to a relabeling of the vertices.
+     * @details Unlike containsGraph, which looks for the matrix of the pattern as a block of the matrix of the
+     * target, a subgraph search maps the pattern vertices to any distinct target vertices, which is what motif
+     * detection needs. The canonical form relabels a graph so that all graphs isomorphic to it get the very same
+     * matrix, which turns isomorphism tests over a collection of graphs into hash lookups.
+     * Every function is instantiated for the weight types of Graph.
+     */
+    class Isomorphism
+    {
+    public:
+        // embedding[p] is the target vertex that pattern vertex p is mapped to
+        typedef vector<size_t> Embedding;
+
+        template <typename T>
+        static vector<Embedding> subgraphMatches(const BasicGraph<T> &pattern, const BasicGraph<T> &target,
+                                                 const SubgraphOptions &options = SubgraphOptions());
+        template <typename T>
+        static bool isSubgraph(const BasicGraph<T> &pattern, const BasicGraph<T> &target,
+                               const SubgraphOptions &options = SubgraphOptions());
+
+        template <typename T>
+        static Permutation canonicalPermutation(const BasicGraph<T> &g);
+        template <typename T>
+        static BasicGraph<T> canonicalForm(const BasicGraph<T> &g);
+        template <typename T>
+        static uint64_t canonicalHash(const BasicGraph<T> &g);
+        template <typename T>
+        static bool isIsomorphic(const BasicGraph<T> &a, const BasicGraph<T> &b);
+    };
+}
+#endif // ISOMORPHISM_HPP
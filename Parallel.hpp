@@ -0,0 +1,107 @@
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace ariel
+{
+    /**
+     * @brief Returns the number of worker threads to use for parallel kernels.
+     * @param requested The number of threads asked for by the caller, or 0 for "use the hardware".
+     * @return A thread count that is at least 1.
+     */
+    inline size_t workerCount(size_t requested = 0)
+    {
+        if (requested != 0)
+        {
+            return requested;
+        }
+        size_t hw = std::thread::hardware_concurrency();
+        return hw == 0 ? 1 : hw;
+    }
+
+    /**
+     * @brief Runs body(i) for every i in [begin, end) across several threads.
+     * @param begin The first index.
+     * @param end One past the last index.
+     * @param body The callable to invoke for each index.
+     * @param threads The number of threads to use, 0 for the hardware concurrency.
+     * @details The range is split into contiguous chunks, one per thread, and the calling thread
+     * works on the first chunk itself. Small ranges run inline without spawning any thread.
+     * An exception thrown by body stops the rest of its chunk, every thread is still joined,
+     * and then the exception of the lowest chunk that failed is rethrown in the calling thread.
+     */
+    template <typename Body>
+    void parallelFor(size_t begin, size_t end, Body body, size_t threads = 0)
+    {
+        if (end <= begin)
+        {
+            return;
+        }
+        size_t count = end - begin;
+        size_t workers = std::min(workerCount(threads), count);
+        if (workers <= 1)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                body(i);
+            }
+            return;
+        }
+
+        size_t chunk = (count + workers - 1) / workers;
+        std::vector<std::exception_ptr> errors(workers);
+        auto runChunk = [begin, end, chunk, &body, &errors](size_t w)
+        {
+            try
+            {
+                size_t lo = begin + w * chunk;
+                size_t hi = std::min(end, lo + chunk);
+                for (size_t i = lo; i < hi; ++i)
+                {
+                    body(i);
+                }
+            }
+            catch (...)
+            {
+                errors[w] = std::current_exception();
+            }
+        };
+        std::vector<std::thread> pool;
+        pool.reserve(workers - 1);
+        size_t w = 1;
+        for (; w < workers && begin + w * chunk < end; ++w)
+        {
+            try
+            {
+                pool.push_back(std::thread(runChunk, w));
+            }
+            catch (const std::system_error &)
+            {
+                break; // out of threads, the calling thread takes over the remaining chunks
+            }
+        }
+        runChunk(0);
+        for (; w < workers; ++w)
+        {
+            runChunk(w);
+        }
+        for (size_t t = 0; t < pool.size(); ++t)
+        {
+            pool[t].join();
+        }
+        for (size_t t = 0; t < workers; ++t)
+        {
+            if (errors[t])
+            {
+                std::rethrow_exception(errors[t]);
+            }
+        }
+    }
+}
+#endif // PARALLEL_HPP
@@ -0,0 +1,378 @@
+#include <algorithm>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include "Reorder.hpp"
+
+using namespace std;
+using namespace ariel;
+
+/**
+ * @brief Builds a permutation from the order the vertices are placed in.
+ * @param order order[k] is the original vertex that gets label k.
+ * @throws invalid_argument If order is not a permutation of 0 .. order.size() - 1.
+ */
+Permutation::Permutation(vector<size_t> order) : newId(order.size(), order.size()), oldId(std::move(order))
+{
+    for (size_t k = 0; k < oldId.size(); ++k)
+    {
+        if (oldId[k] >= oldId.size() || newId[oldId[k]] != oldId.size())
+        {
+            throw invalid_argument("the order is not a permutation of the vertices");
+        }
+        newId[oldId[k]] = k;
+    }
+}
+
+namespace
+{
+    /**
+     * @brief The undirected view of a CSR graph used by the orderings: the out-edges followed by the in-edges.
+     */
+    template <typename T>
+    struct Undirected
+    {
+        const BasicCSRGraph<T> &out;
+        BasicCSRGraph<T> in;
+
+        explicit Undirected(const BasicCSRGraph<T> &g) : out(g), in(g.transpose()) {}
+
+        size_t degree(size_t v) const
+        {
+            return out.degree(v) + in.degree(v);
+        }
+
+        template <typename Visit>
+        void forEachNeighbor(size_t v, Visit visit) const
+        {
+            for (size_t e = out.getOffsets()[v]; e < out.getOffsets()[v + 1]; ++e)
+            {
+                visit(out.getTargets()[e]);
+            }
+            for (size_t e = in.getOffsets()[v]; e < in.getOffsets()[v + 1]; ++e)
+            {
+                visit(in.getTargets()[e]);
+            }
+        }
+    };
+
+    /**
+     * @brief Appends the breadth-first order of the component of start, visiting neighbors in the order given by less.
+     */
+    template <typename T, typename Less>
+    void bfsComponent(const Undirected<T> &g, size_t start, vector<bool> &placed, vector<size_t> &order, Less less)
+    {
+        size_t head = order.size();
+        order.push_back(start);
+        placed[start] = true;
+        vector<size_t> next;
+        for (; head < order.size(); ++head)
+        {
+            next.clear();
+            g.forEachNeighbor(order[head], [&](size_t u)
+                              {
+                                  if (!placed[u])
+                                  {
+                                      placed[u] = true;
+                                      next.push_back(u);
+                                  }
+                              });
+            sort(next.begin(), next.end(), less);
+            order.insert(order.end(), next.begin(), next.end());
+        }
+    }
+}
+
+/**
+ * @brief Numbers the vertices in breadth-first order, component after component.
+ * @param g The graph, edges are followed in both directions.
+ * @return The permutation.
+ */
+template <typename T>
+Permutation Reorder::bfsOrder(const BasicCSRGraph<T> &g)
+{
+    size_t numVertices = g.getNumVertices();
+    Undirected<T> undirected(g);
+    vector<bool> placed(numVertices, false);
+    vector<size_t> order;
+    order.reserve(numVertices);
+    for (size_t v = 0; v < numVertices; ++v)
+    {
+        if (!placed[v])
+        {
+            bfsComponent(undirected, v, placed, order, less<size_t>());
+        }
+    }
+    return Permutation(std::move(order));
+}
+
+/**
+ * @brief Numbers the vertices in reverse Cuthill-McKee order, which keeps the labels of neighbors close.
+ * @param g The graph, edges are followed in both directions.
+ * @return The permutation.
+ * @details Every component is searched breadth-first from one of its vertices of lowest degree, visiting the
+ * neighbors of each vertex by increasing degree, and the final order is reversed. This is the classic
+ * bandwidth-reducing ordering for meshes and road networks.
+ */
+template <typename T>
+Permutation Reorder::reverseCuthillMcKee(const BasicCSRGraph<T> &g)
+{
+    size_t numVertices = g.getNumVertices();
+    Undirected<T> undirected(g);
+    vector<size_t> byDegree(numVertices);
+    for (size_t v = 0; v < numVertices; ++v)
+    {
+        byDegree[v] = v;
+    }
+    auto lowerDegree = [&](size_t a, size_t b)
+    {
+        size_t da = undirected.degree(a), db = undirected.degree(b);
+        return da != db ? da < db : a < b;
+    };
+    sort(byDegree.begin(), byDegree.end(), lowerDegree);
+
+    vector<bool> placed(numVertices, false);
+    vector<size_t> order;
+    order.reserve(numVertices);
+    for (size_t start : byDegree)
+    {
+        if (!placed[start])
+        {
+            bfsComponent(undirected, start, placed, order, lowerDegree);
+        }
+    }
+    reverse(order.begin(), order.end());
+    return Permutation(std::move(order));
+}
+
+/**
+ * @brief Numbers the vertices by decreasing degree, so the hubs that most edges lead to share a few cache lines.
+ * @param g The graph, the degree counts both in- and out-edges.
+ * @return The permutation, ties keep their original order.
+ */
+template <typename T>
+Permutation Reorder::degreeSort(const BasicCSRGraph<T> &g)
+{
+    size_t numVertices = g.getNumVertices();
+    vector<size_t> degree(numVertices, 0);
+    for (size_t v = 0; v < numVertices; ++v)
+    {
+        degree[v] += g.degree(v);
+    }
+    for (size_t target : g.getTargets())
+    {
+        degree[target]++;
+    }
+    vector<size_t> order(numVertices);
+    for (size_t v = 0; v < numVertices; ++v)
+    {
+        order[v] = v;
+    }
+    stable_sort(order.begin(), order.end(), [&degree](size_t a, size_t b)
+                { return degree[a] > degree[b]; });
+    return Permutation(std::move(order));
+}
+
+/**
+ * @brief Numbers the vertices greedily so that each one shares as many neighbors as possible with the few placed
+ * just before it, in the style of Gorder.
+ * @param g The graph.
+ * @param window How many of the last placed vertices a new vertex is scored against.
+ * @return The permutation.
+ * @details The score of an unplaced vertex counts its edges to the vertices in the window plus the in-neighbors
+ * it shares with them ("siblings"). A vertex entering the window raises the scores around it and one leaving it
+ * lowers them again, and a lazy max-heap yields the best vertex at every step. Sibling updates through vertices
+ * of more than twice the average out-degree are skipped, in the spirit of Gorder's hub handling, since they cost
+ * a lot and say little.
+ */
+template <typename T>
+Permutation Reorder::gorder(const BasicCSRGraph<T> &g, size_t window)
+{
+    size_t numVertices = g.getNumVertices();
+    BasicCSRGraph<T> in = g.transpose();
+    const vector<size_t> &outOffsets = g.getOffsets();
+    const vector<size_t> &outTargets = g.getTargets();
+    const vector<size_t> &inOffsets = in.getOffsets();
+    const vector<size_t> &inTargets = in.getTargets();
+    // Sibling updates cost the square of the parent's degree, so only parents of modest degree take part
+    size_t hubDegree = max<size_t>(8, numVertices == 0 ? 0 : 2 * g.getNumEdges() / numVertices);
+
+    vector<long long> score(numVertices, 0);
+    vector<bool> placed(numVertices, false);
+    priority_queue<pair<long long, size_t>> heap;
+    auto adjust = [&](size_t v, long long delta)
+    {
+        if (placed[v])
+        {
+            return;
+        }
+        score[v] += delta;
+        if (delta > 0)
+        {
+            heap.push(make_pair(score[v], v));
+        }
+    };
+    auto update = [&](size_t v, long long delta)
+    {
+        for (size_t e = outOffsets[v]; e < outOffsets[v + 1]; ++e)
+        {
+            adjust(outTargets[e], delta);
+        }
+        for (size_t e = inOffsets[v]; e < inOffsets[v + 1]; ++e)
+        {
+            size_t parent = inTargets[e];
+            adjust(parent, delta);
+            if (outOffsets[parent + 1] - outOffsets[parent] <= hubDegree)
+            {
+                for (size_t f = outOffsets[parent]; f < outOffsets[parent + 1]; ++f)
+                {
+                    adjust(outTargets[f], delta);
+                }
+            }
+        }
+    };
+
+    vector<size_t> order;
+    order.reserve(numVertices);
+    size_t nextUnplaced = 0;
+    while (order.size() < numVertices)
+    {
+        size_t chosen = numVertices;
+        while (!heap.empty() && chosen == numVertices)
+        {
+            pair<long long, size_t> top = heap.top();
+            heap.pop();
+            if (placed[top.second] || top.first != score[top.second])
+            {
+                continue; // placed already, or the score went down since it was pushed
+            }
+            chosen = top.second;
+        }
+        if (chosen == numVertices || score[chosen] <= 0)
+        {
+            // Nothing near the window, start from the lowest unplaced label
+            while (placed[nextUnplaced])
+            {
+                ++nextUnplaced;
+            }
+            chosen = chosen != numVertices && score[chosen] > 0 ? chosen : nextUnplaced;
+        }
+        placed[chosen] = true;
+        order.push_back(chosen);
+        update(chosen, 1);
+        if (order.size() > window)
+        {
+            update(order[order.size() - window - 1], -1);
+        }
+    }
+    return Permutation(std::move(order));
+}
+
+/**
+ * @brief Relabels a CSR graph.
+ * @param g The graph.
+ * @param p The permutation, the edge (u, v) becomes (p.newId[u], p.newId[v]).
+ * @return The reordered graph, every edge list sorted by target.
+ * @throws invalid_argument If the permutation does not match the graph.
+ */
+template <typename T>
+BasicCSRGraph<T> Reorder::permute(const BasicCSRGraph<T> &g, const Permutation &p)
+{
+    size_t numVertices = g.getNumVertices();
+    if (p.size() != numVertices)
+    {
+        throw invalid_argument("the permutation does not match the graph");
+    }
+    const vector<size_t> &offsets = g.getOffsets();
+    vector<size_t> newOffsets(numVertices + 1, 0);
+    for (size_t r = 0; r < numVertices; ++r)
+    {
+        newOffsets[r + 1] = newOffsets[r] + g.degree(p.oldId[r]);
+    }
+    vector<size_t> newTargets(g.getNumEdges());
+    vector<T> newWeights(g.getNumEdges());
+    vector<pair<size_t, T>> edges;
+    for (size_t r = 0; r < numVertices; ++r)
+    {
+        size_t u = p.oldId[r];
+        edges.clear();
+        for (size_t e = offsets[u]; e < offsets[u + 1]; ++e)
+        {
+            edges.push_back(make_pair(p.newId[g.getTargets()[e]], g.getWeights()[e]));
+        }
+        sort(edges.begin(), edges.end(), [](const pair<size_t, T> &a, const pair<size_t, T> &b)
+             { return a.first < b.first; });
+        for (size_t i = 0; i < edges.size(); ++i)
+        {
+            newTargets[newOffsets[r] + i] = edges[i].first;
+            newWeights[newOffsets[r] + i] = edges[i].second;
+        }
+    }
+    return BasicCSRGraph<T>(std::move(newOffsets), std::move(newTargets), std::move(newWeights));
+}
+
+/**
+ * @brief Gathers the matrix of a graph into a new order, rows[r][c] = g[order[r]][order[c]].
+ */
+template <typename T>
+static BasicGraph<T> gather(const BasicGraph<T> &g, const vector<size_t> &order)
+{
+    size_t numVertices = g.getNumVertices();
+    if (order.size() != numVertices)
+    {
+        throw invalid_argument("the permutation does not match the graph");
+    }
+    vector<vector<T>> rows(numVertices, vector<T>(numVertices));
+    for (size_t r = 0; r < numVertices; ++r)
+    {
+        const T *row = g.getRow(order[r]);
+        for (size_t c = 0; c < numVertices; ++c)
+        {
+            rows[r][c] = row[order[c]];
+        }
+    }
+    BasicGraph<T> result;
+    result.loadGraph(std::move(rows));
+    return result;
+}
+
+/**
+ * @brief Relabels a graph.
+ * @param g The graph.
+ * @param p The permutation, the entry [u][v] moves to [p.newId[u]][p.newId[v]].
+ * @return The reordered graph.
+ * @throws invalid_argument If the permutation does not match the graph.
+ */
+template <typename T>
+BasicGraph<T> Reorder::permute(const BasicGraph<T> &g, const Permutation &p)
+{
+    return gather(g, p.oldId);
+}
+
+/**
+ * @brief Translates a matrix result of the reordered graph, e.g. its distances, back to the original labels.
+ * @param g A matrix indexed by new labels.
+ * @param p The permutation that produced the reordered graph.
+ * @return The same matrix indexed by original vertices.
+ * @throws invalid_argument If the permutation does not match the graph.
+ */
+template <typename T>
+BasicGraph<T> Reorder::toOriginal(const BasicGraph<T> &g, const Permutation &p)
+{
+    return gather(g, p.newId);
+}
+
+#define ARIEL_INSTANTIATE_REORDER(T) \
+    template Permutation Reorder::bfsOrder(const BasicCSRGraph<T> &); \
+    template Permutation Reorder::reverseCuthillMcKee(const BasicCSRGraph<T> &); \
+    template Permutation Reorder::degreeSort(const BasicCSRGraph<T> &); \
+    template Permutation Reorder::gorder(const BasicCSRGraph<T> &, size_t); \
+    template BasicCSRGraph<T> Reorder::permute(const BasicCSRGraph<T> &, const Permutation &); \
+    template BasicGraph<T> Reorder::permute(const BasicGraph<T> &, const Permutation &); \
+    template BasicGraph<T> Reorder::toOriginal(const BasicGraph<T> &, const Permutation &);
+
+ARIEL_INSTANTIATE_REORDER(int)
+ARIEL_INSTANTIATE_REORDER(int64_t)
+ARIEL_INSTANTIATE_REORDER(float)
+ARIEL_INSTANTIATE_REORDER(double)
+ARIEL_INSTANTIATE_REORDER(uint8_t)
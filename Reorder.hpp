@@ -0,0 +1,68 @@
+#ifndef REORDER_HPP
+#define REORDER_HPP
+
+#include <vector>
+#include "Graph.hpp"
+#include "CSRGraph.hpp"
+using namespace std;
+
+namespace ariel
+{
+    /**
+     * @brief A relabeling of the vertices of a graph.
+     * @details newId[v] is the label of original vertex v in the reordered graph and oldId is its inverse,
+     * oldId[newId[v]] == v.
+     */
+    struct Permutation
+    {
+        vector<size_t> newId;
+        vector<size_t> oldId;
+
+        Permutation() {}
+        explicit Permutation(vector<size_t> order);
+        size_t size() const { return oldId.size(); }
+
+        /**
+         * @brief Translates a per-vertex result of the reordered graph back to the original vertices.
+         * @param byNewId A value for every vertex of the reordered graph, indexed by new label.
+         * @return The same values indexed by original vertex.
+         */
+        template <typename V>
+        vector<V> toOriginal(const vector<V> &byNewId) const
+        {
+            vector<V> byOldId(byNewId.size());
+            for (size_t v = 0; v < oldId.size(); ++v)
+            {
+                byOldId[oldId[v]] = byNewId[v];
+            }
+            return byOldId;
+        }
+    };
+
+    /**
+     * @brief Vertex reordering passes that renumber a graph for cache locality.
+     * @details Every traversal does better when the neighbors of a vertex have nearby labels, since their rows
+     * or flags then share cache lines and pages. An ordering is computed on the CSR form and applied with permute,
+     * and the Permutation translates results back to the original labels.
+     */
+    class Reorder
+    {
+    public:
+        template <typename T>
+        static Permutation bfsOrder(const BasicCSRGraph<T> &g);
+        template <typename T>
+        static Permutation reverseCuthillMcKee(const BasicCSRGraph<T> &g);
+        template <typename T>
+        static Permutation degreeSort(const BasicCSRGraph<T> &g);
+        template <typename T>
+        static Permutation gorder(const BasicCSRGraph<T> &g, size_t window = 5);
+
+        template <typename T>
+        static BasicCSRGraph<T> permute(const BasicCSRGraph<T> &g, const Permutation &p);
+        template <typename T>
+        static BasicGraph<T> permute(const BasicGraph<T> &g, const Permutation &p);
+        template <typename T>
+        static BasicGraph<T> toOriginal(const BasicGraph<T> &g, const Permutation &p);
+    };
+}
+#endif // REORDER_HPP
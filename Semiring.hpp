@@ -0,0 +1,173 @@
+#ifndef SEMIRING_HPP
+#define SEMIRING_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include "Arithmetic.hpp"
+#include "Parallel.hpp"
+
+namespace ariel
+{
+    /*
+     * Semirings for Graph::product. Every semiring provides, for a weight type T,
+     *   zero<T>()   the identity of add, which also annihilates mul ("no edge")
+     *   one<T>()    the identity of mul
+     *   add(a, b), mul(a, b)
+     */
+
+    /**
+     * @brief The ordinary (+, *) semiring, used by Graph::operator*. Integer overflow wraps around like the Wrapping policy.
+     */
+    struct PlusTimes
+    {
+        template <typename T>
+        T zero() const { return T(0); }
+        template <typename T>
+        T one() const { return T(1); }
+        template <typename T>
+        T add(T a, T b) const { return ArithmeticTraits<T>::wrapAdd(a, b); }
+        template <typename T>
+        T mul(T a, T b) const { return ArithmeticTraits<T>::wrapMul(a, b); }
+    };
+
+    /**
+     * @brief The tropical (min, +) semiring. numeric_limits<T>::max() stands for "no path".
+     * @details Squaring a distance matrix in this semiring doubles the number of edges its paths may use.
+     * Graph::distanceMatrix turns an adjacency matrix, where 0 means "no edge", into such a distance matrix.
+     * Path lengths are added in the wide type and clamped, so a path too long for T becomes "no path" instead of wrapping.
+     */
+    struct MinPlus
+    {
+        template <typename T>
+        T zero() const { return std::numeric_limits<T>::max(); }
+        template <typename T>
+        T one() const { return T(0); }
+        template <typename T>
+        T add(T a, T b) const { return a < b ? a : b; }
+        template <typename T>
+        T mul(T a, T b) const
+        {
+            return (a == zero<T>() || b == zero<T>()) ? zero<T>() : clampTo<T>(static_cast<typename ArithmeticTraits<T>::Wide>(a) + b);
+        }
+    };
+
+    /**
+     * @brief The bottleneck (max, min) semiring over non-negative capacities, 0 stands for "no edge".
+     * @details Squaring a capacity matrix in this semiring computes widest paths.
+     */
+    struct MaxMin
+    {
+        template <typename T>
+        T zero() const { return T(0); }
+        template <typename T>
+        T one() const { return std::numeric_limits<T>::max(); }
+        template <typename T>
+        T add(T a, T b) const { return a > b ? a : b; }
+        template <typename T>
+        T mul(T a, T b) const { return a < b ? a : b; }
+    };
+
+    /**
+     * @brief The boolean (or, and) semiring, any non-zero entry counts as true and results are 0 or 1.
+     */
+    struct BooleanSemiring
+    {
+        template <typename T>
+        T zero() const { return T(0); }
+        template <typename T>
+        T one() const { return T(1); }
+        template <typename T>
+        T add(T a, T b) const { return static_cast<T>((a != T(0)) | (b != T(0))); }
+        template <typename T>
+        T mul(T a, T b) const { return static_cast<T>((a != T(0)) & (b != T(0))); }
+    };
+
+    /**
+     * @brief The ring of integers modulo a positive modulus, entries are kept in [0, modulus).
+     * @details Intermediate sums and products are computed in 64 bits so nothing overflows for any int modulus.
+     * Only meaningful for integral weight types.
+     */
+    struct ModPlusTimes
+    {
+        long long modulus;
+
+        explicit ModPlusTimes(int modulus) : modulus(modulus) {}
+        template <typename T>
+        T zero() const { return T(0); }
+        template <typename T>
+        T one() const { return static_cast<T>(1 % modulus); }
+        template <typename T>
+        T add(T a, T b) const
+        {
+            long long sum = static_cast<long long>(a) + static_cast<long long>(b);
+            return static_cast<T>(sum >= modulus ? sum - modulus : sum);
+        }
+        template <typename T>
+        T mul(T a, T b) const { return static_cast<T>(static_cast<long long>(a) * static_cast<long long>(b) % modulus); }
+        template <typename T>
+        T reduce(T a) const
+        {
+            long long r = static_cast<long long>(a) % modulus;
+            return static_cast<T>(r < 0 ? r + modulus : r);
+        }
+    };
+
+    /**
+     * @brief Computes c = a * b over the semiring s for square n x n matrices given as row pointers.
+     * @param s The semiring supplying add, mul and zero.
+     * @param a The rows of the left operand.
+     * @param b The rows of the right operand.
+     * @param c The rows of the result, they must not alias a or b.
+     * @param n The dimension of the matrices.
+     * @param threads The number of threads to use, 0 for the hardware concurrency.
+     * @details The loops are blocked so that a band of b stays in cache while a block of rows of a streams over it,
+     * and the row blocks are processed in parallel. Entries of a equal to the semiring zero are skipped since they
+     * annihilate the product, which makes sparse adjacency matrices cheap. The innermost loop runs over contiguous
+     * memory with branch-free operations so that the compiler can vectorize it.
+     */
+    template <typename S, typename T>
+    void semiringProduct(const S &s, const T *const *a, const T *const *b, T *const *c, size_t n, size_t threads = 0)
+    {
+        const size_t rowBlock = 32;
+        const size_t innerBlock = 128;
+        const size_t colBlock = 512;
+        size_t rowBlocks = (n + rowBlock - 1) / rowBlock;
+
+        parallelFor(0, rowBlocks, [&](size_t ib)
+                    {
+                        size_t iEnd = std::min(n, (ib + 1) * rowBlock);
+                        for (size_t i = ib * rowBlock; i < iEnd; ++i)
+                        {
+                            std::fill(c[i], c[i] + n, s.template zero<T>());
+                        }
+                        for (size_t kb = 0; kb < n; kb += innerBlock)
+                        {
+                            size_t kEnd = std::min(n, kb + innerBlock);
+                            for (size_t jb = 0; jb < n; jb += colBlock)
+                            {
+                                size_t jEnd = std::min(n, jb + colBlock);
+                                for (size_t i = ib * rowBlock; i < iEnd; ++i)
+                                {
+                                    T *ci = c[i];
+                                    for (size_t k = kb; k < kEnd; ++k)
+                                    {
+                                        T aik = a[i][k];
+                                        if (aik == s.template zero<T>())
+                                        {
+                                            continue;
+                                        }
+                                        const T *bk = b[k];
+                                        for (size_t j = jb; j < jEnd; ++j)
+                                        {
+                                            ci[j] = s.add(ci[j], s.mul(aik, bk[j]));
+                                        }
+                                    }
+                                }
+                            }
+                        }
+                    },
+                    threads);
+    }
+}
+#endif // SEMIRING_HPP
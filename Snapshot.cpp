@@ -0,0 +1,291 @@
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "GraphIO.hpp"
+#include "Snapshot.hpp"
+
+using namespace std;
+using namespace ariel;
+
+static_assert(sizeof(DeltaFileHeader) == 32, "the delta log header must be 32 bytes");
+
+template <typename T>
+const uint32_t BasicSnapshot<T>::FORMAT_VERSION;
+template <typename T>
+const size_t BasicSnapshot<T>::RECORD_SIZE;
+
+static const char DELTA_MAGIC[8] = {'A', 'R', 'I', 'E', 'L', 'D', 'L', '\0'};
+
+// Records are replayed in batches of this many
+static const size_t REPLAY_BATCH = 4096;
+
+/**
+ * @brief Writes a whole buffer at the given position of a file.
+ * @return False on an I/O error, errno tells which.
+ */
+static bool writeFully(int fd, const char *data, size_t length, off_t pos)
+{
+    while (length > 0)
+    {
+        ssize_t written = pwrite(fd, data, length, pos);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        length -= static_cast<size_t>(written);
+        pos += written;
+    }
+    return true;
+}
+
+/**
+ * @brief Flushes a file or a directory to stable storage.
+ * @param path The file, or the directory whose entries must survive a power loss.
+ * @throws runtime_error If the path cannot be opened or synced.
+ */
+static void syncPath(const string &path)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0 || fsync(fd) != 0)
+    {
+        int error = errno;
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        throw runtime_error("cannot sync " + path + ": " + strerror(error));
+    }
+    close(fd);
+}
+
+/**
+ * @brief Gets the directory that holds a file.
+ * @return The part of path before the last slash, or "." for a bare file name.
+ */
+static string parentDirectory(const string &path)
+{
+    size_t slash = path.find_last_of('/');
+    if (slash == string::npos)
+    {
+        return ".";
+    }
+    return slash == 0 ? "/" : path.substr(0, slash);
+}
+
+/**
+ * @brief Opens an existing snapshot.
+ * @param basePath The base snapshot, a dense binary graph file. A missing delta log is created empty.
+ * @throws runtime_error If the files cannot be opened.
+ * @throws invalid_argument If the base is not a graph file with weights of type T or the delta log is invalid.
+ */
+template <typename T>
+BasicSnapshot<T>::BasicSnapshot(const string &basePath)
+    : basePath(basePath), deltaPath(basePath + ".delta"), numVertices(0), deltaCount(0), deltaFile(-1)
+{
+    numVertices = GraphIO::mapGraph<T>(basePath).getNumVertices();
+    openDeltaLog(false);
+}
+
+/**
+ * @brief Starts a new snapshot of a graph, replacing any snapshot at the same path.
+ * @param basePath Where to write the base snapshot.
+ * @param initial The graph to write as the base.
+ * @throws runtime_error If the files cannot be written.
+ */
+template <typename T>
+BasicSnapshot<T>::BasicSnapshot(const string &basePath, const BasicGraph<T> &initial)
+    : basePath(basePath), deltaPath(basePath + ".delta"), numVertices(initial.getNumVertices()), deltaCount(0), deltaFile(-1)
+{
+    GraphIO::writeBinary(initial, basePath);
+    syncPath(basePath);
+    syncPath(parentDirectory(basePath));
+    openDeltaLog(true);
+}
+
+template <typename T>
+BasicSnapshot<T>::~BasicSnapshot()
+{
+    if (deltaFile >= 0)
+    {
+        close(deltaFile);
+    }
+}
+
+/**
+ * @brief Opens the delta log, creating it or emptying it if asked, and counts its records.
+ * @param reset Whether to drop every record of an existing log.
+ */
+template <typename T>
+void BasicSnapshot<T>::openDeltaLog(bool reset)
+{
+    if (deltaFile < 0)
+    {
+        deltaFile = open(deltaPath.c_str(), O_RDWR | O_CREAT, 0644);
+        if (deltaFile < 0)
+        {
+            throw runtime_error("cannot open delta log " + deltaPath + ": " + strerror(errno));
+        }
+    }
+    struct stat info;
+    if (fstat(deltaFile, &info) != 0)
+    {
+        throw runtime_error("cannot stat delta log " + deltaPath + ": " + strerror(errno));
+    }
+
+    DeltaFileHeader header;
+    size_t size = static_cast<size_t>(info.st_size);
+    if (reset || size == 0)
+    {
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, DELTA_MAGIC, sizeof(DELTA_MAGIC));
+        header.version = FORMAT_VERSION;
+        header.weightType = WeightCode<T>::value;
+        header.weightSize = sizeof(T);
+        header.recordSize = RECORD_SIZE;
+        if (ftruncate(deltaFile, 0) != 0 || !writeFully(deltaFile, reinterpret_cast<const char *>(&header), sizeof(header), 0))
+        {
+            throw runtime_error("cannot write delta log " + deltaPath + ": " + strerror(errno));
+        }
+        deltaCount = 0;
+        return;
+    }
+
+    if (size < sizeof(header) || pread(deltaFile, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) ||
+        memcmp(header.magic, DELTA_MAGIC, sizeof(DELTA_MAGIC)) != 0 || header.version != FORMAT_VERSION ||
+        header.weightType != WeightCode<T>::value || header.recordSize != RECORD_SIZE)
+    {
+        throw invalid_argument("Invalid delta log: " + deltaPath + " does not belong to this snapshot.");
+    }
+    deltaCount = (size - sizeof(header)) / RECORD_SIZE;
+    size_t whole = sizeof(header) + deltaCount * RECORD_SIZE;
+    if (whole != size && ftruncate(deltaFile, static_cast<off_t>(whole)) != 0)
+    {
+        throw runtime_error("cannot repair delta log " + deltaPath + ": " + strerror(errno));
+    }
+}
+
+/**
+ * @brief Gets the number of vertices in the graph.
+ * @return The number of vertices in the graph.
+ */
+template <typename T>
+size_t BasicSnapshot<T>::getNumVertices() const
+{
+    return numVertices;
+}
+
+/**
+ * @brief Gets the number of changes logged since the base was written.
+ * @return The number of records in the delta log.
+ */
+template <typename T>
+size_t BasicSnapshot<T>::getDeltaCount() const
+{
+    return deltaCount;
+}
+
+/**
+ * @brief Records that an edge changed, by appending one record to the delta log.
+ * @param from The source vertex.
+ * @param to The target vertex.
+ * @param weight The new weight of the edge, 0 removes it.
+ * @throws invalid_argument If a vertex is not in the graph.
+ * @throws runtime_error If the record cannot be written.
+ */
+template <typename T>
+void BasicSnapshot<T>::setEdge(size_t from, size_t to, T weight)
+{
+    if (from >= numVertices || to >= numVertices)
+    {
+        throw invalid_argument("the vertex is not in the graph");
+    }
+    char record[RECORD_SIZE];
+    uint64_t source = from, target = to;
+    memcpy(record, &source, 8);
+    memcpy(record + 8, &target, 8);
+    memcpy(record + 16, &weight, sizeof(T));
+    off_t pos = static_cast<off_t>(sizeof(DeltaFileHeader) + deltaCount * RECORD_SIZE);
+    if (!writeFully(deltaFile, record, RECORD_SIZE, pos))
+    {
+        throw runtime_error("cannot write delta log " + deltaPath + ": " + strerror(errno));
+    }
+    ++deltaCount;
+}
+
+/**
+ * @brief Loads the current graph.
+ * @return The base snapshot with every logged change applied. Without changes this is a read-only view over the
+ * memory-mapped base, otherwise the first change copies the base into memory.
+ * @throws runtime_error If the files cannot be read.
+ * @throws invalid_argument If the base is not a graph file with weights of type T or a record is invalid.
+ */
+template <typename T>
+BasicGraph<T> BasicSnapshot<T>::load() const
+{
+    BasicGraph<T> g = GraphIO::mapGraph<T>(basePath);
+    vector<char> batch(REPLAY_BATCH * RECORD_SIZE);
+    for (size_t first = 0; first < deltaCount; first += REPLAY_BATCH)
+    {
+        size_t count = min(REPLAY_BATCH, deltaCount - first);
+        size_t length = count * RECORD_SIZE;
+        off_t pos = static_cast<off_t>(sizeof(DeltaFileHeader) + first * RECORD_SIZE);
+        if (pread(deltaFile, batch.data(), length, pos) != static_cast<ssize_t>(length))
+        {
+            throw runtime_error("cannot read delta log " + deltaPath);
+        }
+        for (size_t r = 0; r < count; ++r)
+        {
+            const char *record = batch.data() + r * RECORD_SIZE;
+            uint64_t source, target;
+            T weight;
+            memcpy(&source, record, 8);
+            memcpy(&target, record + 8, 8);
+            memcpy(&weight, record + 16, sizeof(T));
+            g.setEdge(static_cast<size_t>(source), static_cast<size_t>(target), weight);
+        }
+    }
+    return g;
+}
+
+/**
+ * @brief Folds the delta log into a new base snapshot and empties the log.
+ * @throws runtime_error If the files cannot be written.
+ * @details The new base is written next to the old one, synced and renamed over it, so the base is always complete.
+ * The directory is synced before the log is emptied, so the rename is on disk before the truncation can be,
+ * and replaying a log that survived onto the new base would change nothing.
+ */
+template <typename T>
+void BasicSnapshot<T>::compact()
+{
+    if (deltaCount == 0)
+    {
+        return;
+    }
+    string temporary = basePath + ".compacting";
+    GraphIO::writeBinary(load(), temporary);
+    syncPath(temporary);
+    if (rename(temporary.c_str(), basePath.c_str()) != 0)
+    {
+        int error = errno;
+        remove(temporary.c_str());
+        throw runtime_error("cannot replace snapshot " + basePath + ": " + strerror(error));
+    }
+    syncPath(parentDirectory(basePath));
+    openDeltaLog(true);
+}
+
+template class ariel::BasicSnapshot<int>;
+template class ariel::BasicSnapshot<int64_t>;
+template class ariel::BasicSnapshot<float>;
+template class ariel::BasicSnapshot<double>;
+template class ariel::BasicSnapshot<uint8_t>;
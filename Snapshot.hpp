@@ -0,0 +1,64 @@
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include <cstdint>
+#include <string>
+#include "Graph.hpp"
+using namespace std;
+
+namespace ariel
+{
+    /**
+     * @brief The header at the start of every delta log, followed by fixed-size records.
+     * @details A record is the uint64 source, the uint64 target and the new weight, 16 + sizeof(T) bytes,
+     * little-endian and unaligned. A record cut short by a crash is dropped when the log is opened.
+     */
+    struct DeltaFileHeader
+    {
+        char magic[8];       // "ARIELDL" followed by a zero byte
+        uint32_t version;    // BasicSnapshot::FORMAT_VERSION
+        uint32_t weightType; // WeightCode<T>::value
+        uint32_t weightSize; // sizeof the weight type
+        uint32_t recordSize; // 16 + sizeof the weight type
+        uint64_t reserved;
+    };
+
+    /**
+     * @brief A checkpointed graph: a binary base snapshot plus a log of the edge changes made since.
+     * @details The base is a dense GraphIO file at basePath and the log lives next to it at basePath + ".delta".
+     * Every setEdge appends one small record to the log instead of rewriting the graph, load maps the base and
+     * replays the log, and compact folds the log into a new base. A record sets an edge to a weight, so replaying
+     * a record twice does nothing more than replaying it once. compact syncs the new base and its directory before
+     * it empties the log, so neither a process crash nor a power loss in the middle of compact loses anything.
+     * setEdge does not sync, so a power loss may lose the newest records, a torn one is dropped when the log is opened.
+     */
+    template <typename T>
+    class BasicSnapshot
+    {
+    private:
+        string basePath;
+        string deltaPath;
+        size_t numVertices;
+        size_t deltaCount;
+        int deltaFile;
+        BasicSnapshot(const BasicSnapshot &);
+        BasicSnapshot &operator=(const BasicSnapshot &);
+        void openDeltaLog(bool reset);
+
+    public:
+        static const uint32_t FORMAT_VERSION = 1;
+        static const size_t RECORD_SIZE = 16 + sizeof(T);
+
+        explicit BasicSnapshot(const string &basePath);
+        BasicSnapshot(const string &basePath, const BasicGraph<T> &initial);
+        ~BasicSnapshot();
+        size_t getNumVertices() const;
+        size_t getDeltaCount() const;
+        void setEdge(size_t from, size_t to, T weight);
+        BasicGraph<T> load() const;
+        void compact();
+    };
+
+    typedef BasicSnapshot<int> Snapshot;
+}
+#endif // SNAPSHOT_HPP
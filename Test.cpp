@@ -1,6 +1,17 @@
 #include "doctest.h"
 #include "Algorithms.hpp"
 #include "Graph.hpp"
+#include "GraphIO.hpp"
+#include "Snapshot.hpp"
+#include "Reorder.hpp"
+#include "Isomorphism.hpp"
+#include "Parallel.hpp"
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <unordered_set>
 
 using namespace std;
 using namespace ariel;
@@ -258,4 +269,1935 @@ TEST_CASE("Invalid operations")
         {1, 0, 0, 1, 0}};
     g6.loadGraph(graph3);
     CHECK_THROWS(g1 + g6);
-}
\ No newline at end of file
+}
+TEST_CASE("All pairs shortest paths")
+{
+    ariel::Graph g1;
+    vector<vector<int>> graph = {
+        {0, 4, 0, 0},
+        {0, 0, -2, 0},
+        {1, 0, 0, 3},
+        {0, 0, 0, 0}};
+    g1.loadGraph(graph);
+    const int inf = numeric_limits<int>::max();
+    vector<vector<int>> expected = {
+        {0, 4, 2, 5},
+        {-1, 0, -2, 1},
+        {1, 5, 0, 3},
+        {inf, inf, inf, 0}};
+    CHECK(Algorithms::allPairsShortestPaths(g1).getAdjacencyMatrix() == expected);
+
+    // A graph spanning several tiles must agree with the textbook triple loop
+    size_t n = 150;
+    vector<vector<int>> big(n, vector<int>(n, 0));
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (size_t j = 0; j < n; ++j)
+        {
+            if (i != j && (i * 7 + j * 13) % 5 == 0)
+            {
+                big[i][j] = static_cast<int>((i * 31 + j * 17) % 20) + 1;
+            }
+        }
+    }
+    vector<vector<int>> naive(n, vector<int>(n, inf));
+    for (size_t i = 0; i < n; ++i)
+    {
+        naive[i][i] = 0;
+        for (size_t j = 0; j < n; ++j)
+        {
+            if (big[i][j])
+            {
+                naive[i][j] = big[i][j];
+            }
+        }
+    }
+    for (size_t k = 0; k < n; ++k)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            for (size_t j = 0; j < n; ++j)
+            {
+                if (naive[i][k] != inf && naive[k][j] != inf && naive[i][k] + naive[k][j] < naive[i][j])
+                {
+                    naive[i][j] = naive[i][k] + naive[k][j];
+                }
+            }
+        }
+    }
+    ariel::Graph g2;
+    g2.loadGraph(big);
+    CHECK(Algorithms::allPairsShortestPaths(g2, 4).getAdjacencyMatrix() == naive);
+    CHECK(Algorithms::allPairsShortestPaths(g2, 1).getAdjacencyMatrix() == naive);
+
+    ariel::Graph g3;
+    vector<vector<int>> negative = {
+        {0, 1, 0},
+        {0, 0, -3},
+        {1, 0, 0}};
+    g3.loadGraph(negative);
+    CHECK_THROWS(Algorithms::allPairsShortestPaths(g3));
+}
+
+TEST_CASE("Parallel loops")
+{
+    vector<int> visits(100, 0);
+    ariel::parallelFor(0, visits.size(), [&](size_t i)
+                       { visits[i]++; },
+                       4);
+    CHECK(visits == vector<int>(100, 1));
+
+    // Exceptions from a spawned worker or from the calling thread reach the caller after every thread joined
+    for (size_t failing : {0, 70, 99})
+    {
+        atomic<size_t> done(0);
+        CHECK_THROWS_AS(ariel::parallelFor(0, 100, [&](size_t i)
+                                           {
+                                               if (i == failing)
+                                               {
+                                                   throw runtime_error("failed");
+                                               }
+                                               done++;
+                                           },
+                                           4),
+                        runtime_error);
+        CHECK(done.load() >= 75);
+    }
+}
+
+TEST_CASE("Semiring products")
+{
+    const int inf = numeric_limits<int>::max();
+    ariel::Graph weights;
+    vector<vector<int>> weightMatrix = {
+        {0, 3, inf, 7},
+        {8, 0, 2, inf},
+        {5, inf, 0, 1},
+        {2, inf, inf, 0}};
+    weights.loadGraph(weightMatrix);
+
+    // Shortest paths by repeated squaring agree with Floyd-Warshall
+    ariel::Graph adjacency;
+    vector<vector<int>> adjacencyMatrix = {
+        {0, 3, 0, 7},
+        {8, 0, 2, 0},
+        {5, 0, 0, 1},
+        {2, 0, 0, 0}};
+    adjacency.loadGraph(adjacencyMatrix);
+    ariel::Graph squared = weights.product<MinPlus>(weights);
+    squared = squared.product<MinPlus>(squared);
+    CHECK(squared.getAdjacencyMatrix() == Algorithms::allPairsShortestPaths(adjacency).getAdjacencyMatrix());
+    CHECK(adjacency.distanceMatrix() == weights);
+    ariel::Graph fromAdjacency = adjacency.distanceMatrix();
+    fromAdjacency = fromAdjacency.product<MinPlus>(fromAdjacency);
+    CHECK(fromAdjacency.product<MinPlus>(fromAdjacency) == Algorithms::allPairsShortestPaths(adjacency));
+
+    // Widest paths: the best bottleneck from 0 to 2 goes through 1
+    ariel::Graph capacities;
+    vector<vector<int>> capacityMatrix = {
+        {inf, 5, 1, 0},
+        {0, inf, 4, 0},
+        {0, 0, inf, 9},
+        {0, 0, 0, inf}};
+    capacities.loadGraph(capacityMatrix);
+    ariel::Graph widest = capacities.product<MaxMin>(capacities).product<MaxMin>(capacities);
+    CHECK(widest.getAdjacencyMatrix()[0][2] == 4);
+    CHECK(widest.getAdjacencyMatrix()[0][3] == 4);
+
+    // Reachability in two steps
+    ariel::Graph path;
+    vector<vector<int>> pathMatrix = {
+        {0, 3, 0},
+        {0, 0, 7},
+        {0, 0, 0}};
+    path.loadGraph(pathMatrix);
+    vector<vector<int>> twoSteps = {
+        {0, 0, 1},
+        {0, 0, 0},
+        {0, 0, 0}};
+    CHECK(path.product<BooleanSemiring>(path).getAdjacencyMatrix() == twoSteps);
+    CHECK(path.product<PlusTimes>(path) == path * path);
+    CHECK_THROWS(path.product<MinPlus>(weights));
+
+    // Paths too long for the weight type saturate to "no path"
+    ariel::BasicGraph<uint8_t> bytes(3);
+    bytes.setEdge(0, 1, 200);
+    bytes.setEdge(1, 2, 100);
+    bytes.setEdge(0, 2, 255);
+    CHECK(bytes.product<MinPlus>(bytes).getEdge(0, 2) == 255);
+    ariel::BasicGraph<int> ints(2);
+    ints.setEdge(0, 1, inf - 1);
+    ints.setEdge(1, 0, inf - 1);
+    ints.setEdge(0, 0, inf);
+    ints.setEdge(1, 1, inf);
+    CHECK(ints.product<MinPlus>(ints).getEdge(0, 0) == inf);
+
+    // Several row and column blocks
+    size_t n = 70;
+    vector<vector<int>> big(n, vector<int>(n, 0));
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (size_t j = 0; j < n; ++j)
+        {
+            big[i][j] = static_cast<int>((i * 5 + j * 3) % 7) - 3;
+        }
+    }
+    vector<vector<int>> expected(n, vector<int>(n, 0));
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (size_t j = 0; j < n; ++j)
+        {
+            for (size_t k = 0; k < n; ++k)
+            {
+                expected[i][j] += big[i][k] * big[k][j];
+            }
+        }
+    }
+    ariel::Graph g;
+    g.loadGraph(big);
+    CHECK(g.product<PlusTimes>(g, PlusTimes(), 3).getAdjacencyMatrix() == expected);
+}
+
+TEST_CASE("Johnson all pairs shortest paths")
+{
+    ariel::Graph g1;
+    vector<vector<int>> graph = {
+        {0, 4, 0, 0, 0},
+        {0, 0, -2, 0, 5},
+        {1, 0, 0, 3, 0},
+        {0, 0, 0, 0, -1},
+        {0, 0, 0, 0, 0}};
+    g1.loadGraph(graph);
+    CHECK(Algorithms::johnsonShortestPaths(g1) == Algorithms::allPairsShortestPaths(g1));
+
+    // Streaming keeps the rows in order even with a tiny in-flight window
+    ariel::Graph distances = Algorithms::allPairsShortestPaths(g1);
+    const vector<vector<int>> &expected = distances.getAdjacencyMatrix();
+    size_t nextRow = 0;
+    bool rowsMatch = true;
+    Algorithms::johnsonShortestPaths(CSRGraph(g1), [&](size_t source, const vector<int> &row)
+                                     {
+                                         rowsMatch = rowsMatch && source == nextRow && row == expected[source];
+                                         ++nextRow;
+                                     },
+                                     2, 3);
+    CHECK(rowsMatch);
+    CHECK(nextRow == 5);
+
+    // More workers than ring slots on a bigger graph, and a sink that throws stops the workers
+    ariel::Graph ring(200);
+    for (size_t u = 0; u < 200; ++u)
+    {
+        ring.setEdge(u, (u + 1) % 200, 1 + static_cast<int>(u % 7));
+        ring.setEdge(u, (u * 37 + 11) % 200, 20);
+    }
+    ariel::Graph ringDistances = Algorithms::allPairsShortestPaths(ring);
+    nextRow = 0;
+    rowsMatch = true;
+    Algorithms::johnsonShortestPaths(CSRGraph(ring), [&](size_t source, const vector<int> &row)
+                                     {
+                                         rowsMatch = rowsMatch && source == nextRow && row == ringDistances.getAdjacencyMatrix()[source];
+                                         ++nextRow;
+                                     },
+                                     3, 8);
+    CHECK(rowsMatch);
+    CHECK(nextRow == 200);
+    nextRow = 0;
+    CHECK_THROWS_AS(Algorithms::johnsonShortestPaths(CSRGraph(ring), [&](size_t source, const vector<int> &)
+                                                     {
+                                                         if (source == 50)
+                                                         {
+                                                             throw runtime_error("sink failed");
+                                                         }
+                                                         ++nextRow;
+                                                     },
+                                                     4, 4),
+                    runtime_error);
+    CHECK(nextRow == 50);
+
+    ariel::Graph g2;
+    vector<vector<int>> negative = {
+        {0, 1, 0},
+        {0, 0, -3},
+        {1, 0, 0}};
+    g2.loadGraph(negative);
+    CHECK_THROWS(Algorithms::johnsonShortestPaths(g2));
+}
+
+TEST_CASE("Graph power")
+{
+    ariel::Graph g1;
+    vector<vector<int>> graph = {
+        {0, 1, 0},
+        {1, 0, 1},
+        {0, 1, 0}};
+    g1.loadGraph(graph);
+    vector<vector<int>> identity = {
+        {1, 0, 0},
+        {0, 1, 0},
+        {0, 0, 1}};
+    CHECK(g1.pow(0).getAdjacencyMatrix() == identity);
+    CHECK(g1.pow(1) == g1);
+    CHECK(g1.pow(5) == g1 * g1 * g1 * g1 * g1);
+
+    // Fibonacci numbers through the matrix [[1, 1], [1, 0]], F(90) would overflow int without the modulus
+    ariel::Graph fib;
+    vector<vector<int>> fibMatrix = {
+        {1, 1},
+        {1, 0}};
+    fib.loadGraph(fibMatrix);
+    long long a = 0, b = 1;
+    const long long mod = 1000000007;
+    for (int i = 0; i < 90; ++i)
+    {
+        long long next = (a + b) % mod;
+        a = b;
+        b = next;
+    }
+    CHECK(fib.pow(90, 1000000007).getAdjacencyMatrix()[0][1] == a);
+    CHECK(fib.pow(10, 7).getAdjacencyMatrix()[0][1] == 55 % 7);
+    CHECK(g1.pow(3, 1) == ariel::Graph(3));
+    CHECK_THROWS(g1.pow(3, 0));
+}
+
+TEST_CASE("Arithmetic policies")
+{
+    const int big = numeric_limits<int>::max();
+    const int small = numeric_limits<int>::min();
+    ariel::Graph g1;
+    vector<vector<int>> graph = {
+        {0, big},
+        {small, 5}};
+    g1.loadGraph(graph);
+    ariel::Graph ones;
+    vector<vector<int>> onesMatrix = {
+        {1, 1},
+        {1, 1}};
+    ones.loadGraph(onesMatrix);
+
+    vector<vector<int>> wrapped = {
+        {1, small},
+        {small + 1, 6}};
+    vector<vector<int>> saturated = {
+        {1, big},
+        {small + 1, 6}};
+    CHECK(g1.add<Wrapping>(ones).getAdjacencyMatrix() == wrapped);
+    CHECK((g1 + ones).getAdjacencyMatrix() == wrapped);
+    ariel::Graph sum = g1;
+    sum += ones;
+    CHECK(sum.getAdjacencyMatrix() == wrapped);
+    sum -= ones;
+    CHECK(sum == g1);
+    CHECK((sum - ones).getAdjacencyMatrix()[1][0] == big);
+    CHECK((sum * 2).getAdjacencyMatrix()[0][1] == -2);
+    sum = g1;
+    CHECK((-sum).getAdjacencyMatrix()[1][0] == small);
+    CHECK(g1.add<Saturating>(ones).getAdjacencyMatrix() == saturated);
+    CHECK_THROWS_AS(g1.add<Checked>(ones), overflow_error);
+    CHECK_THROWS_AS(g1.add<Widened>(ones), overflow_error);
+
+    // Checked in-place operations leave the graph untouched when they throw
+    ariel::Graph g2 = g1;
+    CHECK_THROWS_AS(g2.increment<Checked>(), overflow_error);
+    CHECK(g2 == g1);
+    CHECK_THROWS_AS(g2.scale<Checked>(2), overflow_error);
+    CHECK(g2 == g1);
+    g2.scale<Saturating>(2);
+    CHECK(g2.getAdjacencyMatrix()[0][1] == big);
+    CHECK(g2.getAdjacencyMatrix()[1][0] == small);
+    CHECK(g2.getAdjacencyMatrix()[1][1] == 10);
+
+    // A partial sum leaves the int range but the entry comes back into it
+    ariel::Graph left, right;
+    vector<vector<int>> leftMatrix = {
+        {big, big, -big},
+        {0, 0, 0},
+        {0, 0, 0}};
+    vector<vector<int>> rightMatrix = {
+        {1, 0, 0},
+        {1, 0, 0},
+        {1, 0, 0}};
+    left.loadGraph(leftMatrix);
+    right.loadGraph(rightMatrix);
+    CHECK_THROWS_AS(left.multiply<Checked>(right), overflow_error);
+    CHECK(left.multiply<Widened>(right).getAdjacencyMatrix()[0][0] == big);
+    CHECK(left.multiply<Saturating>(right).getAdjacencyMatrix()[0][0] == 0);
+    CHECK(left.multiply<Wrapping>(right) == left * right);
+    CHECK_THROWS_AS(ones.multiply<Checked>(left), invalid_argument);
+}
+
+TEST_CASE("Templated weight types")
+{
+    // Floating point weights divide exactly and keep fractional shortest distances
+    ariel::BasicGraph<double> g1;
+    vector<vector<double>> graph = {
+        {0, 1.5, 0},
+        {0, 0, 2.25},
+        {0.5, 0, 0}};
+    g1.loadGraph(graph);
+    g1 / 2;
+    CHECK(g1.getEdge(0, 1) == 0.75);
+    CHECK(g1.getEdge(1, 2) == 1.125);
+
+    ariel::BasicGraph<float> g2;
+    vector<vector<float>> floatGraph = {
+        {0, 1.5f, 4},
+        {0, 0, 0.25f},
+        {0, 0, 0}};
+    g2.loadGraph(floatGraph);
+    ariel::BasicGraph<float> floatDistances = Algorithms::allPairsShortestPaths(g2);
+    CHECK(floatDistances.getEdge(0, 2) == 1.75f);
+    CHECK(floatDistances.getEdge(2, 0) == numeric_limits<float>::max());
+    CHECK(Algorithms::johnsonShortestPaths(g2) == floatDistances);
+    CHECK(Algorithms::isConnected(g2) == true);
+
+    // uint8_t weights print as numbers and their distances may not exceed 255
+    ariel::BasicGraph<uint8_t> g3;
+    vector<vector<uint8_t>> byteGraph = {
+        {0, 200, 0},
+        {200, 0, 100},
+        {0, 100, 0}};
+    g3.loadGraph(byteGraph);
+    ostringstream out;
+    out << g3;
+    CHECK(out.str() == "[0, 200, 0], [200, 0, 100], [0, 100, 0]");
+    CHECK(Algorithms::isBipartite(g3) == "The graph is bipartite: A={0, 2}, B={1}");
+    CHECK_THROWS_AS(Algorithms::allPairsShortestPaths(g3), overflow_error);
+    CHECK_THROWS_AS(Algorithms::johnsonShortestPaths(g3), overflow_error);
+    CHECK_THROWS_AS(g3.scale<Checked>(2), overflow_error);
+
+    // Distances beyond half the int range are exact, and too long ones throw rather than read as "no path"
+    ariel::Graph heavy(3);
+    heavy.setEdge(0, 1, 1500000000);
+    heavy.setEdge(1, 2, 600000000);
+    ariel::Graph heavyDistances = Algorithms::allPairsShortestPaths(heavy);
+    CHECK(heavyDistances.getEdge(0, 1) == 1500000000);
+    CHECK(heavyDistances.getEdge(1, 2) == 600000000);
+    CHECK(heavyDistances.getEdge(2, 0) == numeric_limits<int>::max());
+    heavy.setEdge(1, 2, 700000000);
+    CHECK_THROWS_AS(Algorithms::allPairsShortestPaths(heavy), overflow_error);
+    ariel::BasicGraph<int64_t> huge(3);
+    huge.setEdge(0, 1, int64_t(1) << 61);
+    CHECK_THROWS_AS(Algorithms::allPairsShortestPaths(huge), overflow_error);
+
+    // int64_t weights hold walk counts beyond the int range
+    ariel::BasicGraph<int64_t> g4;
+    vector<vector<int64_t>> longGraph = {
+        {1, 1},
+        {1, 1}};
+    g4.loadGraph(longGraph);
+    CHECK(g4.pow(40).getEdge(0, 0) == (int64_t(1) << 39));
+    CHECK(Algorithms::negativeCycle(g4) == "The graph does not contain a negative cycle.");
+}
+
+TEST_CASE("Binary graph files")
+{
+    const string densePath = "test_graph_dense.bin";
+    const string csrPath = "test_graph_csr.bin";
+    ariel::Graph g1;
+    vector<vector<int>> graph = {
+        {0, 1, 0, 0},
+        {1, 0, -3, 0},
+        {0, 0, 0, 7},
+        {2, 0, 0, 0}};
+    g1.loadGraph(graph);
+
+    // A dense file opens as a view over the mapping that behaves like the original graph
+    GraphIO::writeBinary(g1, densePath);
+    ariel::Graph mapped = GraphIO::mapGraph<int>(densePath);
+    CHECK(mapped.isView());
+    CHECK(mapped == g1);
+    CHECK(mapped.getAdjacencyMatrix() == graph);
+    CHECK(Algorithms::isConnected(mapped) == true);
+    CHECK(Algorithms::allPairsShortestPaths(mapped) == Algorithms::allPairsShortestPaths(g1));
+
+    // Modifying a view copies it first, the file is never written
+    ariel::Graph copy = mapped;
+    copy += g1;
+    CHECK_FALSE(copy.isView());
+    CHECK(copy.getEdge(2, 3) == 14);
+    CHECK(mapped.isView());
+    CHECK(mapped.getEdge(2, 3) == 7);
+    CHECK(GraphIO::mapGraph<int>(densePath) == g1);
+
+    // CSR files round trip and either layout loads in either form
+    ariel::BasicGraph<double> g2;
+    vector<vector<double>> weighted = {
+        {0, 0.5, 0},
+        {0, 0, 0},
+        {2.5, 0, 0}};
+    g2.loadGraph(weighted);
+    GraphIO::writeBinary(BasicCSRGraph<double>(g2), csrPath);
+    BasicCSRGraph<double> csr = GraphIO::loadCSR<double>(csrPath);
+    CHECK(csr.getNumEdges() == 2);
+    CHECK(csr.toGraph() == g2);
+    CHECK(GraphIO::mapGraph<double>(csrPath) == g2);
+    CHECK(GraphIO::loadCSR<int>(densePath).getNumEdges() == 5);
+
+    // Wrong weight types, foreign files and missing files are rejected
+    CHECK_THROWS_AS(GraphIO::mapGraph<float>(densePath), invalid_argument);
+    CHECK_THROWS_AS(GraphIO::mapGraph<int>("Test.cpp"), invalid_argument);
+    CHECK_THROWS_AS(GraphIO::mapGraph<int>("no_such_graph.bin"), runtime_error);
+
+    remove(densePath.c_str());
+    remove(csrPath.c_str());
+}
+
+TEST_CASE("Streaming edge list loader")
+{
+    const string path = "test_edges.txt";
+    {
+        ofstream out(path.c_str(), ios::binary);
+        out << "# a comment\n"
+            << "0 1 5\n"
+            << "1 2 -3\r\n"
+            << "\n"
+            << "% another comment\n"
+            << "  2\t0   7  \n"
+            << "0 2\n"
+            << "3 1 0\n"
+            << "1 0 12"; // no newline at the end of the file
+    }
+    ariel::Graph expected;
+    vector<vector<int>> graph = {
+        {0, 5, 1, 0},
+        {12, 0, -3, 0},
+        {7, 0, 0, 0},
+        {0, 0, 0, 0}};
+    expected.loadGraph(graph);
+
+    // Tiny chunks force lines to be split across reads
+    for (size_t chunk : {size_t(1), size_t(7), size_t(1 << 20)})
+    {
+        CSRGraph csr = GraphIO::loadEdgeList<int>(path, chunk);
+        CHECK(csr.getNumVertices() == 4);
+        CHECK(csr.getNumEdges() == 5);
+        CHECK(csr.toGraph() == expected);
+    }
+    CHECK(GraphIO::loadEdgeList<double>(path).toGraph().getEdge(1, 2) == -3.0);
+    CHECK_THROWS_AS(GraphIO::loadEdgeList<uint8_t>(path), invalid_argument);
+
+    {
+        ofstream out(path.c_str(), ios::binary);
+        out << "0 1 2\n"
+            << "1 x 2\n";
+    }
+    CHECK_THROWS_AS(GraphIO::loadEdgeList<int>(path), invalid_argument);
+
+    // Floating point weights must be finite, fit the weight type and fit the token buffer
+    for (const string &weight : {string("1e39"), string("1e400"), string("inf"), string("nan"), "0." + string(70, '1')})
+    {
+        {
+            ofstream out(path.c_str(), ios::binary);
+            out << "0 1 " << weight << "\n";
+        }
+        CHECK_THROWS_AS(GraphIO::loadEdgeList<float>(path), invalid_argument);
+    }
+    {
+        ofstream out(path.c_str(), ios::binary);
+        out << "0 1 1e39\n";
+    }
+    CHECK(GraphIO::loadEdgeList<double>(path).toGraph().getEdge(0, 1) == 1e39);
+    CHECK_THROWS_AS(GraphIO::loadEdgeList<int>("no_such_edges.txt"), runtime_error);
+    remove(path.c_str());
+}
+
+TEST_CASE("Parallel text matrix parser")
+{
+    ariel::Graph g1;
+    vector<vector<int>> graph = {
+        {0, 1, -20},
+        {1, 0, 300},
+        {0, 1, 0}};
+    g1.loadGraph(graph);
+    ostringstream printed;
+    printed << g1;
+    string bracketed = printed.str();
+
+    // The operator<< format reads back to the same graph, on any number of threads
+    for (size_t threads : {size_t(1), size_t(4)})
+    {
+        CHECK(GraphIO::parseMatrix<int>(bracketed.data(), bracketed.size(), threads) == g1);
+    }
+    string multiline = "[0, 1, -20],\n[1, 0, 300],\n[0, 1, 0]\n";
+    CHECK(GraphIO::parseMatrix<int>(multiline.data(), multiline.size()) == g1);
+    string plain = "0 1 -20\n1\t0 300\r\n\n0 1 0";
+    CHECK(GraphIO::parseMatrix<int>(plain.data(), plain.size()) == g1);
+    string fractions = "0.5 1e2\n-2.25 0\n";
+    ariel::BasicGraph<double> g2 = GraphIO::parseMatrix<double>(fractions.data(), fractions.size());
+    CHECK(g2.getEdge(0, 1) == 100.0);
+    CHECK(g2.getEdge(1, 0) == -2.25);
+    CHECK(GraphIO::parseMatrix<int>("", 0).getNumVertices() == 0);
+
+    // A large matrix is cut into many chunks that must line up exactly
+    size_t n = 300;
+    vector<vector<int>> big(n, vector<int>(n));
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (size_t j = 0; j < n; ++j)
+        {
+            big[i][j] = static_cast<int>((i * 7919 + j * 104729) % 2001) - 1000;
+        }
+    }
+    ariel::Graph g3;
+    g3.loadGraph(big);
+    ostringstream bigText;
+    bigText << g3;
+    CHECK(GraphIO::parseMatrix<int>(bigText.str().data(), bigText.str().size(), 8) == g3);
+
+    const string path = "test_matrix.txt";
+    {
+        ofstream out(path.c_str(), ios::binary);
+        out << g3;
+    }
+    CHECK(GraphIO::readMatrix<int>(path, 3) == g3);
+    remove(path.c_str());
+
+    // Ragged matrices, bad characters and out of range entries are rejected
+    string ragged = "[0, 1], [1, 0, 1]";
+    CHECK_THROWS_AS(GraphIO::parseMatrix<int>(ragged.data(), ragged.size()), invalid_argument);
+    // Rows of the wrong lengths are rejected even when the entries add up to a square
+    string unevenRows = "[0, 1, 2], [0], [3, 0, 0, 0, 0]";
+    CHECK_THROWS_AS(GraphIO::parseMatrix<int>(unevenRows.data(), unevenRows.size()), invalid_argument);
+    string unevenLines = "0 1 2\n0\n3 0 0 0 0\n";
+    CHECK_THROWS_AS(GraphIO::parseMatrix<int>(unevenLines.data(), unevenLines.size()), invalid_argument);
+    string outside = "[0, 1] 2, [3]";
+    CHECK_THROWS_AS(GraphIO::parseMatrix<int>(outside.data(), outside.size()), invalid_argument);
+    string crlf = "\r\n0 1\r\n\r\n1 0";
+    CHECK(GraphIO::parseMatrix<int>(crlf.data(), crlf.size()).getNumEdges() == 2);
+    string letters = "0 1\n1 x";
+    CHECK_THROWS_AS(GraphIO::parseMatrix<int>(letters.data(), letters.size()), invalid_argument);
+    string wide = "0 256\n1 0";
+    CHECK_THROWS_AS(GraphIO::parseMatrix<uint8_t>(wide.data(), wide.size()), invalid_argument);
+    CHECK_THROWS_AS(GraphIO::parseMatrix<int>(fractions.data(), fractions.size()), invalid_argument);
+}
+
+TEST_CASE("Fast matrix serializer")
+{
+    // Extreme values, negatives and multi-row blocks must match operator<< byte for byte
+    size_t n = 70;
+    vector<vector<int64_t>> matrix(n, vector<int64_t>(n));
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (size_t j = 0; j < n; ++j)
+        {
+            matrix[i][j] = static_cast<int64_t>((i * 7919 + j * 104729) % 20001) - 10000;
+        }
+    }
+    matrix[0][0] = numeric_limits<int64_t>::min();
+    matrix[0][1] = numeric_limits<int64_t>::max();
+    matrix[1][1] = 0;
+    ariel::BasicGraph<int64_t> g1;
+    g1.loadGraph(matrix);
+    ostringstream expected, fast;
+    expected << g1;
+    GraphIO::writeMatrix(g1, fast, 3);
+    CHECK(fast.str() == expected.str());
+
+    ariel::BasicGraph<double> g2;
+    vector<vector<double>> fractions = {
+        {0, 0.1, -2.5},
+        {1e-7, 123456789.0, 1.0 / 3},
+        {-0.0, 100, 1e300}};
+    g2.loadGraph(fractions);
+    ostringstream expectedDouble, fastDouble;
+    expectedDouble << g2;
+    GraphIO::writeMatrix(g2, fastDouble);
+    CHECK(fastDouble.str() == expectedDouble.str());
+
+    ariel::BasicGraph<uint8_t> g3;
+    vector<vector<uint8_t>> bytes = {{0, 255}, {7, 10}};
+    g3.loadGraph(bytes);
+    ostringstream fastBytes;
+    GraphIO::writeMatrix(g3, fastBytes);
+    CHECK(fastBytes.str() == "[0, 255], [7, 10]");
+
+    ostringstream empty;
+    GraphIO::writeMatrix(ariel::Graph(), empty);
+    CHECK(empty.str() == "");
+
+    // The file writer round trips through the parser
+    const string path = "test_written_matrix.txt";
+    GraphIO::writeMatrix(g1, path, 2);
+    CHECK(GraphIO::readMatrix<int64_t>(path) == g1);
+    remove(path.c_str());
+    CHECK_THROWS_AS(GraphIO::writeMatrix(g1, "no_such_directory/matrix.txt"), runtime_error);
+}
+
+TEST_CASE("Compressed graph storage")
+{
+    ariel::Graph g1;
+    vector<vector<int>> graph = {
+        {0, 1, 0, 0, 0},
+        {1, 0, 1, 0, 0},
+        {0, 1, 0, 0, 0},
+        {0, 0, 0, 0, 1},
+        {0, 0, 0, 1, 0}};
+    g1.loadGraph(graph);
+    CompressedGraph c1(g1);
+    CHECK(c1.getNumVertices() == 5);
+    CHECK(c1.getNumEdges() == 6);
+    CHECK(c1.hasEdge(1, 2));
+    CHECK_FALSE(c1.hasEdge(2, 3));
+    CHECK(Algorithms::isConnected(c1) == Algorithms::isConnected(g1));
+    CHECK(Algorithms::shortestPath(c1, 0, 2) == Algorithms::shortestPath(g1, 0, 2));
+    CHECK(Algorithms::shortestPath(c1, 0, 4) == "-1");
+    CHECK(c1.toCSR().toGraph() == g1);
+
+    // Large gaps need several varint bytes and long lists span several blocks
+    size_t n = 1000;
+    vector<size_t> offsets(n + 1, 0), targets;
+    vector<int> weights;
+    for (size_t u = 0; u < n; ++u)
+    {
+        for (size_t v = (u * 37) % 11; v < n; v += 3 + u % 5)
+        {
+            targets.push_back(v);
+            weights.push_back(static_cast<int>(u + v) + 1);
+        }
+        offsets[u + 1] = targets.size();
+    }
+    CSRGraph csr(offsets, targets, weights);
+    CompressedGraph c2(csr);
+    CHECK(c2.getNumEdges() == csr.getNumEdges());
+    CHECK(c2.compressedBytes() < csr.getNumEdges() * sizeof(size_t) / 2);
+    bool matches = true;
+    for (size_t u = 0; u < n; ++u)
+    {
+        size_t e = offsets[u];
+        for (const CompressedGraph::Edge &edge : c2.neighbors(u))
+        {
+            matches = matches && e < offsets[u + 1] && edge.target == targets[e] && edge.weight == weights[e];
+            ++e;
+        }
+        matches = matches && e == offsets[u + 1];
+    }
+    CHECK(matches);
+    CHECK(c2.hasEdge(999, targets[offsets[999] + 3]) == true);
+    CHECK(c2.hasEdge(999, targets[offsets[999] + 3] + 1) == false);
+    CHECK(c2.hasEdge(5, 1) == false);
+    CHECK(c2.toCSR().toGraph() == csr.toGraph());
+    CHECK(Algorithms::isConnected(c2) == Algorithms::isConnected(csr.toGraph()));
+
+    vector<size_t> parallelOffsets = {0, 2, 2};
+    vector<size_t> parallelTargets = {1, 1};
+    vector<int> parallelWeights = {1, 2};
+    CHECK_THROWS_AS(CompressedGraph(CSRGraph(parallelOffsets, parallelTargets, parallelWeights)), invalid_argument);
+
+    // A parallel edge that lands on the first edge of a block
+    const size_t block = CompressedGraph::BLOCK_SIZE;
+    vector<size_t> blockOffsets(block + 8, block + 7);
+    blockOffsets[0] = 0;
+    vector<size_t> blockTargets;
+    for (size_t v = 0; v < block + 6; ++v)
+    {
+        blockTargets.push_back(v);
+    }
+    blockTargets.insert(blockTargets.begin() + block, block - 1);
+    vector<int> blockWeights(blockTargets.size(), 1);
+    CHECK_THROWS_AS(CompressedGraph(CSRGraph(blockOffsets, blockTargets, blockWeights)), invalid_argument);
+}
+
+TEST_CASE("Snapshots with delta logs")
+{
+    const string path = "test_snapshot.bin";
+    ariel::Graph g1;
+    vector<vector<int>> graph = {
+        {0, 1, 0},
+        {1, 0, 1},
+        {0, 1, 0}};
+    g1.loadGraph(graph);
+    ariel::Graph expected = g1;
+    {
+        Snapshot snapshot(path, g1);
+        CHECK(snapshot.getDeltaCount() == 0);
+        CHECK(snapshot.load().isView());
+        snapshot.setEdge(0, 2, 5);
+        snapshot.setEdge(1, 0, 0);
+        snapshot.setEdge(0, 2, 7);
+        expected.setEdge(0, 2, 7);
+        expected.setEdge(1, 0, 0);
+        CHECK(snapshot.getDeltaCount() == 3);
+        CHECK(snapshot.load() == expected);
+        CHECK_THROWS_AS(snapshot.setEdge(3, 0, 1), invalid_argument);
+    }
+
+    // Reopening replays the log, a record torn by a crash is dropped
+    {
+        FILE *log = fopen((path + ".delta").c_str(), "ab");
+        fputs("torn", log);
+        fclose(log);
+    }
+    {
+        Snapshot snapshot(path);
+        CHECK(snapshot.getDeltaCount() == 3);
+        CHECK(snapshot.load() == expected);
+        snapshot.compact();
+        CHECK(snapshot.getDeltaCount() == 0);
+        CHECK(snapshot.load().isView());
+        CHECK(snapshot.load() == expected);
+        snapshot.setEdge(2, 2, -4);
+    }
+    expected.setEdge(2, 2, -4);
+    CHECK(Snapshot(path).load() == expected);
+    CHECK(GraphIO::mapGraph<int>(path) != expected); // the base only changes on compaction
+    CHECK_THROWS_AS(BasicSnapshot<double>{path}, invalid_argument);
+    CHECK_THROWS_AS(g1.setEdge(0, 3, 1), invalid_argument);
+
+    remove(path.c_str());
+    remove((path + ".delta").c_str());
+}
+
+TEST_CASE("Vertex reordering")
+{
+    // A path 0 - 1 - ... - 9 with shuffled labels
+    const size_t n = 10;
+    vector<size_t> label = {7, 2, 9, 0, 5, 3, 8, 1, 6, 4};
+    vector<vector<int>> rows(n, vector<int>(n, 0));
+    for (size_t i = 0; i + 1 < n; ++i)
+    {
+        rows[label[i]][label[i + 1]] = static_cast<int>(i + 1);
+        rows[label[i + 1]][label[i]] = static_cast<int>(i + 1);
+    }
+    ariel::Graph g;
+    g.loadGraph(rows);
+    CSRGraph csr(g);
+
+    vector<Permutation> orders = {Reorder::bfsOrder(csr), Reorder::reverseCuthillMcKee(csr),
+                                  Reorder::degreeSort(csr), Reorder::gorder(csr)};
+    for (const Permutation &p : orders)
+    {
+        CHECK(p.size() == n);
+        for (size_t v = 0; v < n; ++v)
+        {
+            CHECK(p.oldId[p.newId[v]] == v);
+        }
+        CSRGraph reordered = Reorder::permute(csr, p);
+        CHECK(reordered.getNumEdges() == csr.getNumEdges());
+        CHECK(reordered.toGraph() == Reorder::permute(g, p));
+        CHECK(Reorder::toOriginal(Reorder::permute(g, p), p) == g);
+    }
+
+    // Reverse Cuthill-McKee recovers the path, every edge joins consecutive labels
+    CSRGraph rcm = Reorder::permute(csr, orders[1]);
+    for (size_t v = 0; v < n; ++v)
+    {
+        for (size_t e = rcm.getOffsets()[v]; e < rcm.getOffsets()[v + 1]; ++e)
+        {
+            size_t u = rcm.getTargets()[e];
+            CHECK((u + 1 == v || v + 1 == u));
+        }
+    }
+
+    // Results of the reordered graph map back to the original vertices
+    ariel::Graph distances = Algorithms::allPairsShortestPaths(g);
+    ariel::Graph reorderedDistances = Algorithms::allPairsShortestPaths(Reorder::permute(g, orders[3]));
+    CHECK(Reorder::toOriginal(reorderedDistances, orders[3]) == distances);
+    vector<size_t> degrees(n);
+    for (size_t v = 0; v < n; ++v)
+    {
+        degrees[v] = rcm.degree(v);
+    }
+    vector<size_t> original = orders[1].toOriginal(degrees);
+    for (size_t v = 0; v < n; ++v)
+    {
+        CHECK(original[v] == csr.degree(v));
+    }
+
+    // Hubs come first in degree order
+    vector<vector<int>> star = {
+        {0, 0, 0, 0},
+        {0, 0, 0, 0},
+        {1, 1, 0, 1},
+        {0, 0, 0, 0}};
+    ariel::Graph s;
+    s.loadGraph(star);
+    CHECK(Reorder::degreeSort(CSRGraph(s)).oldId[0] == 2);
+    CHECK_THROWS_AS(Permutation(vector<size_t>{0, 0}), invalid_argument);
+    CHECK_THROWS_AS(Reorder::permute(s, orders[0]), invalid_argument);
+}
+
+TEST_CASE("Graph fingerprints")
+{
+    ariel::Graph g1, g2, g3;
+    vector<vector<int>> graph = {
+        {0, 1, 0},
+        {1, 0, 1},
+        {0, 1, 0}};
+    g1.loadGraph(graph);
+    g2.loadGraph(graph);
+    CHECK(g1.fingerprint() == g2.fingerprint());
+    CHECK(g1 == g2);
+
+    // setEdge keeps the fingerprint of a fresh computation
+    g2.setEdge(0, 2, 4);
+    CHECK(g1 != g2);
+    ariel::Graph g2copy;
+    g2copy.loadGraph(g2.getAdjacencyMatrix());
+    CHECK(g2.fingerprint() == g2copy.fingerprint());
+    g2.setEdge(0, 2, 0);
+    CHECK(g1.fingerprint() == g2.fingerprint());
+    CHECK(g1 == g2);
+
+    // Bulk operators drop the cache
+    g2 += g1;
+    CHECK(g2 != g1);
+    g2 -= g1;
+    CHECK(g2 == g1);
+    ++g2;
+    g3.loadGraph(g2.getAdjacencyMatrix());
+    CHECK(g2.fingerprint() == g3.fingerprint());
+
+    // Graphs of different sizes are simply unequal
+    ariel::Graph g4(2);
+    CHECK(g4 != g1);
+    CHECK_FALSE(g4 == g1);
+    CHECK(ariel::Graph(2) == ariel::Graph(2));
+
+    // Floating point weights compare by value
+    BasicGraph<double> d1(2), d2(2);
+    d1.setEdge(0, 1, 0.0);
+    d2.setEdge(0, 1, -0.0);
+    CHECK(d1 == d2);
+    d1.setEdge(1, 0, numeric_limits<double>::quiet_NaN());
+    BasicGraph<double> d3 = d1;
+    CHECK(d1 != d3);
+
+    unordered_set<ariel::Graph> seen;
+    seen.insert(g1);
+    seen.insert(g2);
+    seen.insert(g3);
+    seen.insert(g4);
+    CHECK(seen.size() == 3);
+    CHECK(seen.count(g2copy) == 0);
+}
+
+TEST_CASE("Cached edge statistics")
+{
+    ariel::Graph g;
+    vector<vector<int>> graph = {
+        {0, 1, 0},
+        {1, 0, 1},
+        {0, 1, 0}};
+    g.loadGraph(graph);
+    CHECK(g.getNumEdges() == 4);
+    CHECK(g.getOutDegree(1) == 2);
+    CHECK(g.getInDegree(0) == 1);
+    CHECK(g.isSymmetric());
+
+    g.setEdge(0, 2, 3);
+    CHECK(g.getNumEdges() == 5);
+    CHECK(g.getOutDegree(0) == 2);
+    CHECK(g.getInDegree(2) == 2);
+    CHECK_FALSE(g.isSymmetric());
+    g.setEdge(2, 0, 3);
+    CHECK(g.isSymmetric());
+    g.setEdge(1, 0, 5);
+    CHECK_FALSE(g.isSymmetric());
+    CHECK(g.getNumEdges() == 6);
+    g.setEdge(1, 0, 0);
+    g.setEdge(0, 1, 0);
+    CHECK(g.isSymmetric());
+    CHECK(g.getNumEdges() == 4);
+    g.setEdge(1, 1, 7);
+    CHECK(g.getOutDegree(1) == 2);
+    CHECK(g.getInDegree(1) == 2);
+
+    // The incremental counts agree with a fresh count after bulk operators
+    ariel::Graph fresh;
+    fresh.loadGraph(g.getAdjacencyMatrix());
+    CHECK(fresh.getNumEdges() == g.getNumEdges());
+    g *= 2;
+    CHECK(g.getNumEdges() == 5);
+    ++g;
+    CHECK(g.getNumEdges() == 9);
+    CHECK(g.isSymmetric());
+    CHECK_THROWS_AS(g.getOutDegree(3), invalid_argument);
+
+    // The ordering operators compare edge counts of both graphs
+    ariel::Graph a(3), b(3);
+    a.setEdge(0, 1, 1);
+    b.setEdge(1, 2, 1);
+    b.setEdge(2, 0, 1);
+    CHECK(b > a);
+    CHECK_FALSE(a > b);
+    CHECK(a < b);
+
+    // Reloading, even with an empty matrix, drops the cached statistics and fingerprint
+    ariel::Graph reloaded;
+    reloaded.loadGraph({{0, 1}, {1, 0}});
+    CHECK(reloaded.getNumEdges() == 2);
+    reloaded.loadGraph({});
+    CHECK(reloaded.getNumEdges() == 0);
+    CHECK(reloaded == ariel::Graph());
+}
+
+TEST_CASE("Sub-matrix search")
+{
+    // A sparse 0/1 matrix has many windows that almost match, which the search must tell apart
+    const size_t n = 40, m = 6;
+    vector<vector<int>> big(n, vector<int>(n, 0));
+    unsigned state = 12345;
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (size_t j = 0; j < n; ++j)
+        {
+            state = state * 1103515245u + 12345u;
+            big[i][j] = (state >> 16) % 4 == 0 ? 1 : 0;
+        }
+    }
+    ariel::Graph g;
+    g.loadGraph(big);
+
+    auto naive = [&](const vector<vector<int>> &pattern)
+    {
+        for (size_t i = 0; i + pattern.size() <= n; ++i)
+        {
+            for (size_t j = 0; j + pattern.size() <= n; ++j)
+            {
+                bool found = true;
+                for (size_t a = 0; a < pattern.size() && found; ++a)
+                {
+                    for (size_t b = 0; b < pattern.size() && found; ++b)
+                    {
+                        found = big[i + a][j + b] == pattern[a][b];
+                    }
+                }
+                if (found)
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    };
+
+    for (size_t t = 0; t < 50; ++t)
+    {
+        size_t row = (t * 7) % (n - m + 1), column = (t * 13) % (n - m + 1);
+        vector<vector<int>> pattern(m, vector<int>(m));
+        for (size_t a = 0; a < m; ++a)
+        {
+            for (size_t b = 0; b < m; ++b)
+            {
+                pattern[a][b] = big[row + a][column + b];
+            }
+        }
+        if (t % 2 == 1)
+        {
+            pattern[t % m][(t / 2) % m] ^= 1; // usually no longer anywhere in the matrix
+        }
+        ariel::Graph p;
+        p.loadGraph(pattern);
+        CHECK(g.containsGraph(p) == naive(pattern));
+        if (t % 2 == 0)
+        {
+            CHECK(g.containsGraph(p));
+        }
+    }
+
+    ariel::Graph empty, whole = g;
+    CHECK(g.containsGraph(empty));
+    CHECK(g.containsGraph(whole));
+    whole.setEdge(n - 1, n - 1, 5);
+    CHECK_FALSE(g.containsGraph(whole));
+    CHECK_FALSE(ariel::Graph(3).containsGraph(g));
+
+    // Contained graphs order below the graphs containing them
+    ariel::Graph corner;
+    corner.loadGraph({{big[0][0], big[0][1]}, {big[1][0], big[1][1]}});
+    CHECK(corner < g);
+    CHECK(g > corner);
+}
+
+TEST_CASE("Subgraph isomorphism")
+{
+    // Every ordered triple of distinct vertices of K4 is a triangle
+    ariel::Graph k4, triangle, path;
+    k4.loadGraph({{0, 1, 1, 1}, {1, 0, 1, 1}, {1, 1, 0, 1}, {1, 1, 1, 0}});
+    triangle.loadGraph({{0, 1, 1}, {1, 0, 1}, {1, 1, 0}});
+    path.loadGraph({{0, 1, 0}, {1, 0, 1}, {0, 1, 0}});
+    CHECK(Isomorphism::subgraphMatches(triangle, k4).size() == 24);
+    CHECK(Isomorphism::subgraphMatches(path, k4).size() == 24);
+    SubgraphOptions induced;
+    induced.induced = true;
+    CHECK(Isomorphism::subgraphMatches(path, k4, induced).empty());
+    CHECK(Isomorphism::isSubgraph(triangle, k4));
+    CHECK_FALSE(Isomorphism::isSubgraph(k4, triangle));
+
+    // Directed edges keep their direction, weights only count when asked to
+    ariel::Graph cycle(5), arc;
+    for (size_t v = 0; v < 5; ++v)
+    {
+        cycle.setEdge(v, (v + 1) % 5, static_cast<int>(v + 1));
+    }
+    arc.loadGraph({{0, 2, 0}, {0, 0, 3}, {0, 0, 0}});
+    vector<Isomorphism::Embedding> arcs = Isomorphism::subgraphMatches(arc, cycle);
+    CHECK(arcs.size() == 5);
+    for (const Isomorphism::Embedding &e : arcs)
+    {
+        CHECK(cycle.getEdge(e[0], e[1]) != 0);
+        CHECK(cycle.getEdge(e[1], e[2]) != 0);
+    }
+    SubgraphOptions weighted;
+    weighted.matchWeights = true;
+    vector<Isomorphism::Embedding> exact = Isomorphism::subgraphMatches(arc, cycle, weighted);
+    REQUIRE(exact.size() == 1);
+    CHECK(exact[0] == Isomorphism::Embedding({1, 2, 3}));
+
+    // Labels restrict the candidates
+    SubgraphOptions labeled;
+    labeled.patternLabels = {7, 0, 0};
+    labeled.targetLabels = {0, 0, 7, 0};
+    CHECK(Isomorphism::subgraphMatches(triangle, k4, labeled).size() == 6);
+    labeled.targetLabels.pop_back();
+    CHECK_THROWS_AS(Isomorphism::subgraphMatches(triangle, k4, labeled), invalid_argument);
+
+    // A random graph against brute force, on one thread and several, with and without a limit
+    const size_t n = 8;
+    ariel::Graph target(static_cast<int>(n));
+    unsigned state = 99;
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (size_t j = 0; j < n; ++j)
+        {
+            state = state * 1103515245u + 12345u;
+            if (i != j && (state >> 16) % 3 == 0)
+            {
+                target.setEdge(i, j, 1);
+            }
+        }
+    }
+    ariel::Graph star;
+    star.loadGraph({{0, 1, 1}, {0, 0, 0}, {1, 0, 0}});
+    size_t expected = 0;
+    for (size_t a = 0; a < n; ++a)
+    {
+        for (size_t b = 0; b < n; ++b)
+        {
+            for (size_t c = 0; c < n; ++c)
+            {
+                if (a != b && b != c && a != c && target.getEdge(a, b) && target.getEdge(a, c) && target.getEdge(c, a))
+                {
+                    expected++;
+                }
+            }
+        }
+    }
+    vector<Isomorphism::Embedding> serial = Isomorphism::subgraphMatches(star, target);
+    CHECK(serial.size() == expected);
+    SubgraphOptions parallel;
+    parallel.threads = 4;
+    CHECK(Isomorphism::subgraphMatches(star, target, parallel) == serial);
+    parallel.limit = 3;
+    CHECK(Isomorphism::subgraphMatches(star, target, parallel).size() == min<size_t>(3, expected));
+    CHECK(Isomorphism::subgraphMatches(ariel::Graph(), target).size() == 1);
+}
+
+TEST_CASE("Canonical labeling")
+{
+    // Relabeled copies of a graph share one canonical form
+    const size_t n = 12;
+    ariel::Graph g(static_cast<int>(n));
+    unsigned state = 7;
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (size_t j = 0; j < n; ++j)
+        {
+            state = state * 1103515245u + 12345u;
+            if ((state >> 16) % 4 == 0)
+            {
+                g.setEdge(i, j, static_cast<int>((state >> 20) % 3) + 1);
+            }
+        }
+    }
+    auto shuffled = [](const ariel::Graph &graph, unsigned seed)
+    {
+        vector<size_t> order(graph.getNumVertices());
+        for (size_t v = 0; v < order.size(); ++v)
+        {
+            order[v] = v;
+        }
+        for (size_t v = order.size(); v > 1; --v)
+        {
+            seed = seed * 1103515245u + 12345u;
+            swap(order[v - 1], order[(seed >> 16) % v]);
+        }
+        return Reorder::permute(graph, Permutation(order));
+    };
+    ariel::Graph canonical = Isomorphism::canonicalForm(g);
+    for (unsigned seed = 1; seed <= 5; ++seed)
+    {
+        ariel::Graph copy = shuffled(g, seed);
+        CHECK(Isomorphism::canonicalForm(copy) == canonical);
+        CHECK(Isomorphism::canonicalHash(copy) == Isomorphism::canonicalHash(g));
+        CHECK(Isomorphism::isIsomorphic(copy, g));
+        CHECK(Reorder::permute(copy, Isomorphism::canonicalPermutation(copy)) == canonical);
+    }
+    ariel::Graph changed = g;
+    changed.setEdge(0, 0, changed.getEdge(0, 0) == 0 ? 1 : 0);
+    CHECK_FALSE(Isomorphism::isIsomorphic(changed, g));
+
+    // Highly symmetric graphs: empty, complete, a cycle and the Petersen graph
+    ariel::Graph empty(20), complete(9), cycle(16), petersen(10);
+    for (size_t i = 0; i < 9; ++i)
+    {
+        for (size_t j = 0; j < 9; ++j)
+        {
+            complete.setEdge(i, j, i == j ? 0 : 1);
+        }
+    }
+    for (size_t v = 0; v < 16; ++v)
+    {
+        cycle.setEdge(v, (v + 1) % 16, 1);
+        cycle.setEdge((v + 1) % 16, v, 1);
+    }
+    for (size_t v = 0; v < 5; ++v)
+    {
+        size_t pairs[3][2] = {{v, (v + 1) % 5}, {v, v + 5}, {v + 5, (v + 2) % 5 + 5}};
+        for (const size_t *edge : pairs)
+        {
+            petersen.setEdge(edge[0], edge[1], 1);
+            petersen.setEdge(edge[1], edge[0], 1);
+        }
+    }
+    for (const ariel::Graph *graph : {&empty, &complete, &cycle, &petersen})
+    {
+        CHECK(Isomorphism::canonicalForm(shuffled(*graph, 3)) == Isomorphism::canonicalForm(*graph));
+    }
+
+    // Two 8-cycles and one 16-cycle are both 2-regular, refinement alone cannot tell them apart
+    ariel::Graph twoCycles(16);
+    for (size_t v = 0; v < 16; ++v)
+    {
+        size_t next = v % 8 == 7 ? v - 7 : v + 1;
+        twoCycles.setEdge(v, next, 1);
+        twoCycles.setEdge(next, v, 1);
+    }
+    CHECK_FALSE(Isomorphism::isIsomorphic(twoCycles, cycle));
+    CHECK(Isomorphism::isIsomorphic(shuffled(twoCycles, 9), twoCycles));
+
+    unordered_set<uint64_t> classes;
+    for (unsigned seed = 1; seed <= 4; ++seed)
+    {
+        classes.insert(Isomorphism::canonicalHash(shuffled(cycle, seed)));
+        classes.insert(Isomorphism::canonicalHash(shuffled(twoCycles, seed)));
+    }
+    CHECK(classes.size() == 2);
+}
+
+TEST_CASE("Canonical labeling of disjoint regular components")
+{
+    // A triangle next to a 4-cycle: both 2-regular, so refinement alone cannot tell the components apart and the
+    // search has to compare leaves from different branches. Every relabeling must give the same canonical form.
+    ariel::Graph g(7);
+    const size_t edges[][2] = {{0, 1}, {1, 2}, {2, 0}, {3, 4}, {4, 5}, {5, 6}, {6, 3}};
+    for (const size_t *edge : edges)
+    {
+        g.setEdge(edge[0], edge[1], 1);
+        g.setEdge(edge[1], edge[0], 1);
+    }
+    ariel::Graph canonical = Isomorphism::canonicalForm(g);
+    vector<size_t> order = {0, 1, 2, 3, 4, 5, 6};
+    size_t mismatches = 0;
+    do
+    {
+        ariel::Graph copy = Reorder::permute(g, Permutation(order));
+        mismatches += Isomorphism::canonicalForm(copy) == canonical ? 0 : 1;
+    } while (next_permutation(order.begin(), order.end()));
+    CHECK(mismatches == 0);
+
+    // Random unions of cycles and cliques of different sizes, shuffled
+    unsigned seed = 17;
+    auto random = [&seed](size_t bound)
+    {
+        seed = seed * 1103515245u + 12345u;
+        return static_cast<size_t>((seed >> 16) % bound);
+    };
+    for (int trial = 0; trial < 200; ++trial)
+    {
+        vector<pair<size_t, size_t>> pairs;
+        size_t n = 0;
+        for (size_t parts = 2 + random(3); parts > 0; --parts)
+        {
+            size_t size = 3 + random(4);
+            bool clique = random(2) == 0;
+            for (size_t i = 0; i < size; ++i)
+            {
+                for (size_t j = i + 1; j < size; ++j)
+                {
+                    if (clique || j == i + 1 || (i == 0 && j == size - 1))
+                    {
+                        pairs.push_back(make_pair(n + i, n + j));
+                    }
+                }
+            }
+            n += size;
+        }
+        ariel::Graph h(static_cast<int>(n));
+        for (const pair<size_t, size_t> &edge : pairs)
+        {
+            h.setEdge(edge.first, edge.second, 1);
+            h.setEdge(edge.second, edge.first, 1);
+        }
+        vector<size_t> shuffle(n);
+        for (size_t v = 0; v < n; ++v)
+        {
+            shuffle[v] = v;
+        }
+        for (size_t v = n; v > 1; --v)
+        {
+            swap(shuffle[v - 1], shuffle[random(v)]);
+        }
+        ariel::Graph copy = Reorder::permute(h, Permutation(shuffle));
+        CHECK(Isomorphism::canonicalForm(copy) == Isomorphism::canonicalForm(h));
+        CHECK(Isomorphism::isIsomorphic(copy, h));
+    }
+}
+
+TEST_CASE("Strongly connected components")
+{
+    // Two cycles joined by a one-way edge, and a vertex on its own
+    ariel::Graph g(6);
+    g.setEdge(0, 1, 1);
+    g.setEdge(1, 2, 1);
+    g.setEdge(2, 0, 1);
+    g.setEdge(3, 4, 1);
+    g.setEdge(4, 3, 1);
+    g.setEdge(2, 3, 1);
+    g.setEdge(1, 4, 1);
+    g.setEdge(5, 0, 1);
+    vector<size_t> components = Algorithms::stronglyConnectedComponents(g);
+    CHECK(components[0] == components[1]);
+    CHECK(components[1] == components[2]);
+    CHECK(components[3] == components[4]);
+    CHECK(components[0] != components[3]);
+    CHECK(components[5] < components[0]);
+    CHECK(components[0] < components[3]);
+    CHECK_FALSE(Algorithms::isStronglyConnected(g));
+    ariel::Graph dag = Algorithms::condensation(g, components);
+    REQUIRE(dag.getNumVertices() == 3);
+    CHECK(dag.getEdge(components[0], components[3]) == 2);
+    CHECK(dag.getEdge(components[5], components[0]) == 1);
+    CHECK(dag.getNumEdges() == 2);
+    g.setEdge(3, 5, 1);
+    CHECK(Algorithms::isStronglyConnected(g));
+
+    // A long path would overflow a recursive Tarjan
+    const size_t length = 200000;
+    vector<size_t> pathOffsets(length + 1), pathTargets;
+    for (size_t v = 0; v < length; ++v)
+    {
+        pathOffsets[v + 1] = pathOffsets[v] + 1;
+        pathTargets.push_back((v + 1) % length);
+    }
+    CSRGraph ring(pathOffsets, pathTargets, vector<int>(length, 1));
+    vector<size_t> ringComponents = Algorithms::stronglyConnectedComponents(ring, 1);
+    CHECK(count(ringComponents.begin(), ringComponents.end(), 0) == static_cast<long>(length));
+
+    // The parallel decomposition finds the same components on a graph big enough to use it
+    const size_t n = 20000;
+    vector<vector<size_t>> lists(n);
+    unsigned state = 5;
+    for (size_t v = 0; v < n; ++v)
+    {
+        // The first half is a random digraph with a giant component, the second half only has forward edges
+        for (int k = 0; k < 3; ++k)
+        {
+            state = state * 1103515245u + 12345u;
+            size_t u = (state >> 8) % n;
+            if (k < 2 && v < n / 2)
+            {
+                lists[v].push_back(u % (n / 2));
+            }
+            else if (k == 2 && u > v)
+            {
+                lists[v].push_back(u);
+            }
+        }
+        sort(lists[v].begin(), lists[v].end());
+        lists[v].erase(unique(lists[v].begin(), lists[v].end()), lists[v].end());
+    }
+    vector<size_t> offsets(n + 1, 0), targets;
+    for (size_t v = 0; v < n; ++v)
+    {
+        targets.insert(targets.end(), lists[v].begin(), lists[v].end());
+        offsets[v + 1] = targets.size();
+    }
+    CSRGraph big(offsets, targets, vector<int>(targets.size(), 1));
+    vector<size_t> serial = Algorithms::stronglyConnectedComponents(big, 1);
+    vector<size_t> parallel = Algorithms::stronglyConnectedComponents(big, 4);
+    vector<size_t> serialOf(n, n), parallelOf(n, n);
+    bool samePartition = true, topological = true;
+    for (size_t v = 0; v < n; ++v)
+    {
+        // Both numberings must be bijections of each other
+        if (serialOf[serial[v]] == n)
+        {
+            serialOf[serial[v]] = parallel[v];
+        }
+        if (parallelOf[parallel[v]] == n)
+        {
+            parallelOf[parallel[v]] = serial[v];
+        }
+        samePartition = samePartition && serialOf[serial[v]] == parallel[v] && parallelOf[parallel[v]] == serial[v];
+        for (size_t u : lists[v])
+        {
+            topological = topological && serial[v] <= serial[u] && parallel[v] <= parallel[u];
+        }
+    }
+    CHECK(samePartition);
+    CHECK(topological);
+    vector<size_t> sizes(n, 0);
+    for (size_t c : serial)
+    {
+        sizes[c]++;
+    }
+    CHECK(*max_element(sizes.begin(), sizes.end()) > 4096);
+    CHECK(*max_element(serial.begin(), serial.end()) > n / 2);
+}
+
+TEST_CASE("Topological order and DAG paths")
+{
+    // 0 -> 1 -> 3, 0 -> 2 -> 3, 3 -> 4, and 5 on its own
+    ariel::Graph g(6);
+    g.setEdge(0, 1, 2);
+    g.setEdge(1, 3, 4);
+    g.setEdge(0, 2, 1);
+    g.setEdge(2, 3, -3);
+    g.setEdge(3, 4, 5);
+    vector<size_t> order = Algorithms::topologicalSort(g);
+    REQUIRE(order.size() == 6);
+    vector<size_t> position(6);
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        position[order[i]] = i;
+    }
+    CHECK(position[0] < position[1]);
+    CHECK(position[1] < position[3]);
+    CHECK(position[2] < position[3]);
+    CHECK(position[3] < position[4]);
+
+    vector<vector<size_t>> levels = Algorithms::topologicalLevels(CSRGraph(g), 4);
+    REQUIRE(levels.size() == 4);
+    CHECK(levels[0] == vector<size_t>({0, 5}));
+    CHECK(levels[1] == vector<size_t>({1, 2}));
+    CHECK(levels[2] == vector<size_t>({3}));
+    CHECK(levels[3] == vector<size_t>({4}));
+
+    vector<int> shortest = Algorithms::dagShortestPaths(g, 0);
+    CHECK(shortest == vector<int>({0, 2, 1, -2, 3, numeric_limits<int>::max()}));
+    vector<int> longest = Algorithms::dagLongestPaths(g, 0);
+    CHECK(longest == vector<int>({0, 2, 1, 6, 11, numeric_limits<int>::lowest()}));
+    CHECK(Algorithms::criticalPath(CSRGraph(g)) == vector<size_t>({0, 1, 3, 4}));
+    CHECK_THROWS_AS(Algorithms::dagShortestPaths(g, 6), invalid_argument);
+
+    // Shortest paths agree with Johnson's algorithm, which handles negative weights in general graphs
+    ariel::Graph distances = Algorithms::johnsonShortestPaths(g);
+    for (size_t v = 0; v < 6; ++v)
+    {
+        CHECK(distances.getEdge(0, v) == (v == 0 ? 0 : shortest[v]));
+    }
+
+    g.setEdge(4, 0, 1);
+    CHECK_THROWS_AS(Algorithms::topologicalSort(g), invalid_argument);
+    CHECK_THROWS_AS(Algorithms::topologicalLevels(CSRGraph(g)), invalid_argument);
+    CHECK_THROWS_AS(Algorithms::dagLongestPaths(g, 0), invalid_argument);
+
+    // A wide layered DAG exercises the parallel levels
+    const size_t width = 3000, depth = 4;
+    vector<size_t> offsets(width * depth + 1, 0), targets;
+    for (size_t v = 0; v < width * depth; ++v)
+    {
+        if (v + width < width * depth)
+        {
+            targets.push_back(v + width);
+            targets.push_back((v + 1) % width + (v / width + 1) * width);
+            sort(targets.end() - 2, targets.end());
+        }
+        offsets[v + 1] = targets.size();
+    }
+    CSRGraph layered(offsets, targets, vector<int>(targets.size(), 1));
+    vector<vector<size_t>> layers = Algorithms::topologicalLevels(layered, 4);
+    REQUIRE(layers.size() == depth);
+    for (size_t k = 0; k < depth; ++k)
+    {
+        CHECK(layers[k].size() == width);
+        CHECK(layers[k].front() == k * width);
+    }
+    CHECK(Algorithms::criticalPath(layered).size() == depth);
+}
+
+TEST_CASE("Minimum spanning forests")
+{
+    // A square 0-1-2-3 with a diagonal, given in one direction or both, and the separate edge 4-5
+    ariel::Graph g(7);
+    g.setEdge(0, 1, 1);
+    g.setEdge(1, 2, 2);
+    g.setEdge(2, 1, 5); // the lighter direction counts
+    g.setEdge(3, 2, 3);
+    g.setEdge(0, 3, 4);
+    g.setEdge(0, 2, 6);
+    g.setEdge(5, 4, -2);
+    SpanningForest<int> prim = Algorithms::primSpanningForest(g);
+    SpanningForest<int> kruskal = Algorithms::kruskalSpanningForest(g);
+    SpanningForest<int> boruvka = Algorithms::boruvkaSpanningForest(g, 4);
+    CHECK(prim.weight == 4);
+    CHECK(kruskal.weight == 4);
+    CHECK(boruvka.weight == 4);
+    CHECK(prim.forest == kruskal.forest);
+    CHECK(prim.forest == boruvka.forest);
+    CHECK(prim.forest.isSymmetric());
+    CHECK(prim.forest.getNumEdges() == 2 * 4);
+    CHECK(prim.forest.getEdge(2, 1) == 2);
+    CHECK(prim.forest.getEdge(4, 5) == -2);
+    CHECK(prim.forest.getEdge(0, 3) == 0);
+
+    // A larger random graph with repeated weights: the same total weight, n minus the number of components edges
+    // and the same connected components as the graph itself
+    const size_t n = 300;
+    ariel::BasicGraph<double> random(static_cast<int>(n));
+    unsigned seed = 7;
+    for (size_t u = 0; u < n; ++u)
+    {
+        for (size_t v = 0; v < n; ++v)
+        {
+            seed = seed * 1103515245u + 12345u;
+            if (u != v && (seed >> 16) % 40 == 0)
+            {
+                random.setEdge(u, v, 0.5 * ((seed >> 8) % 20) - 3);
+            }
+        }
+    }
+    for (size_t v = n - 10; v < n; ++v)
+    {
+        for (size_t u = 0; u < n; ++u)
+        {
+            random.setEdge(u, v, 0);
+            random.setEdge(v, u, 0);
+        }
+    }
+    random.setEdge(n - 1, n - 2, 1);
+    SpanningForest<double> a = Algorithms::primSpanningForest(random);
+    SpanningForest<double> b = Algorithms::kruskalSpanningForest(random);
+    SpanningForest<double> c = Algorithms::boruvkaSpanningForest(random, 3);
+    CHECK(a.weight == doctest::Approx(b.weight));
+    CHECK(a.weight == doctest::Approx(c.weight));
+
+    ariel::BasicGraph<double> symmetric = random;
+    for (size_t u = 0; u < n; ++u)
+    {
+        for (size_t v = 0; v < n; ++v)
+        {
+            if (random.getEdge(u, v) != 0)
+            {
+                symmetric.setEdge(v, u, random.getEdge(u, v));
+            }
+        }
+    }
+    vector<size_t> components = Algorithms::stronglyConnectedComponents(symmetric);
+    size_t numComponents = *max_element(components.begin(), components.end()) + 1;
+    CHECK(numComponents >= 9); // the giant component, 8 isolated vertices and the pair
+    for (const SpanningForest<double> *forest : {&a, &b, &c})
+    {
+        CHECK(forest->forest.getNumEdges() == 2 * (n - numComponents));
+        CHECK(Algorithms::stronglyConnectedComponents(forest->forest) == components);
+    }
+
+    ariel::BasicGraph<uint8_t> heavy(3);
+    heavy.setEdge(0, 1, 200);
+    heavy.setEdge(1, 2, 100);
+    CHECK_THROWS_AS(Algorithms::kruskalSpanningForest(heavy), overflow_error);
+}
+
+TEST_CASE("Maximum flow and minimum cut")
+{
+    // Checks that a flow respects the capacities and conservation, and that its value equals the capacity of its
+    // cut, which proves both of them optimal
+    auto checkFlow = [](const CSRGraph &network, size_t source, size_t sink, const MaximumFlow<int> &flow)
+    {
+        size_t n = network.getNumVertices();
+        vector<long long> balance(n, 0);
+        long long cut = 0;
+        for (size_t u = 0; u < n; ++u)
+        {
+            for (size_t e = network.getOffsets()[u]; e < network.getOffsets()[u + 1]; ++e)
+            {
+                size_t v = network.getTargets()[e];
+                CHECK(flow.edgeFlow[e] >= 0);
+                CHECK(flow.edgeFlow[e] <= network.getWeights()[e]);
+                balance[u] -= flow.edgeFlow[e];
+                balance[v] += flow.edgeFlow[e];
+                if (flow.sourceSide[u] && !flow.sourceSide[v])
+                {
+                    cut += network.getWeights()[e];
+                }
+            }
+        }
+        for (size_t v = 0; v < n; ++v)
+        {
+            if (v != source && v != sink)
+            {
+                CHECK(balance[v] == 0);
+            }
+        }
+        CHECK(balance[sink] == flow.value);
+        CHECK(cut == flow.value);
+        CHECK(flow.sourceSide[source]);
+        CHECK(!flow.sourceSide[sink]);
+    };
+
+    // The classic six vertex network with a maximum flow of 23
+    ariel::Graph g(6);
+    g.setEdge(0, 1, 16);
+    g.setEdge(0, 2, 13);
+    g.setEdge(1, 2, 10);
+    g.setEdge(2, 1, 4);
+    g.setEdge(1, 3, 12);
+    g.setEdge(3, 2, 9);
+    g.setEdge(2, 4, 14);
+    g.setEdge(4, 3, 7);
+    g.setEdge(3, 5, 20);
+    g.setEdge(4, 5, 4);
+    MaximumFlow<int> pushed = Algorithms::maxFlowPushRelabel(g, 0, 5);
+    MaximumFlow<int> blocked = Algorithms::maxFlowDinic(g, 0, 5);
+    CHECK(pushed.value == 23);
+    CHECK(blocked.value == 23);
+    checkFlow(CSRGraph(g), 0, 5, pushed);
+    checkFlow(CSRGraph(g), 0, 5, blocked);
+    CHECK(pushed.sourceSide == vector<bool>({true, true, true, false, true, false}));
+    CHECK(Algorithms::maxFlowDinic(g, 5, 0).value == 0);
+
+    // Random networks of growing size agree, including parallel edges and self-loops
+    unsigned seed = 11;
+    auto random = [&seed](unsigned bound)
+    {
+        seed = seed * 1103515245u + 12345u;
+        return (seed >> 16) % bound;
+    };
+    for (size_t n : {10, 60, 400})
+    {
+        vector<size_t> offsets(n + 1, 0), targets;
+        vector<int> capacities;
+        for (size_t u = 0; u < n; ++u)
+        {
+            size_t degree = random(8);
+            vector<size_t> out;
+            for (size_t k = 0; k < degree; ++k)
+            {
+                out.push_back(random(static_cast<unsigned>(n)));
+            }
+            sort(out.begin(), out.end());
+            for (size_t v : out)
+            {
+                targets.push_back(v);
+                capacities.push_back(static_cast<int>(random(50)));
+            }
+            offsets[u + 1] = targets.size();
+        }
+        CSRGraph network(offsets, targets, capacities);
+        MaximumFlow<int> a = Algorithms::maxFlowPushRelabel(network, 0, n - 1);
+        MaximumFlow<int> b = Algorithms::maxFlowDinic(network, 0, n - 1);
+        CHECK(a.value == b.value);
+        checkFlow(network, 0, n - 1, a);
+        checkFlow(network, 0, n - 1, b);
+    }
+
+    ariel::BasicGraph<double> fractional(3);
+    fractional.setEdge(0, 1, 1.5);
+    fractional.setEdge(1, 2, 0.25);
+    fractional.setEdge(0, 2, 0.5);
+    CHECK(Algorithms::maxFlowPushRelabel(fractional, 0, 2).value == doctest::Approx(0.75));
+    CHECK(Algorithms::maxFlowDinic(fractional, 0, 2).value == doctest::Approx(0.75));
+
+    ariel::BasicGraph<uint8_t> wide(3);
+    wide.setEdge(0, 1, 200);
+    wide.setEdge(0, 2, 200);
+    wide.setEdge(1, 2, 200);
+    CHECK_THROWS_AS(Algorithms::maxFlowPushRelabel(wide, 0, 2), overflow_error);
+    CHECK_THROWS_AS(Algorithms::maxFlowDinic(g, 0, 0), invalid_argument);
+    CHECK_THROWS_AS(Algorithms::maxFlowDinic(g, 0, 6), invalid_argument);
+    g.setEdge(1, 3, -1);
+    CHECK_THROWS_AS(Algorithms::maxFlowPushRelabel(g, 0, 5), invalid_argument);
+}
+
+TEST_CASE("Bipartite maximum matching")
+{
+    // A path 0 - 1 - 2 - 3 - 4 - 5 matches perfectly, though the greedy start takes 1 - 2 first
+    ariel::Graph path(6);
+    for (size_t v = 0; v + 1 < 6; ++v)
+    {
+        path.setEdge(v + 1, v, 1); // one direction is enough
+    }
+    vector<size_t> partA, partB;
+    CHECK(Algorithms::bipartition(path, partA, partB));
+    CHECK(partA == vector<size_t>({0, 2, 4}));
+    CHECK(partB == vector<size_t>({1, 3, 5}));
+    vector<pair<size_t, size_t>> expected = {{0, 1}, {2, 3}, {4, 5}};
+    CHECK(Algorithms::maximumMatching(path) == expected);
+    CHECK(Algorithms::maximumMatchingPushRelabel(CSRGraph(path), 2) == expected);
+
+    path.setEdge(0, 2, 1);
+    CHECK(!Algorithms::bipartition(path, partA, partB));
+    CHECK(partA.empty());
+    CHECK(Algorithms::isBipartite(path) == "0");
+    CHECK_THROWS_AS(Algorithms::maximumMatching(path), invalid_argument);
+
+    // Random bipartite graphs, large enough for parallel push-relabel rounds, against a unit capacity max flow
+    unsigned seed = 5;
+    auto random = [&seed](size_t bound)
+    {
+        seed = seed * 1103515245u + 12345u;
+        return static_cast<size_t>((seed >> 8) % bound);
+    };
+    for (size_t half : {50, 6000})
+    {
+        // Vertices below half are one side, the rest the other; the flow network adds a source and a sink
+        size_t n = 2 * half;
+        vector<vector<size_t>> out(n + 2);
+        for (size_t a = 0; a < half; ++a)
+        {
+            size_t degree = random(4);
+            for (size_t k = 0; k < degree; ++k)
+            {
+                out[a].push_back(half + random(half));
+            }
+            sort(out[a].begin(), out[a].end());
+            out[a].erase(unique(out[a].begin(), out[a].end()), out[a].end());
+        }
+        vector<size_t> offsets(1, 0), targets;
+        for (size_t v = 0; v < n + 2; ++v)
+        {
+            if (v < n)
+            {
+                targets.insert(targets.end(), out[v].begin(), out[v].end());
+            }
+            offsets.push_back(targets.size());
+        }
+        CSRGraph bipartite(vector<size_t>(offsets.begin(), offsets.begin() + n + 1),
+                           vector<size_t>(targets.begin(), targets.end()), vector<int>(targets.size(), 1));
+        for (size_t a = 0; a < half; ++a)
+        {
+            out[n].push_back(a);
+            out[half + a].push_back(n + 1);
+        }
+        offsets.assign(1, 0);
+        targets.clear();
+        for (size_t v = 0; v < n + 2; ++v)
+        {
+            targets.insert(targets.end(), out[v].begin(), out[v].end());
+            offsets.push_back(targets.size());
+        }
+        CSRGraph network(offsets, targets, vector<int>(targets.size(), 1));
+        int best = Algorithms::maxFlowDinic(network, n, n + 1).value;
+
+        vector<pair<size_t, size_t>> hk = Algorithms::maximumMatching(bipartite);
+        vector<pair<size_t, size_t>> pr = Algorithms::maximumMatchingPushRelabel(bipartite, 4);
+        CHECK(hk.size() == static_cast<size_t>(best));
+        CHECK(pr.size() == static_cast<size_t>(best));
+        for (const vector<pair<size_t, size_t>> *matching : {&hk, &pr})
+        {
+            vector<bool> used(n, false);
+            for (const pair<size_t, size_t> &match : *matching)
+            {
+                size_t a = min(match.first, match.second), b = max(match.first, match.second);
+                CHECK(binary_search(out[a].begin(), out[a].end(), b));
+                CHECK(!used[a]);
+                CHECK(!used[b]);
+                used[a] = used[b] = true;
+            }
+        }
+    }
+}
+
+TEST_CASE("PageRank")
+{
+    // Power iteration on the dense matrix, restarting at seed if it is a vertex and uniformly otherwise
+    auto reference = [](const ariel::Graph &g, double damping, size_t seed)
+    {
+        size_t n = g.getNumVertices();
+        vector<double> rank(n, 1.0 / n);
+        for (int iteration = 0; iteration < 500; ++iteration)
+        {
+            vector<double> next(n, 0.0);
+            double restart = 1 - damping;
+            for (size_t u = 0; u < n; ++u)
+            {
+                size_t degree = g.getOutDegree(u);
+                if (degree == 0)
+                {
+                    restart += damping * rank[u];
+                    continue;
+                }
+                for (size_t v = 0; v < n; ++v)
+                {
+                    if (g.getEdge(u, v) != 0)
+                    {
+                        next[v] += damping * rank[u] / degree;
+                    }
+                }
+            }
+            for (size_t v = 0; v < n; ++v)
+            {
+                next[v] += seed < n ? (v == seed ? restart : 0.0) : restart / n;
+            }
+            rank = next;
+        }
+        return rank;
+    };
+
+    // A small web with a dangling vertex 4 and negative and heavy weights, which do not matter
+    ariel::Graph g(5);
+    g.setEdge(0, 1, 1);
+    g.setEdge(0, 2, -7);
+    g.setEdge(1, 2, 1);
+    g.setEdge(2, 0, 100);
+    g.setEdge(3, 2, 1);
+    g.setEdge(3, 4, 1);
+    PageRankOptions options;
+    options.tolerance = 1e-12;
+    options.maxIterations = 1000;
+    vector<double> exact = reference(g, 0.85, 5);
+    vector<double> ranks = Algorithms::pageRank<double>(g, options);
+    vector<float> narrow = Algorithms::pageRank<float>(CSRGraph(g), options);
+    REQUIRE(ranks.size() == 5);
+    double total = 0;
+    for (size_t v = 0; v < 5; ++v)
+    {
+        CHECK(ranks[v] == doctest::Approx(exact[v]).epsilon(1e-9));
+        CHECK(narrow[v] == doctest::Approx(exact[v]).epsilon(1e-4));
+        total += ranks[v];
+    }
+    CHECK(total == doctest::Approx(1.0));
+    CHECK(ranks[2] > ranks[0]);
+    CHECK(ranks[0] > ranks[1]);
+
+    // Personalized ranks match the restarting power iteration up to the pushed tolerance
+    options.tolerance = 1e-10;
+    vector<pair<size_t, double>> local = Algorithms::personalizedPageRank<double>(CSRGraph(g), 3, options);
+    vector<double> exactLocal = reference(g, 0.85, 3);
+    REQUIRE(local.size() == 5);
+    for (size_t i = 0; i < local.size(); ++i)
+    {
+        CHECK(local[i].second == doctest::Approx(exactLocal[local[i].first]).epsilon(1e-6));
+        if (i > 0)
+        {
+            CHECK(local[i - 1].second >= local[i].second);
+        }
+    }
+    CHECK_THROWS_AS(Algorithms::personalizedPageRank<double>(CSRGraph(g), 5), invalid_argument);
+    options.damping = 1;
+    CHECK_THROWS_AS(Algorithms::pageRank<double>(g, options), invalid_argument);
+
+    // A long cycle: the global ranks are uniform on any number of threads, the push only reaches a few vertices
+    const size_t n = 20000;
+    vector<size_t> offsets(n + 1), targets(n);
+    for (size_t v = 0; v < n; ++v)
+    {
+        offsets[v + 1] = v + 1;
+        targets[v] = (v + 1) % n;
+    }
+    CSRGraph cycle(offsets, targets, vector<int>(n, 1));
+    PageRankOptions parallel;
+    parallel.threads = 4;
+    vector<float> uniform = Algorithms::pageRank<float>(cycle, parallel);
+    for (size_t v = 0; v < n; v += 997)
+    {
+        CHECK(uniform[v] == doctest::Approx(1.0 / n).epsilon(1e-4));
+    }
+    PageRankOptions nearby;
+    nearby.damping = 0.5;
+    nearby.tolerance = 1e-4;
+    vector<pair<size_t, float>> reached = Algorithms::personalizedPageRank<float>(cycle, 100, nearby);
+    CHECK(reached.size() < 20);
+    CHECK(reached[0].first == 100);
+    CHECK(reached[1].first == 101);
+    CHECK(reached[0].second == doctest::Approx(0.5).epsilon(1e-3));
+}
+
+TEST_CASE("Triangle counting and clustering coefficients")
+{
+    // K4 with one extra vertex hanging off vertex 0, edges in one direction, both or with a self-loop
+    ariel::Graph g(5);
+    for (size_t u = 0; u < 4; ++u)
+    {
+        for (size_t v = u + 1; v < 4; ++v)
+        {
+            g.setEdge(u, v, 1);
+        }
+    }
+    g.setEdge(2, 1, 3);
+    g.setEdge(3, 3, 1);
+    g.setEdge(4, 0, 1);
+    CHECK(Algorithms::countTriangles(g) == 4);
+    vector<double> coefficients = Algorithms::clusteringCoefficients(g);
+    CHECK(coefficients[0] == doctest::Approx(0.5));
+    CHECK(coefficients[1] == doctest::Approx(1.0));
+    CHECK(coefficients[3] == doctest::Approx(1.0));
+    CHECK(coefficients[4] == 0.0);
+
+    // Random graphs against brute force: a dense one, whose long lists take the bitset path, and a sparse one
+    // with a hub, large enough to spread over threads
+    unsigned seed = 3;
+    auto random = [&seed](size_t bound)
+    {
+        seed = seed * 1103515245u + 12345u;
+        return static_cast<size_t>((seed >> 8) % bound);
+    };
+    const size_t sizes[][2] = {{300, 3}, {2000, 400}};
+    for (const size_t *size : sizes)
+    {
+        size_t n = size[0];
+        vector<vector<bool>> adjacent(n, vector<bool>(n, false));
+        vector<size_t> offsets(1, 0), targets;
+        for (size_t u = 0; u < n; ++u)
+        {
+            for (size_t v = 0; v < n; ++v)
+            {
+                if (u != v && (random(size[1]) == 0 || (u == 0 && v % 3 == 0)))
+                {
+                    targets.push_back(v);
+                    adjacent[u][v] = adjacent[v][u] = true;
+                }
+            }
+            offsets.push_back(targets.size());
+        }
+        CSRGraph graph(offsets, targets, vector<int>(targets.size(), 1));
+        uint64_t expected = 0;
+        vector<uint64_t> perVertex(n, 0);
+        for (size_t u = 0; u < n; ++u)
+        {
+            for (size_t v = u + 1; v < n; ++v)
+            {
+                if (!adjacent[u][v])
+                {
+                    continue;
+                }
+                for (size_t w = v + 1; w < n; ++w)
+                {
+                    if (adjacent[u][w] && adjacent[v][w])
+                    {
+                        expected++;
+                        perVertex[u]++;
+                        perVertex[v]++;
+                        perVertex[w]++;
+                    }
+                }
+            }
+        }
+        CHECK(expected > 0);
+        CHECK(Algorithms::countTriangles(graph, 1) == expected);
+        CHECK(Algorithms::countTriangles(graph, 4) == expected);
+        vector<double> local = Algorithms::clusteringCoefficients(graph, 4);
+        for (size_t v = 0; v < n; ++v)
+        {
+            double degree = 0;
+            for (size_t w = 0; w < n; ++w)
+            {
+                degree += adjacent[v][w];
+            }
+            double exact = degree < 2 ? 0.0 : 2.0 * perVertex[v] / (degree * (degree - 1));
+            CHECK(local[v] == doctest::Approx(exact));
+        }
+    }
+}